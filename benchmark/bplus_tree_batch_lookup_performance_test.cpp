@@ -0,0 +1,143 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较批量查找 BplusTreeHandler::get_entries 与逐个调用 get_entry 查找同样一批键值的性能
+ * @details 第一个参数是一批键值的个数，第二个参数是这批键值的分布范围占全部数据的比例(百分比)，
+ * 范围越小键值越密集，相邻的键值越可能落在同一个叶子节点中。每批键值都已经排好序
+ */
+class BatchLookupBenchmark : public Fixture
+{
+public:
+  static constexpr int KEY_NUM   = 200000;
+  static constexpr int BATCH_NUM = 64;
+
+  void SetUp(const State &state) override
+  {
+    batch_size_         = static_cast<int>(state.range(0));
+    const int key_range = max(batch_size_, static_cast<int>(KEY_NUM * state.range(1) / 100));
+
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+    LoggerFactory::init_default("bplus_tree_batch_lookup.log", LOG_LEVEL_WARN);
+
+    const char *btree_filename = "bplus_tree_batch_lookup.btree";
+    ::remove(btree_filename);
+
+    const AttrType attr_type   = AttrType::INTS;
+    const int      attr_length = sizeof(int);
+    RC rc = handler_.create(log_handler_, bpm_, btree_filename, span<const AttrType>(&attr_type, 1),
+        span<const int>(&attr_length, 1));
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create btree handler");
+    }
+
+    BplusTreeBulkBuilder builder(handler_);
+    for (int i = 0; i < KEY_NUM; i++) {
+      rc = builder.append(reinterpret_cast<const char *>(&i), RID(i + 1, 0));
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to append entry into btree");
+      }
+    }
+    rc = builder.finish();
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to build btree");
+    }
+
+    // 提前生成好要查找的键值，避免测试时间都花在生成随机数和排序上
+    IntegerGenerator generator(0, KEY_NUM - key_range);
+    IntegerGenerator offset_generator(0, key_range - 1);
+    batches_.resize(BATCH_NUM);
+    for (vector<int> &batch : batches_) {
+      const int start = generator.next();
+      for (int i = 0; i < batch_size_; i++) {
+        batch.push_back(start + offset_generator.next());
+      }
+      sort(batch.begin(), batch.end());
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    batches_.clear();
+    handler_.close();
+  }
+
+  void set_counters(State &state, int64_t found_count)
+  {
+    state.counters["lookups"] = Counter(state.iterations() * batch_size_, Counter::kIsRate);
+    state.counters["found"]   = Counter(found_count, Counter::kIsRate);
+  }
+
+protected:
+  int                 batch_size_ = 0;
+  vector<vector<int>> batches_;
+  BufferPoolManager   bpm_;
+  VacuousLogHandler   log_handler_;
+  BplusTreeHandler    handler_;
+};
+
+BENCHMARK_DEFINE_F(BatchLookupBenchmark, Independent)(State &state)
+{
+  int64_t batch_count = 0;
+  int64_t found_count = 0;
+  for (auto _ : state) {
+    const vector<int> &batch = batches_[batch_count++ % BATCH_NUM];
+    for (const int &key : batch) {
+      list<RID> rids;
+      handler_.get_entry(reinterpret_cast<const char *>(&key), sizeof(key), rids);
+      found_count += rids.size();
+    }
+  }
+  set_counters(state, found_count);
+}
+
+BENCHMARK_DEFINE_F(BatchLookupBenchmark, Batched)(State &state)
+{
+  int64_t              batch_count = 0;
+  int64_t              found_count = 0;
+  vector<const char *> user_keys;
+  vector<vector<RID>>  rids;
+  for (auto _ : state) {
+    const vector<int> &batch = batches_[batch_count++ % BATCH_NUM];
+    user_keys.clear();
+    for (const int &key : batch) {
+      user_keys.push_back(reinterpret_cast<const char *>(&key));
+    }
+    handler_.get_entries(user_keys, rids);
+    for (const vector<RID> &key_rids : rids) {
+      found_count += key_rids.size();
+    }
+  }
+  set_counters(state, found_count);
+}
+
+BENCHMARK_REGISTER_F(BatchLookupBenchmark, Independent)
+    ->ArgNames({"batch", "range%"})
+    ->ArgsProduct({{16, 256, 4096}, {1, 10, 100}});
+BENCHMARK_REGISTER_F(BatchLookupBenchmark, Batched)
+    ->ArgNames({"batch", "range%"})
+    ->ArgsProduct({{16, 256, 4096}, {1, 10, 100}});
+
+BENCHMARK_MAIN();
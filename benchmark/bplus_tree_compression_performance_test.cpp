@@ -0,0 +1,115 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较节点中的键值压缩与不压缩时，长字符串键值的B+树层数、页面数和点查询的耗时
+ * @details 第一个参数表示是否压缩，第二个参数是数据量。键值是 char(64)，前面部分都相同
+ */
+class CompressionBenchmark : public Fixture
+{
+public:
+  static constexpr int KEY_LENGTH = 64;
+
+  void SetUp(const State &state) override
+  {
+    const bool key_compression = state.range(0) != 0;
+    key_num_                   = static_cast<int>(state.range(1));
+
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+
+    string name = string("bplus_tree_compression_") + (key_compression ? "on" : "off");
+    LoggerFactory::init_default((name + ".log").c_str(), LOG_LEVEL_WARN);
+
+    string btree_filename = name + ".btree";
+    ::remove(btree_filename.c_str());
+
+    const AttrType attr_type = AttrType::CHARS;
+    RC rc = handler_.create(log_handler_, bpm_, btree_filename.c_str(), span<const AttrType>(&attr_type, 1),
+        span<const int>(&KEY_LENGTH, 1), -1 /*internal_max_size*/, -1 /*leaf_max_size*/, key_compression);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create btree handler");
+    }
+
+    // 随机顺序插入，节点的填充率与实际使用时接近
+    vector<int> values(key_num_);
+    for (int i = 0; i < key_num_; i++) {
+      values[i] = i;
+    }
+    IntegerGenerator generator(0, key_num_ - 1);
+    for (int i = key_num_ - 1; i > 0; i--) {
+      swap(values[i], values[generator.next() % (i + 1)]);
+    }
+
+    char key[KEY_LENGTH];
+    for (int value : values) {
+      make_key(value, key);
+      RID rid(value, value);
+      rc = handler_.insert_entry(key, &rid);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to insert entry into btree");
+      }
+    }
+  }
+
+  void TearDown(const State &state) override { handler_.close(); }
+
+  static void make_key(int value, char *key)
+  {
+    memset(key, 0, KEY_LENGTH);
+    snprintf(key, KEY_LENGTH, "customer-email-address-%010d@example.com", value);
+  }
+
+protected:
+  int               key_num_ = 0;
+  BufferPoolManager bpm_;
+  VacuousLogHandler log_handler_;
+  BplusTreeHandler  handler_;
+};
+
+BENCHMARK_DEFINE_F(CompressionBenchmark, PointLookup)(State &state)
+{
+  IntegerGenerator generator(0, key_num_ - 1);
+  char             key[KEY_LENGTH];
+  int64_t          found_count = 0;
+  for (auto _ : state) {
+    make_key(generator.next(), key);
+    list<RID> rids;
+    handler_.get_entry(key, static_cast<int>(strlen(key)), rids);
+    found_count += rids.size();
+  }
+
+  BplusTreeStat stat;
+  handler_.get_stat(stat);
+  state.counters["height"]         = Counter(stat.height);
+  state.counters["leaf_pages"]     = Counter(stat.leaf_pages);
+  state.counters["internal_pages"] = Counter(stat.internal_pages);
+  state.counters["found"]          = Counter(found_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(CompressionBenchmark, PointLookup)
+    ->ArgNames({"compression", "keys"})
+    ->Args({0, 200000})
+    ->Args({1, 200000});
+
+BENCHMARK_MAIN();
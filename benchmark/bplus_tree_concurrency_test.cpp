@@ -208,7 +208,8 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]     = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+// 线程数从1到16成倍增加，使用实际时间统计，可以看出吞吐量随线程数的变化
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, 16)->UseRealTime();
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -247,7 +248,7 @@ BENCHMARK_DEFINE_F(DeletionBenchmark, Deletion)(State &state)
   state.counters["other"]     = Counter(stat.delete_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->ThreadRange(1, 16)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -290,7 +291,7 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   state.counters["other"]                 = Counter(stat.scan_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->ThreadRange(1, 16)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -344,7 +345,7 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
       {"scan_open_failed", Counter(stat.scan_open_failed_count, Counter::kIsRate)}});
 }
 
-BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->ThreadRange(1, 16)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
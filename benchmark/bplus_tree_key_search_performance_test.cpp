@@ -0,0 +1,145 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/lower_bound.h"
+#include "common/math/integer_generator.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较节点内使用 KeyComparator 二分查找、按类型特化的比较器二分查找与数值类型键值专门的查找方法的性能
+ * @details 第一个参数是键值类型(0: INTS, 1: FLOATS)，第二个参数是节点中的元素个数，
+ * 第三个参数表示叶子节点中键值和值是否分开存放(参考 LeafIndexNode)。
+ * 不分开时元素的格式与叶子节点一样: 数值 + RID + RID，分开时查找只访问连续存放的键值: 数值 + RID。数值各不相同。
+ */
+class KeySearchBenchmark : public Fixture
+{
+public:
+  static constexpr int KEY_SIZE       = 4 + sizeof(RID);
+  static constexpr int ITEM_SIZE      = KEY_SIZE + sizeof(RID);
+  static constexpr int SEARCH_KEY_NUM = 4096;
+
+  void SetUp(const State &state) override
+  {
+    attr_type_ = state.range(0) == 0 ? AttrType::INTS : AttrType::FLOATS;
+    item_num_  = static_cast<int>(state.range(1));
+    stride_    = state.range(2) == 0 ? ITEM_SIZE : KEY_SIZE;
+    comparator_.init(attr_type_, 4);
+
+    items_.resize(item_num_ * stride_);
+    for (int i = 0; i < item_num_; i++) {
+      RID rid(i, i);
+      make_key(i * 2, rid, items_.data() + i * stride_);
+    }
+
+    // 提前生成要查找的键值，一半存在一半不存在，避免测试时间都花在生成随机数上
+    IntegerGenerator generator(0, item_num_ * 2);
+    search_keys_.resize(SEARCH_KEY_NUM * KEY_SIZE);
+    for (int i = 0; i < SEARCH_KEY_NUM; i++) {
+      const int value = generator.next();
+      RID       rid(value / 2, value / 2);
+      make_key(value, rid, search_keys_.data() + i * KEY_SIZE);
+    }
+  }
+
+  const char *search_key(int64_t i) const { return search_keys_.data() + (i % SEARCH_KEY_NUM) * KEY_SIZE; }
+
+  void make_key(int value, const RID &rid, char *key) const
+  {
+    if (attr_type_ == AttrType::INTS) {
+      memcpy(key, &value, sizeof(value));
+    } else {
+      float float_value = static_cast<float>(value);
+      memcpy(key, &float_value, sizeof(float_value));
+    }
+    memcpy(key + 4, &rid, sizeof(rid));
+  }
+
+protected:
+  AttrType      attr_type_ = AttrType::INTS;
+  int           item_num_  = 0;
+  int           stride_    = ITEM_SIZE;
+  KeyComparator comparator_;
+  vector<char>  items_;
+  vector<char>  search_keys_;
+};
+
+BENCHMARK_DEFINE_F(KeySearchBenchmark, Generic)(State &state)
+{
+  int64_t search_count = 0;
+  int64_t found_count  = 0;
+
+  BinaryIterator<char> iter_begin(stride_, items_.data());
+  BinaryIterator<char> iter_end(stride_, items_.data() + item_num_ * stride_);
+  for (auto _ : state) {
+    const char *key   = search_key(search_count++);
+    bool        found = false;
+    auto        iter  = lower_bound(iter_begin, iter_end, key, comparator_, &found);
+    DoNotOptimize(iter);
+    found_count += found ? 1 : 0;
+  }
+  state.counters["lookups"] = Counter(state.iterations(), Counter::kIsRate);
+  state.counters["found"]   = Counter(found_count, Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(KeySearchBenchmark, Typed)(State &state)
+{
+  int64_t search_count = 0;
+  int64_t found_count  = 0;
+
+  BinaryIterator<char> iter_begin(stride_, items_.data());
+  BinaryIterator<char> iter_end(stride_, items_.data() + item_num_ * stride_);
+  comparator_.visit([&](const auto &typed_comparator) {
+    for (auto _ : state) {
+      const char *key   = search_key(search_count++);
+      bool        found = false;
+      auto        iter  = lower_bound(iter_begin, iter_end, key, typed_comparator, &found);
+      DoNotOptimize(iter);
+      found_count += found ? 1 : 0;
+    }
+  });
+  state.counters["lookups"] = Counter(state.iterations(), Counter::kIsRate);
+  state.counters["found"]   = Counter(found_count, Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(KeySearchBenchmark, Numeric)(State &state)
+{
+  int64_t search_count = 0;
+  int64_t found_count  = 0;
+
+  for (auto _ : state) {
+    const char *key   = search_key(search_count++);
+    bool        found = false;
+    const int   index =
+        numeric_key_lower_bound(comparator_.search_method(), items_.data(), stride_, item_num_, key, &found);
+    DoNotOptimize(index);
+    found_count += found ? 1 : 0;
+  }
+  state.counters["lookups"] = Counter(state.iterations(), Counter::kIsRate);
+  state.counters["found"]   = Counter(found_count, Counter::kIsRate);
+}
+
+// 8K的页面，叶子节点大约可以放400个元素
+BENCHMARK_REGISTER_F(KeySearchBenchmark, Generic)
+    ->ArgNames({"float", "items", "separated"})
+    ->ArgsProduct({{0, 1}, {16, 128, 400}, {0, 1}});
+BENCHMARK_REGISTER_F(KeySearchBenchmark, Typed)
+    ->ArgNames({"float", "items", "separated"})
+    ->ArgsProduct({{0, 1}, {16, 128, 400}, {0, 1}});
+BENCHMARK_REGISTER_F(KeySearchBenchmark, Numeric)
+    ->ArgNames({"float", "items", "separated"})
+    ->ArgsProduct({{0, 1}, {16, 128, 400}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/linear_hash.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较线性哈希与B+树的等值查找性能
+ * @details 参数是数据量，两种索引中放同样的数据，每次查找一个随机的键值
+ */
+class PointLookupBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    key_num_ = static_cast<int>(state.range(0));
+
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+    LoggerFactory::init_default("linear_hash_performance.log", LOG_LEVEL_WARN);
+
+    const char *btree_filename = "linear_hash_performance.btree";
+    const char *hash_filename  = "linear_hash_performance.hash";
+    ::remove(btree_filename);
+    ::remove(hash_filename);
+
+    const AttrType attr_type   = AttrType::INTS;
+    const int      attr_length = sizeof(int);
+    RC rc = btree_handler_.create(log_handler_, bpm_, btree_filename, span<const AttrType>(&attr_type, 1),
+        span<const int>(&attr_length, 1));
+    if (OB_SUCC(rc)) {
+      rc = hash_handler_.create(log_handler_, bpm_, hash_filename, span<const AttrType>(&attr_type, 1),
+          span<const int>(&attr_length, 1));
+    }
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create index handler");
+    }
+
+    for (int i = 0; i < key_num_; i++) {
+      const RID rid(i + 1, 0);
+      rc = btree_handler_.insert_entry(reinterpret_cast<const char *>(&i), &rid);
+      if (OB_SUCC(rc)) {
+        rc = hash_handler_.insert_entry(reinterpret_cast<const char *>(&i), rid);
+      }
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to insert entry");
+      }
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    btree_handler_.close();
+    hash_handler_.close();
+  }
+
+protected:
+  int               key_num_ = 0;
+  BufferPoolManager bpm_;
+  VacuousLogHandler log_handler_;
+  BplusTreeHandler  btree_handler_;
+  LinearHashHandler hash_handler_;
+};
+
+BENCHMARK_DEFINE_F(PointLookupBenchmark, BplusTree)(State &state)
+{
+  IntegerGenerator generator(0, key_num_ - 1);
+  int64_t          found_count = 0;
+  for (auto _ : state) {
+    const int key = generator.next();
+    list<RID> rids;
+    btree_handler_.get_entry(reinterpret_cast<const char *>(&key), sizeof(key), rids);
+    found_count += rids.size();
+  }
+  state.counters["found"] = Counter(found_count, Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(PointLookupBenchmark, LinearHash)(State &state)
+{
+  IntegerGenerator generator(0, key_num_ - 1);
+  int64_t          found_count = 0;
+  vector<RID>      rids;
+  for (auto _ : state) {
+    const int key = generator.next();
+    rids.clear();
+    hash_handler_.get_entries(reinterpret_cast<const char *>(&key), rids);
+    found_count += rids.size();
+  }
+  state.counters["found"] = Counter(found_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(PointLookupBenchmark, BplusTree)->ArgName("keys")->Arg(10000)->Arg(200000);
+BENCHMARK_REGISTER_F(PointLookupBenchmark, LinearHash)->ArgName("keys")->Arg(10000)->Arg(200000);
+
+BENCHMARK_MAIN();
@@ -247,7 +247,7 @@ public:
     ChunkFileScanner scanner;
     Table            table;
     table.table_meta_.storage_format_ = StorageFormat::PAX_FORMAT;
-    RC rc = scanner.open_scan_chunk(&table, *buffer_pool_, log_handler_, ReadWriteMode::READ_ONLY);
+    RC rc = scanner.open_scan_chunk(&table, *buffer_pool_, nullptr /*trx*/, log_handler_, ReadWriteMode::READ_ONLY);
     if (rc != RC::SUCCESS) {
       stat.scan_open_failed_count++;
     } else {
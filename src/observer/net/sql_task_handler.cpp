@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include "event/session_event.h"
 #include "event/sql_event.h"
 #include "session/session.h"
+#include "storage/db/db.h"
 
 RC SqlTaskHandler::handle_event(Communicator *communicator)
 {
@@ -34,6 +35,13 @@ RC SqlTaskHandler::handle_event(Communicator *communicator)
 
   SQLStageEvent sql_event(event, event->query());
 
+  // 语句执行和输出结果期间，不允许后台任务移动记录
+  shared_lock<shared_mutex> background_guard;
+  Db                       *db = event->session()->get_current_db();
+  if (db != nullptr) {
+    background_guard = shared_lock<shared_mutex>(db->background_latch());
+  }
+
   rc = handle_sql(&sql_event);
   if (OB_FAIL(rc)) {
     LOG_TRACE("failed to handle sql. rc=%s", strrc(rc));
@@ -83,6 +83,14 @@ public:
   void          set_execution_mode(const ExecutionMode mode) { execution_mode_ = mode; }
   ExecutionMode get_execution_mode() const { return execution_mode_; }
 
+  /// @brief 创建索引时B+树节点的填充比例，是一个百分比，参考 IndexBuildOptions
+  void set_index_fill_factor(int fill_factor) { index_fill_factor_ = fill_factor; }
+  int  index_fill_factor() const { return index_fill_factor_; }
+
+  /// @brief 创建索引时排序可以使用的内存，单位是字节
+  void    set_index_sort_memory(int64_t sort_memory) { index_sort_memory_ = sort_memory; }
+  int64_t index_sort_memory() const { return index_sort_memory_; }
+
   bool used_chunk_mode() { return used_chunk_mode_; }
 
   void set_used_chunk_mode(bool used_chunk_mode) { used_chunk_mode_ = used_chunk_mode; }
@@ -113,4 +121,7 @@ private:
   bool used_chunk_mode_ = false;
 
   ExecutionMode execution_mode_ = ExecutionMode::TUPLE_ITERATOR;
+
+  int     index_fill_factor_ = 90;                ///< 创建索引时节点的填充比例(百分比)
+  int64_t index_sort_memory_ = 64 * 1024 * 1024;  ///< 创建索引时排序可以使用的内存
 };
@@ -18,7 +18,9 @@ See the Mulan PSL v2 for more details. */
 #include "event/sql_event.h"
 #include "session/session.h"
 #include "sql/stmt/create_index_stmt.h"
+#include "storage/index/index.h"
 #include "storage/table/table.h"
+#include "storage/trx/trx.h"
 
 RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 {
@@ -30,7 +32,20 @@ RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 
   CreateIndexStmt *create_index_stmt = static_cast<CreateIndexStmt *>(stmt);
 
-  Trx   *trx   = session->current_trx();
+  // 会话中的事务可能还停留在上一条语句的快照上，先开启事务，保证能看到已经提交的所有记录
+  Trx *trx = session->current_trx();
+  trx->start_if_need();
+
+  IndexBuildOptions options;
+  options.fill_factor = session->index_fill_factor() / 100.0f;
+  options.sort_memory = session->index_sort_memory();
+
   Table *table = create_index_stmt->table();
-  return table->create_index(trx, create_index_stmt->field_meta(), create_index_stmt->index_name().c_str());
+  return table->create_index(trx,
+      create_index_stmt->field_metas(),
+      create_index_stmt->include_field_metas(),
+      create_index_stmt->index_name().c_str(),
+      create_index_stmt->unique(),
+      options,
+      create_index_stmt->index_type());
 }
\ No newline at end of file
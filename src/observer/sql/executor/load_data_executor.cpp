@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include "event/sql_event.h"
 #include "sql/executor/sql_result.h"
 #include "sql/stmt/load_data_stmt.h"
+#include "storage/table/table_bulk_loader.h"
 
 using namespace common;
 
@@ -33,15 +34,16 @@ RC LoadDataExecutor::execute(SQLStageEvent *sql_event)
 }
 
 /**
- * 从文件中导入数据时使用。尝试向表中插入解析后的一行数据。
+ * 从文件中导入数据时使用。将解析后的一行数据转换成记录。
  * @param table  要导入的表
  * @param file_values 从文件中读取到的一行数据，使用分隔符拆分后的几个字段值
- * @param record_values Table::insert_record使用的参数，为了防止频繁的申请内存
+ * @param record_values Table::make_record使用的参数，为了防止频繁的申请内存
+ * @param record 转换后的记录
  * @param errmsg 如果出现错误，通过这个参数返回错误信息
  * @return 成功返回RC::SUCCESS
  */
-RC insert_record_from_file(
-    Table *table, std::vector<std::string> &file_values, std::vector<Value> &record_values, std::stringstream &errmsg)
+RC make_record_from_file(Table *table, std::vector<std::string> &file_values, std::vector<Value> &record_values,
+    Record &record, std::stringstream &errmsg)
 {
 
   const int field_num     = record_values.size();
@@ -65,12 +67,9 @@ RC insert_record_from_file(
   }
 
   if (RC::SUCCESS == rc) {
-    Record record;
     rc = table->make_record(field_num, record_values.data(), record);
     if (rc != RC::SUCCESS) {
       errmsg << "insert failed.";
-    } else if (RC::SUCCESS != (rc = table->insert_record(record))) {
-      errmsg << "insert failed.";
     }
   }
   return rc;
@@ -101,6 +100,10 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
   int                      line_num        = 0;
   int                      insertion_count = 0;
   RC                       rc              = RC::SUCCESS;
+
+  // 向空表导入数据时直接写满新页面，最后再构建索引
+  TableBulkLoader bulk_loader(*table);
+  const bool      bulk_mode = OB_SUCC(bulk_loader.open());
   while (!fs.eof() && RC::SUCCESS == rc) {
     std::getline(fs, line);
     line_num++;
@@ -111,7 +114,14 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
     file_values.clear();
     common::split_string(line, delim, file_values);
     std::stringstream errmsg;
-    rc = insert_record_from_file(table, file_values, record_values, errmsg);
+    Record            record;
+    rc = make_record_from_file(table, file_values, record_values, record, errmsg);
+    if (RC::SUCCESS == rc) {
+      rc = bulk_mode ? bulk_loader.insert_record(record) : table->insert_record(record);
+      if (rc != RC::SUCCESS) {
+        errmsg << "insert failed.";
+      }
+    }
     if (rc != RC::SUCCESS) {
       result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
                     << std::endl;
@@ -121,6 +131,14 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
   }
   fs.close();
 
+  if (bulk_mode) {
+    RC finish_rc = bulk_loader.finish();
+    if (finish_rc != RC::SUCCESS) {
+      result_string << "Failed to finish bulk load. error:" << strrc(finish_rc) << std::endl;
+      rc = finish_rc;
+    }
+  }
+
   struct timespec end_time;
   clock_gettime(CLOCK_MONOTONIC, &end_time);
   long cost_nano = (end_time.tv_sec - begin_time.tv_sec) * 1000000000L + (end_time.tv_nsec - begin_time.tv_nsec);
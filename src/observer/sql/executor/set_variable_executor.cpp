@@ -34,6 +34,19 @@ RC SetVariableExecutor::execute(SQLStageEvent *sql_event)
       } else {
         rc = RC::INVALID_ARGUMENT;
       }
+    } else if (strcasecmp(var_name, "index_fill_factor") == 0) {
+      // 与 BplusTreeBulkBuilder::MIN_FILL_FACTOR 一致，太小的填充比例会让节点在删除时马上合并
+      if (var_value.attr_type() == AttrType::INTS && var_value.get_int() >= 50 && var_value.get_int() <= 100) {
+        session->set_index_fill_factor(var_value.get_int());
+      } else {
+        rc = RC::VARIABLE_NOT_VALID;
+      }
+    } else if (strcasecmp(var_name, "index_sort_memory") == 0) {
+      if (var_value.attr_type() == AttrType::INTS && var_value.get_int() > 0) {
+        session->set_index_sort_memory(var_value.get_int());
+      } else {
+        rc = RC::VARIABLE_NOT_VALID;
+      }
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
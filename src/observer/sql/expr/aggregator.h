@@ -31,6 +31,20 @@ protected:
 
 class SumAggregator : public Aggregator
 {
+public:
+  RC accumulate(const Value &value) override;
+  RC evaluate(Value &result) override;
+};
+
+class MaxAggregator : public Aggregator
+{
+public:
+  RC accumulate(const Value &value) override;
+  RC evaluate(Value &result) override;
+};
+
+class MinAggregator : public Aggregator
+{
 public:
   RC accumulate(const Value &value) override;
   RC evaluate(Value &result) override;
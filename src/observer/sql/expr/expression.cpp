@@ -35,14 +35,18 @@ bool FieldExpr::equal(const Expression &other) const
   return table_name() == other_field_expr.table_name() && field_name() == other_field_expr.field_name();
 }
 
-// TODO: 在进行表达式计算时，`chunk` 包含了所有列，因此可以通过 `field_id` 获取到对应列。
-// 后续可以优化成在 `FieldExpr` 中存储 `chunk` 中某列的位置信息。
+// 表扫描只会读取查询用到的列，所以 `chunk` 中不一定包含所有列，需要通过 `field_id` 找到对应列的位置。
 RC FieldExpr::get_column(Chunk &chunk, Column &column)
 {
   if (pos_ != -1) {
     column.reference(chunk.column(pos_));
   } else {
-    column.reference(chunk.column(field().meta()->field_id()));
+    int index = chunk.column_index(field().meta()->field_id());
+    if (index < 0) {
+      LOG_WARN("cannot find column in chunk. field=%s.%s", table_name(), field_name());
+      return RC::NOTFOUND;
+    }
+    column.reference(chunk.column(index));
   }
   return RC::SUCCESS;
 }
@@ -553,6 +557,14 @@ unique_ptr<Aggregator> AggregateExpr::create_aggregator() const
       aggregator = make_unique<SumAggregator>();
       break;
     }
+    case Type::MAX: {
+      aggregator = make_unique<MaxAggregator>();
+      break;
+    }
+    case Type::MIN: {
+      aggregator = make_unique<MinAggregator>();
+      break;
+    }
     default: {
       ASSERT(false, "unsupported aggregate type");
       break;
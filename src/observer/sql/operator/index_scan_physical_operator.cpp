@@ -13,22 +13,39 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "common/lang/algorithm.h"
 #include "storage/index/index.h"
 #include "storage/trx/trx.h"
 
-IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
-    bool left_inclusive, const Value *right_value, bool right_inclusive)
+IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode,
+    std::vector<Value> left_values, bool left_inclusive, std::vector<Value> right_values, bool right_inclusive)
     : table_(table),
       index_(index),
       mode_(mode),
+      left_values_(std::move(left_values)),
+      right_values_(std::move(right_values)),
       left_inclusive_(left_inclusive),
       right_inclusive_(right_inclusive)
+{}
+
+void IndexScanPhysicalOperator::make_bound_key(
+    const std::vector<Value> &values, std::vector<char> &key, bool &inclusive) const
 {
-  if (left_value) {
-    left_value_ = *left_value;
-  }
-  if (right_value) {
-    right_value_ = *right_value;
+  const std::vector<FieldMeta> &field_metas = index_->field_metas();
+  ASSERT(values.size() <= field_metas.size(), "too many values for index bound");
+
+  key.clear();
+  for (size_t i = 0; i < values.size(); i++) {
+    const int    field_len = field_metas[i].len();
+    const Value &value     = values[i];
+    const size_t offset    = key.size();
+    key.resize(offset + field_len, 0);
+    memcpy(key.data() + offset, value.data(), std::min(value.length(), field_len));
+
+    // 字符串比字段长时，截断之后的值比原值小，左右边界都要包含截断后的值
+    if (value.attr_type() == AttrType::CHARS && value.length() > field_len) {
+      inclusive = true;
+    }
   }
 }
 
@@ -38,12 +55,30 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
-      left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
-      right_inclusive_);
+  IndexScanner *index_scanner = nullptr;
+  if (index_->field_metas().size() == 1) {
+    // 单个字段的索引直接使用值，字符串的长度由索引自己处理
+    const char *left_key  = left_values_.empty() ? nullptr : left_values_[0].data();
+    const int   left_len  = left_values_.empty() ? 0 : left_values_[0].length();
+    const char *right_key = right_values_.empty() ? nullptr : right_values_[0].data();
+    const int   right_len = right_values_.empty() ? 0 : right_values_[0].length();
+    index_scanner =
+        index_->create_scanner(left_key, left_len, left_inclusive_, right_key, right_len, right_inclusive_, reverse_);
+  } else {
+    std::vector<char> left_key;
+    std::vector<char> right_key;
+    bool              left_inclusive  = left_inclusive_;
+    bool              right_inclusive = right_inclusive_;
+    make_bound_key(left_values_, left_key, left_inclusive);
+    make_bound_key(right_values_, right_key, right_inclusive);
+    index_scanner = index_->create_scanner(left_key.empty() ? nullptr : left_key.data(),
+        static_cast<int>(left_key.size()),
+        left_inclusive,
+        right_key.empty() ? nullptr : right_key.data(),
+        static_cast<int>(right_key.size()),
+        right_inclusive,
+        reverse_);
+  }
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
     return RC::INTERNAL;
@@ -57,18 +92,84 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
   }
   index_scanner_ = index_scanner;
 
-  tuple_.set_schema(table_, table_->table_meta().field_metas());
+  covering_ = !covering_projection_.empty() && mode_ == ReadWriteMode::READ_ONLY && !trx->need_record_to_visit(table_);
+  if (covering_) {
+    // tuple 中只放索引中有的列，其它列不能被访问
+    covering_fields_.clear();
+    for (int field_id : covering_projection_) {
+      covering_fields_.push_back(*table_->table_meta().field(field_id));
+    }
+    tuple_.set_schema(table_, &covering_fields_);
+    covering_data_.assign(table_->table_meta().record_size(), 0);
+    current_record_ = Record();
+  } else {
+    tuple_.set_schema(table_, table_->table_meta().field_metas());
+  }
+
+  trx_         = trx;
+  emitted_num_ = 0;
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::next_covering_record(RID &rid)
+{
+  const char *key     = nullptr;
+  const char *include = nullptr;
+  RC          rc      = index_scanner_->next_entry(&rid, key, include);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    memcpy(covering_data_.data() + field_meta.offset(), key, field_meta.len());
+    key += field_meta.len();
+  }
+  for (const FieldMeta &field_meta : index_->include_field_metas()) {
+    memcpy(covering_data_.data() + field_meta.offset(), include, field_meta.len());
+    include += field_meta.len();
+  }
 
-  trx_ = trx;
+  current_record_.set_rid(rid);
+  current_record_.set_data(covering_data_.data(), static_cast<int>(covering_data_.size()));
   return RC::SUCCESS;
 }
 
 RC IndexScanPhysicalOperator::next()
+{
+  if (limit_ > 0 && emitted_num_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = next_record();
+  if (OB_SUCC(rc)) {
+    emitted_num_++;
+  }
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::next_record()
 {
   RID rid;
   RC  rc = RC::SUCCESS;
 
   bool filter_result = false;
+  while (covering_) {
+    rc = next_covering_record(rid);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to filter record. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (filter_result) {
+      return RC::SUCCESS;
+    }
+  }
+
   while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
     rc = record_handler_->get_record(rid, current_record_);
     if (OB_FAIL(rc)) {
@@ -143,5 +244,15 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 std::string IndexScanPhysicalOperator::param() const
 {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  std::string param = std::string(index_->index_meta().name()) + " ON " + table_->name();
+  if (!covering_projection_.empty()) {
+    param += " (covering)";
+  }
+  if (reverse_) {
+    param += " (reverse)";
+  }
+  if (limit_ > 0) {
+    param += " (limit " + std::to_string(limit_) + ")";
+  }
+  return param;
 }
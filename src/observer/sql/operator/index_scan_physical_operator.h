@@ -20,13 +20,18 @@ See the Mulan PSL v2 for more details. */
 
 /**
  * @brief 索引扫描物理算子
+ * @details 扫描范围的左右边界分别是索引前若干个字段的值。索引包含多个字段时，按照字段长度拼成键值，
+ * 边界只包含部分字段时按照前缀扫描，参考 BplusTreeScanner::open
+ * 查询用到的字段都在索引的键值或包含字段中，并且事务不需要读取记录来判断可见性时，
+ * 只扫描索引，不再读取记录，参考 set_covering。
+ * 也可以按照键值从大到小扫描，并且只返回前几条记录，参考 set_reverse 和 set_limit
  * @ingroup PhysicalOperator
  */
 class IndexScanPhysicalOperator : public PhysicalOperator
 {
 public:
-  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
-      bool left_inclusive, const Value *right_value, bool right_inclusive);
+  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, std::vector<Value> left_values,
+      bool left_inclusive, std::vector<Value> right_values, bool right_inclusive);
 
   virtual ~IndexScanPhysicalOperator() = default;
 
@@ -42,10 +47,44 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 尝试只扫描索引
+   * @details 调用者需要保证索引中存放了这些字段，参考 Index::covers。
+   * 只读访问并且事务不需要记录就能判断可见性时才会生效，参考 Trx::need_record_to_visit
+   * @param projection 查询用到的所有字段(field id)
+   */
+  void set_covering(const std::vector<int> &projection) { covering_projection_ = projection; }
+
+  /**
+   * @brief 从右边界向左边界反向扫描
+   * @details 调用者需要保证索引支持反向扫描，参考 Index::support_reverse_scan
+   */
+  void set_reverse(bool reverse) { reverse_ = reverse; }
+
+  /**
+   * @brief 最多返回 limit 条满足条件的记录，不大于0时不限制
+   * @details 只需要扫描范围最前面的几条记录时使用，比如从索引中查找 MIN/MAX
+   */
+  void set_limit(int limit) { limit_ = limit; }
+
 private:
+  /// @brief 获取下一条满足条件并且可见的记录，不考虑 limit
+  RC next_record();
+
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 把边界上的各个字段值拼成索引的键值
+   * @param values    边界上的值，对应索引的前 values.size() 个字段
+   * @param key       拼好的键值
+   * @param inclusive 字符串被截断时，边界需要变成包含
+   */
+  void make_bound_key(const std::vector<Value> &values, std::vector<char> &key, bool &inclusive) const;
+
+  /// @brief 只扫描索引时，用索引中的键值和包含字段拼出一条记录，没有的字段都是0
+  RC next_covering_record(RID &rid);
+
 private:
   Trx               *trx_            = nullptr;
   Table             *table_          = nullptr;
@@ -57,10 +96,19 @@ private:
   Record   current_record_;
   RowTuple tuple_;
 
-  Value left_value_;
-  Value right_value_;
-  bool  left_inclusive_  = false;
-  bool  right_inclusive_ = false;
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
+  bool               left_inclusive_  = false;
+  bool               right_inclusive_ = false;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
+
+  std::vector<int>       covering_projection_;  ///< 不为空时尝试只扫描索引
+  bool                   covering_ = false;     ///< 当前是否只扫描索引
+  std::vector<FieldMeta> covering_fields_;      ///< 只扫描索引时 tuple 中包含的列
+  std::vector<char>      covering_data_;        ///< 只扫描索引时拼出来的记录数据
+
+  bool reverse_     = false;  ///< 是否从右边界向左边界扫描
+  int  limit_       = 0;      ///< 最多返回多少条记录，不大于0时不限制
+  int  emitted_num_ = 0;      ///< 已经返回了多少条记录
 };
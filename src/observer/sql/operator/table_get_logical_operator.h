@@ -36,6 +36,9 @@ public:
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   auto predicates() -> std::vector<std::unique_ptr<Expression>> & { return predicates_; }
 
+  void set_projection(std::vector<int> &&field_ids) { projection_ = std::move(field_ids); }
+  auto projection() const -> const std::vector<int> & { return projection_; }
+
 private:
   Table        *table_ = nullptr;
   ReadWriteMode mode_  = ReadWriteMode::READ_WRITE;
@@ -45,4 +48,8 @@ private:
   // 不包含复杂的表达式运算，比如加减乘除、或者conjunction expression
   // 如果有多个表达式，他们的关系都是 AND
   std::vector<std::unique_ptr<Expression>> predicates_;
+
+  // 查询中实际用到的当前表的列(field id)，扫描时只需要读取这些列
+  // 为空时表示需要读取所有的列
+  std::vector<int> projection_;
 };
@@ -20,9 +20,18 @@ using namespace std;
 
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
-  RC rc = table_->get_record_scanner(record_scanner_, trx, mode_);
+  RC rc = table_->get_record_scanner(record_scanner_, trx, mode_, projection_);
   if (rc == RC::SUCCESS) {
-    tuple_.set_schema(table_, table_->table_meta().field_metas());
+    if (projection_.empty()) {
+      tuple_.set_schema(table_, table_->table_meta().field_metas());
+    } else {
+      // tuple 中只放需要的列，没有读取的列不能被访问
+      fields_.clear();
+      for (int field_id : projection_) {
+        fields_.push_back(*table_->table_meta().field(field_id));
+      }
+      tuple_.set_schema(table_, &fields_);
+    }
   }
   trx_ = trx;
   return rc;
@@ -44,6 +44,11 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置需要读取的列(field id)，为空时读取所有列
+   */
+  void set_projection(const std::vector<int> &field_ids) { projection_ = field_ids; }
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
@@ -55,4 +60,6 @@ private:
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_;  // TODO chang predicate to table tuple filter
+  std::vector<int>                         projection_;  ///< 需要读取的列，为空表示所有列
+  std::vector<FieldMeta>                   fields_;      ///< tuple 中包含的列，与 projection_ 对应
 };
@@ -21,12 +21,17 @@ RC TableScanVecPhysicalOperator::open(Trx *trx)
     LOG_WARN("failed to get chunk scanner", strrc(rc));
     return rc;
   }
-  // TODO: don't need to fetch all columns from record manager
-  for (int i = 0; i < table_->table_meta().field_num(); ++i) {
-    all_columns_.add_column(
-        make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
-    filterd_columns_.add_column(
-        make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
+  // 只从 record manager 中读取需要的列
+  vector<int> field_ids = projection_;
+  if (field_ids.empty()) {
+    for (int i = 0; i < table_->table_meta().field_num(); ++i) {
+      field_ids.push_back(i);
+    }
+  }
+  for (int field_id : field_ids) {
+    const FieldMeta *field_meta = table_->table_meta().field(field_id);
+    all_columns_.add_column(make_unique<Column>(*field_meta), field_meta->field_id());
+    filterd_columns_.add_column(make_unique<Column>(*field_meta), field_meta->field_id());
   }
   return rc;
 }
@@ -53,8 +58,8 @@ RC TableScanVecPhysicalOperator::next(Chunk &chunk)
           continue;
         }
         for (int j = 0; j < all_columns_.column_num(); j++) {
-          filterd_columns_.column(j).append_one(
-              (char *)all_columns_.column(filterd_columns_.column_ids(j)).get_value(i).data());
+          Column &column = all_columns_.column(j);
+          filterd_columns_.column(j).append_one(column.data() + i * column.attr_len());
         }
       }
       chunk.reference(filterd_columns_);
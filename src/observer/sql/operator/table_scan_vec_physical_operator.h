@@ -38,6 +38,11 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置需要读取的列(field id)，为空时读取所有列
+   */
+  void set_projection(const std::vector<int> &field_ids) { projection_ = field_ids; }
+
 private:
   RC filter(Chunk &chunk);
 
@@ -49,4 +54,5 @@ private:
   Chunk                                    filterd_columns_;
   std::vector<uint8_t>                     select_;
   std::vector<std::unique_ptr<Expression>> predicates_;
+  std::vector<int>                         projection_;  ///< 需要读取的列，为空表示所有列
 };
@@ -93,10 +93,21 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
   unique_ptr<LogicalOperator> table_oper(nullptr);
   last_oper = &table_oper;
 
+  unordered_map<const Table *, vector<int>> referenced_fields;
+  RC rc = collect_referenced_fields(select_stmt, referenced_fields);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to collect referenced fields. rc=%s", strrc(rc));
+    return rc;
+  }
+
   const std::vector<Table *> &tables = select_stmt->tables();
   for (Table *table : tables) {
 
-    unique_ptr<LogicalOperator> table_get_oper(new TableGetLogicalOperator(table, ReadWriteMode::READ_ONLY));
+    auto table_get_oper = make_unique<TableGetLogicalOperator>(table, ReadWriteMode::READ_ONLY);
+    auto iter           = referenced_fields.find(table);
+    if (iter != referenced_fields.end()) {
+      table_get_oper->set_projection(std::move(iter->second));
+    }
     if (table_oper == nullptr) {
       table_oper = std::move(table_get_oper);
     } else {
@@ -109,7 +120,7 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
 
   unique_ptr<LogicalOperator> predicate_oper;
 
-  RC rc = create_plan(select_stmt->filter_stmt(), predicate_oper);
+  rc = create_plan(select_stmt->filter_stmt(), predicate_oper);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to create predicate logical plan. rc=%s", strrc(rc));
     return rc;
@@ -217,6 +228,47 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
   return rc;
 }
 
+RC LogicalPlanGenerator::collect_referenced_fields(
+    SelectStmt *select_stmt, unordered_map<const Table *, vector<int>> &referenced_fields)
+{
+  function<RC(unique_ptr<Expression> &)> collector = [&](unique_ptr<Expression> &expr) -> RC {
+    if (expr->type() == ExprType::FIELD) {
+      const Field &field = static_cast<FieldExpr *>(expr.get())->field();
+      referenced_fields[field.table()].push_back(field.meta()->field_id());
+      return RC::SUCCESS;
+    }
+    return ExpressionIterator::iterate_child_expr(*expr, collector);
+  };
+
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<Expression> &expr : select_stmt->query_expressions()) {
+    if (OB_FAIL(rc = collector(expr))) {
+      return rc;
+    }
+  }
+  for (unique_ptr<Expression> &expr : select_stmt->group_by()) {
+    if (OB_FAIL(rc = collector(expr))) {
+      return rc;
+    }
+  }
+
+  if (select_stmt->filter_stmt() != nullptr) {
+    for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+      for (const FilterObj *filter_obj : {&filter_unit->left(), &filter_unit->right()}) {
+        if (filter_obj->is_attr) {
+          referenced_fields[filter_obj->field.table()].push_back(filter_obj->field.meta()->field_id());
+        }
+      }
+    }
+  }
+
+  for (auto &[table, field_ids] : referenced_fields) {
+    sort(field_ids.begin(), field_ids.end());
+    field_ids.erase(unique(field_ids.begin(), field_ids.end()), field_ids.end());
+  }
+  return rc;
+}
+
 int LogicalPlanGenerator::implicit_cast_cost(AttrType from, AttrType to)
 {
   if (from == to) {
@@ -15,6 +15,8 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "common/rc.h"
 #include "common/type/attr_type.h"
@@ -27,6 +29,7 @@ class InsertStmt;
 class DeleteStmt;
 class ExplainStmt;
 class LogicalOperator;
+class Table;
 
 class LogicalPlanGenerator
 {
@@ -46,5 +49,12 @@ private:
 
   RC create_group_by_plan(SelectStmt *select_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
 
+  /**
+   * @brief 收集查询中每张表实际用到的列(field id)，用于把投影下推到表扫描中
+   * @details 没有出现在结果中的表表示没有引用任何列，这时仍然需要读取所有列
+   */
+  RC collect_referenced_fields(
+      SelectStmt *select_stmt, std::unordered_map<const Table *, std::vector<int>> &referenced_fields);
+
   int implicit_cast_cost(AttrType from, AttrType to);
 };
\ No newline at end of file
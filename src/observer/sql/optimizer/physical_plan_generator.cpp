@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <utility>
 
+#include "common/lang/string.h"
 #include "common/log/log.h"
 #include "sql/expr/expression.h"
 #include "sql/operator/aggregate_vec_physical_operator.h"
@@ -43,6 +44,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/scalar_group_by_physical_operator.h"
 #include "sql/operator/table_scan_vec_physical_operator.h"
 #include "sql/optimizer/physical_plan_generator.h"
+#include "storage/index/index.h"
 
 using namespace std;
 
@@ -121,70 +123,298 @@ RC PhysicalPlanGenerator::create_vec(LogicalOperator &logical_operator, unique_p
 
 
 
-RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+namespace {
+
+/**
+ * @brief 可以用于索引查找的比较条件，形式是 "字段 比较符 值"
+ */
+struct IndexPredicate
 {
-  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
-  // 看看是否有可以用于索引查找的表达式
-  Table *table = table_get_oper.table();
+  const FieldMeta *field = nullptr;
+  CompOp           comp  = NO_OP;
+  const Value     *value = nullptr;
+};
+
+/**
+ * @brief 用索引查找时的扫描范围
+ * @details 前面若干个字段是等值条件，下一个字段可以再带一个范围条件
+ */
+struct IndexScanRange
+{
+  Index        *index = nullptr;
+  vector<Value> left_values;
+  vector<Value> right_values;
+  bool          left_inclusive  = true;
+  bool          right_inclusive = true;
+  int           score           = 0;  ///< 等值字段数*2，再加上是否有范围条件或者是否是等值查找的哈希索引
+};
+
+/**
+ * @brief 把比较表达式整理成 "字段 比较符 值" 的形式
+ * @details 值在左边时把比较符反过来。值的类型与字段类型不同时不使用，类型转换可能让范围不再正确
+ */
+bool get_index_predicate(Expression *expr, const Table *table, IndexPredicate &pred)
+{
+  if (expr->type() != ExprType::COMPARISON) {
+    return false;
+  }
 
-  Index     *index      = nullptr;
-  ValueExpr *value_expr = nullptr;
-  for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
-      }
+  auto   comparison_expr = static_cast<ComparisonExpr *>(expr);
+  CompOp comp            = comparison_expr->comp();
+  if (comp == NOT_EQUAL || comp == NO_OP) {
+    return false;
+  }
 
-      unique_ptr<Expression> &left_expr  = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
-      }
+  Expression *left_expr  = comparison_expr->left().get();
+  Expression *right_expr = comparison_expr->right().get();
+  if (left_expr->type() == ExprType::VALUE && right_expr->type() == ExprType::FIELD) {
+    std::swap(left_expr, right_expr);
+    switch (comp) {
+      case LESS_EQUAL: comp = GREAT_EQUAL; break;
+      case LESS_THAN: comp = GREAT_THAN; break;
+      case GREAT_EQUAL: comp = LESS_EQUAL; break;
+      case GREAT_THAN: comp = LESS_THAN; break;
+      default: break;
+    }
+  }
 
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
-      }
+  if (left_expr->type() != ExprType::FIELD || right_expr->type() != ExprType::VALUE) {
+    return false;
+  }
 
-      if (field_expr == nullptr) {
-        continue;
-      }
+  const Field &field = static_cast<FieldExpr *>(left_expr)->field();
+  const Value &value = static_cast<ValueExpr *>(right_expr)->get_value();
+  if (field.table() != table || field.meta()->type() != value.attr_type()) {
+    return false;
+  }
 
-      const Field &field = field_expr->field();
-      index              = table->find_index_by_field(field.field_name());
-      if (nullptr != index) {
-        break;
+  pred.field = field.meta();
+  pred.comp  = comp;
+  pred.value = &value;
+  return true;
+}
+
+/**
+ * @brief 计算用某个索引查找时的扫描范围
+ * @details 使用索引字段中最长的等值前缀，再加上下一个字段的范围条件
+ */
+IndexScanRange make_index_scan_range(Index *index, const vector<IndexPredicate> &preds)
+{
+  IndexScanRange range;
+  range.index = index;
+
+  auto find_pred = [&preds](const FieldMeta &field, auto &&match) -> const IndexPredicate * {
+    for (const IndexPredicate &pred : preds) {
+      if (0 == strcmp(pred.field->name(), field.name()) && match(pred.comp)) {
+        return &pred;
       }
     }
+    return nullptr;
+  };
+
+  const vector<FieldMeta> &fields = index->field_metas();
+
+  size_t eq_num = 0;
+  for (; eq_num < fields.size(); eq_num++) {
+    const IndexPredicate *pred = find_pred(fields[eq_num], [](CompOp comp) { return comp == EQUAL_TO; });
+    if (pred == nullptr) {
+      break;
+    }
+    range.left_values.push_back(*pred->value);
+  }
+  range.right_values = range.left_values;
+  range.score        = static_cast<int>(eq_num) * 2;
+
+  // 不能按范围扫描的索引(比如哈希索引)只能用于所有字段都是等值条件的查找，
+  // 这时只需要一次查找，比同样字段数的B+树索引更好
+  if (!index->support_range_scan()) {
+    range.score = (eq_num == fields.size()) ? range.score + 1 : 0;
+    return range;
+  }
+
+  if (eq_num == fields.size()) {
+    return range;
+  }
+
+  const FieldMeta      &field = fields[eq_num];
+  const IndexPredicate *lower =
+      find_pred(field, [](CompOp comp) { return comp == GREAT_EQUAL || comp == GREAT_THAN; });
+  const IndexPredicate *upper = find_pred(field, [](CompOp comp) { return comp == LESS_EQUAL || comp == LESS_THAN; });
+
+  // 范围是空的时候只保留下界，扫描出来的记录由过滤条件去掉
+  if (lower != nullptr && upper != nullptr) {
+    int cmp = lower->value->compare(*upper->value);
+    if (cmp > 0 || (cmp == 0 && (lower->comp == GREAT_THAN || upper->comp == LESS_THAN))) {
+      upper = nullptr;
+    }
+  }
+
+  if (lower != nullptr) {
+    range.left_values.push_back(*lower->value);
+    range.left_inclusive = (lower->comp == GREAT_EQUAL);
+  }
+  if (upper != nullptr) {
+    range.right_values.push_back(*upper->value);
+    range.right_inclusive = (upper->comp == LESS_EQUAL);
+  }
+  if (lower != nullptr || upper != nullptr) {
+    range.score += 1;
+  }
+  return range;
+}
+
+vector<IndexPredicate> collect_index_predicates(vector<unique_ptr<Expression>> &predicates, const Table *table)
+{
+  vector<IndexPredicate> index_preds;
+  for (auto &expr : predicates) {
+    IndexPredicate pred;
+    if (get_index_predicate(expr.get(), table, pred)) {
+      index_preds.push_back(pred);
+    }
+  }
+  return index_preds;
+}
+
+/**
+ * @brief 查询用到的字段是否都在索引中，可以只扫描索引
+ */
+bool index_covers(const Index *index, const vector<int> &projection)
+{
+  return index != nullptr && !projection.empty() && index->covers(projection);
+}
+
+/**
+ * @brief 按照扫描范围创建索引扫描算子，所有条件都留给算子再过滤一遍
+ */
+IndexScanPhysicalOperator *create_index_scan(TableGetLogicalOperator &table_get_oper, IndexScanRange &&range)
+{
+  IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table_get_oper.table(),
+      range.index,
+      table_get_oper.read_write_mode(),
+      std::move(range.left_values),
+      range.left_inclusive,
+      std::move(range.right_values),
+      range.right_inclusive);
+
+  index_scan_oper->set_predicates(std::move(table_get_oper.predicates()));
+  if (index_covers(range.index, table_get_oper.projection())) {
+    index_scan_oper->set_covering(table_get_oper.projection());
+  }
+  return index_scan_oper;
+}
+
+/**
+ * @brief 只查询某个字段的 MIN 或 MAX 时，从以这个字段开头的索引中取第一条记录
+ * @details 没有 group by，所有的聚合都是同一个字段上的 MIN(或者都是 MAX)，并且直接从表中读取数据时，
+ * 按照索引顺序扫描，第一条满足条件并且可见的记录就是结果。MIN 正向扫描，MAX 反向扫描。
+ * 其它索引能利用更多的过滤条件时，还是按照过滤条件选择索引
+ * @return 不能这样处理时返回 nullptr
+ */
+unique_ptr<PhysicalOperator> create_min_max_index_scan(GroupByLogicalOperator &group_by_oper)
+{
+  if (!group_by_oper.group_by_expressions().empty() || group_by_oper.aggregate_expressions().empty()) {
+    return nullptr;
+  }
+
+  LogicalOperator &child_oper = *group_by_oper.children().front();
+  if (child_oper.type() != LogicalOperatorType::TABLE_GET) {
+    return nullptr;
+  }
+
+  auto  &table_get_oper = static_cast<TableGetLogicalOperator &>(child_oper);
+  Table *table          = table_get_oper.table();
+
+  const FieldMeta    *field          = nullptr;
+  AggregateExpr::Type aggregate_type = AggregateExpr::Type::MIN;
+  for (Expression *expr : group_by_oper.aggregate_expressions()) {
+    if (expr->type() != ExprType::AGGREGATION) {
+      return nullptr;
+    }
+
+    auto                      *aggregate_expr = static_cast<AggregateExpr *>(expr);
+    const AggregateExpr::Type  type           = aggregate_expr->aggregate_type();
+    const Expression          *child_expr     = aggregate_expr->child().get();
+    if ((type != AggregateExpr::Type::MIN && type != AggregateExpr::Type::MAX) ||
+        child_expr->type() != ExprType::FIELD) {
+      return nullptr;
+    }
+
+    const Field &aggregate_field = static_cast<const FieldExpr *>(child_expr)->field();
+    if (aggregate_field.table() != table) {
+      return nullptr;
+    }
+    if (field == nullptr) {
+      field          = aggregate_field.meta();
+      aggregate_type = type;
+    } else if (field != aggregate_field.meta() || type != aggregate_type) {
+      return nullptr;
+    }
+  }
+
+  const bool             reverse     = (aggregate_type == AggregateExpr::Type::MAX);
+  const vector<int>     &projection  = table_get_oper.projection();
+  vector<IndexPredicate> index_preds = collect_index_predicates(table_get_oper.predicates(), table);
+
+  IndexScanRange best_range;
+  int            other_score = 0;
+  for (Index *index : table->indexes()) {
+    IndexScanRange range = make_index_scan_range(index, index_preds);
+    if (0 != strcmp(index->field_metas().front().name(), field->name()) || !index->support_range_scan() ||
+        (reverse && !index->support_reverse_scan())) {
+      other_score = max(other_score, range.score);
+      continue;
+    }
+
+    if (best_range.index == nullptr || range.score > best_range.score ||
+        (range.score == best_range.score && index_covers(index, projection) &&
+            !index_covers(best_range.index, projection))) {
+      best_range = std::move(range);
+    }
   }
 
-  if (index != nullptr) {
-    ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
+  if (best_range.index == nullptr || other_score > best_range.score) {
+    return nullptr;
+  }
+
+  IndexScanPhysicalOperator *index_scan_oper = create_index_scan(table_get_oper, std::move(best_range));
+  index_scan_oper->set_reverse(reverse);
+  index_scan_oper->set_limit(1);
+  LOG_TRACE("use index scan for %s", reverse ? "max" : "min");
+  return unique_ptr<PhysicalOperator>(index_scan_oper);
+}
+
+}  // namespace
+
+RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
+  // 看看是否有可以用于索引查找的表达式
+  Table *table = table_get_oper.table();
+
+  vector<IndexPredicate> index_preds = collect_index_predicates(predicates, table);
+
+  // 选择能利用最多字段的索引，一样多时优先选择包含了查询所有字段的索引
+  const vector<int> &projection = table_get_oper.projection();
 
-    const Value               &value           = value_expr->get_value();
-    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
-        index,
-        table_get_oper.read_write_mode(),
-        &value,
-        true /*left_inclusive*/,
-        &value,
-        true /*right_inclusive*/);
+  IndexScanRange best_range;
+  if (!index_preds.empty()) {
+    for (Index *index : table->indexes()) {
+      IndexScanRange range = make_index_scan_range(index, index_preds);
+      if (range.score > best_range.score ||
+          (range.score > 0 && range.score == best_range.score && index_covers(index, projection) &&
+              !index_covers(best_range.index, projection))) {
+        best_range = std::move(range);
+      }
+    }
+  }
 
-    index_scan_oper->set_predicates(std::move(predicates));
-    oper = unique_ptr<PhysicalOperator>(index_scan_oper);
+  if (best_range.index != nullptr) {
+    oper = unique_ptr<PhysicalOperator>(create_index_scan(table_get_oper, std::move(best_range)));
     LOG_TRACE("use index scan");
   } else {
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.read_write_mode());
     table_scan_oper->set_predicates(std::move(predicates));
+    table_scan_oper->set_projection(table_get_oper.projection());
     oper = unique_ptr<PhysicalOperator>(table_scan_oper);
     LOG_TRACE("use table scan");
   }
@@ -338,6 +568,11 @@ RC PhysicalPlanGenerator::create_plan(GroupByLogicalOperator &logical_oper, std:
 {
   RC rc = RC::SUCCESS;
 
+  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
+
+  // 聚合表达式交给物理算子之前，先看看能不能直接从索引中取 MIN/MAX
+  unique_ptr<PhysicalOperator> child_physical_oper = create_min_max_index_scan(logical_oper);
+
   vector<unique_ptr<Expression>> &group_by_expressions = logical_oper.group_by_expressions();
   unique_ptr<GroupByPhysicalOperator> group_by_oper;
   if (group_by_expressions.empty()) {
@@ -347,14 +582,13 @@ RC PhysicalPlanGenerator::create_plan(GroupByLogicalOperator &logical_oper, std:
         std::move(logical_oper.aggregate_expressions()));
   }
 
-  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
-
-  LogicalOperator             &child_oper = *logical_oper.children().front();
-  unique_ptr<PhysicalOperator> child_physical_oper;
-  rc = create(child_oper, child_physical_oper);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to create child physical operator of group by operator. rc=%s", strrc(rc));
-    return rc;
+  if (nullptr == child_physical_oper) {
+    LogicalOperator &child_oper = *logical_oper.children().front();
+    rc = create(child_oper, child_physical_oper);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create child physical operator of group by operator. rc=%s", strrc(rc));
+      return rc;
+    }
   }
 
   group_by_oper->add_child(std::move(child_physical_oper));
@@ -369,6 +603,7 @@ RC PhysicalPlanGenerator::create_vec_plan(TableGetLogicalOperator &table_get_ope
   Table *table = table_get_oper.table();
   TableScanVecPhysicalOperator *table_scan_oper = new TableScanVecPhysicalOperator(table, table_get_oper.read_write_mode());
   table_scan_oper->set_predicates(std::move(predicates));
+  table_scan_oper->set_projection(table_get_oper.projection());
   oper = unique_ptr<PhysicalOperator>(table_scan_oper);
   LOG_TRACE("use vectorized table scan");
 
@@ -369,8 +369,13 @@ RC check_aggregate_expression(AggregateExpr &expression)
   AggregateExpr::Type aggregate_type   = expression.aggregate_type();
   AttrType            child_value_type = child_expression->value_type();
   switch (aggregate_type) {
-    case AggregateExpr::Type::SUM:
     case AggregateExpr::Type::AVG: {
+      // 还没有实现对应的聚合器
+      LOG_WARN("unsupported aggregate type: %d", static_cast<int>(aggregate_type));
+      return RC::UNIMPLEMENTED;
+    } break;
+
+    case AggregateExpr::Type::SUM: {
       // 仅支持数值类型
       if (child_value_type != AttrType::INTS && child_value_type != AttrType::FLOATS) {
         LOG_WARN("invalid child value type for aggregate expression: %d", static_cast<int>(child_value_type));
@@ -378,7 +383,12 @@ RC check_aggregate_expression(AggregateExpr &expression)
       }
     } break;
 
-    case AggregateExpr::Type::COUNT:
+    case AggregateExpr::Type::COUNT: {
+      // 还没有实现对应的聚合器
+      LOG_WARN("unsupported aggregate type: %d", static_cast<int>(aggregate_type));
+      return RC::UNIMPLEMENTED;
+    } break;
+
     case AggregateExpr::Type::MAX:
     case AggregateExpr::Type::MIN: {
       // 任何类型都支持
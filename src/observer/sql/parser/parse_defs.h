@@ -157,6 +157,7 @@ struct CreateTableSqlNode
 {
   std::string                  relation_name;   ///< Relation name
   std::vector<AttrInfoSqlNode> attr_infos;      ///< attributes
+  std::vector<std::string>     cluster_names;   ///< CLUSTER BY 的字段，为空时不是聚簇表
   std::string                  storage_format;  ///< storage format
 };
 
@@ -177,9 +178,12 @@ struct DropTableSqlNode
  */
 struct CreateIndexSqlNode
 {
-  std::string index_name;      ///< Index name
-  std::string relation_name;   ///< Relation name
-  std::string attribute_name;  ///< Attribute name
+  std::string              index_name;       ///< Index name
+  std::string              relation_name;    ///< Relation name
+  std::vector<std::string> attribute_names;  ///< Attribute names, in key order
+  std::vector<std::string> include_names;    ///< INCLUDE 的字段，只存放在叶子节点中，不参与键值比较
+  bool                     unique = false;   ///< 是否是唯一索引
+  std::string              index_type;       ///< USING 指定的索引类型，为空时使用B+树
 };
 
 /**
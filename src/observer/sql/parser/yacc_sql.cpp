@@ -73,6 +73,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <algorithm>
 
 #include "common/log/log.h"
@@ -121,7 +122,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 }
 
 
-#line 125 "yacc_sql.cpp"
+#line 126 "yacc_sql.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -222,34 +223,39 @@ enum yysymbol_kind_t
   YYSYMBOL_show_tables_stmt = 70,          /* show_tables_stmt  */
   YYSYMBOL_desc_table_stmt = 71,           /* desc_table_stmt  */
   YYSYMBOL_create_index_stmt = 72,         /* create_index_stmt  */
-  YYSYMBOL_drop_index_stmt = 73,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 74,         /* create_table_stmt  */
-  YYSYMBOL_attr_def_list = 75,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 76,                  /* attr_def  */
-  YYSYMBOL_number = 77,                    /* number  */
-  YYSYMBOL_type = 78,                      /* type  */
-  YYSYMBOL_insert_stmt = 79,               /* insert_stmt  */
-  YYSYMBOL_value_list = 80,                /* value_list  */
-  YYSYMBOL_value = 81,                     /* value  */
-  YYSYMBOL_storage_format = 82,            /* storage_format  */
-  YYSYMBOL_delete_stmt = 83,               /* delete_stmt  */
-  YYSYMBOL_update_stmt = 84,               /* update_stmt  */
-  YYSYMBOL_select_stmt = 85,               /* select_stmt  */
-  YYSYMBOL_calc_stmt = 86,                 /* calc_stmt  */
-  YYSYMBOL_expression_list = 87,           /* expression_list  */
-  YYSYMBOL_expression = 88,                /* expression  */
-  YYSYMBOL_rel_attr = 89,                  /* rel_attr  */
-  YYSYMBOL_relation = 90,                  /* relation  */
-  YYSYMBOL_rel_list = 91,                  /* rel_list  */
-  YYSYMBOL_where = 92,                     /* where  */
-  YYSYMBOL_condition_list = 93,            /* condition_list  */
-  YYSYMBOL_condition = 94,                 /* condition  */
-  YYSYMBOL_comp_op = 95,                   /* comp_op  */
-  YYSYMBOL_group_by = 96,                  /* group_by  */
-  YYSYMBOL_load_data_stmt = 97,            /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 98,              /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 99,         /* set_variable_stmt  */
-  YYSYMBOL_opt_semicolon = 100             /* opt_semicolon  */
+  YYSYMBOL_opt_index_using = 73,           /* opt_index_using  */
+  YYSYMBOL_opt_unique = 74,                /* opt_unique  */
+  YYSYMBOL_opt_index_include = 75,         /* opt_index_include  */
+  YYSYMBOL_attr_name_list = 76,            /* attr_name_list  */
+  YYSYMBOL_drop_index_stmt = 77,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 78,         /* create_table_stmt  */
+  YYSYMBOL_opt_cluster_by = 79,            /* opt_cluster_by  */
+  YYSYMBOL_attr_def_list = 80,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 81,                  /* attr_def  */
+  YYSYMBOL_number = 82,                    /* number  */
+  YYSYMBOL_type = 83,                      /* type  */
+  YYSYMBOL_insert_stmt = 84,               /* insert_stmt  */
+  YYSYMBOL_value_list = 85,                /* value_list  */
+  YYSYMBOL_value = 86,                     /* value  */
+  YYSYMBOL_storage_format = 87,            /* storage_format  */
+  YYSYMBOL_delete_stmt = 88,               /* delete_stmt  */
+  YYSYMBOL_update_stmt = 89,               /* update_stmt  */
+  YYSYMBOL_select_stmt = 90,               /* select_stmt  */
+  YYSYMBOL_calc_stmt = 91,                 /* calc_stmt  */
+  YYSYMBOL_expression_list = 92,           /* expression_list  */
+  YYSYMBOL_expression = 93,                /* expression  */
+  YYSYMBOL_rel_attr = 94,                  /* rel_attr  */
+  YYSYMBOL_relation = 95,                  /* relation  */
+  YYSYMBOL_rel_list = 96,                  /* rel_list  */
+  YYSYMBOL_where = 97,                     /* where  */
+  YYSYMBOL_condition_list = 98,            /* condition_list  */
+  YYSYMBOL_condition = 99,                 /* condition  */
+  YYSYMBOL_comp_op = 100,                  /* comp_op  */
+  YYSYMBOL_group_by = 101,                 /* group_by  */
+  YYSYMBOL_load_data_stmt = 102,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 103,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 104,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 105             /* opt_semicolon  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -578,18 +584,18 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  65
+#define YYFINAL  66
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   141
+#define YYLAST   161
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  60
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  41
+#define YYNNTS  46
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  92
+#define YYNRULES  103
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  166
+#define YYNSTATES  189
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   310
@@ -644,16 +650,17 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   189,   189,   197,   198,   199,   200,   201,   202,   203,
-     204,   205,   206,   207,   208,   209,   210,   211,   212,   213,
-     214,   215,   216,   220,   226,   231,   237,   243,   249,   255,
-     262,   268,   276,   290,   300,   324,   327,   340,   348,   358,
-     361,   362,   363,   364,   367,   384,   387,   398,   402,   406,
-     415,   418,   425,   437,   452,   477,   486,   491,   502,   505,
-     508,   511,   514,   518,   521,   526,   532,   539,   544,   554,
-     559,   564,   578,   581,   587,   590,   595,   602,   614,   626,
-     638,   653,   654,   655,   656,   657,   658,   664,   669,   682,
-     690,   700,   701
+       0,   195,   195,   203,   204,   205,   206,   207,   208,   209,
+     210,   211,   212,   213,   214,   215,   216,   217,   218,   219,
+     220,   221,   222,   226,   232,   237,   243,   249,   255,   261,
+     268,   274,   282,   307,   310,   326,   329,   344,   347,   361,
+     366,   374,   384,   414,   417,   431,   434,   447,   455,   465,
+     468,   469,   470,   471,   474,   491,   494,   505,   509,   513,
+     522,   525,   532,   544,   559,   584,   593,   598,   609,   612,
+     615,   618,   621,   625,   628,   633,   639,   642,   650,   655,
+     665,   670,   675,   689,   692,   698,   701,   706,   713,   725,
+     737,   749,   764,   765,   766,   767,   768,   769,   775,   780,
+     793,   801,   811,   812
 };
 #endif
 
@@ -680,12 +687,14 @@ static const char *const yytname[] =
   "commands", "command_wrapper", "exit_stmt", "help_stmt", "sync_stmt",
   "begin_stmt", "commit_stmt", "rollback_stmt", "drop_table_stmt",
   "show_tables_stmt", "desc_table_stmt", "create_index_stmt",
-  "drop_index_stmt", "create_table_stmt", "attr_def_list", "attr_def",
-  "number", "type", "insert_stmt", "value_list", "value", "storage_format",
-  "delete_stmt", "update_stmt", "select_stmt", "calc_stmt",
-  "expression_list", "expression", "rel_attr", "relation", "rel_list",
-  "where", "condition_list", "condition", "comp_op", "group_by",
-  "load_data_stmt", "explain_stmt", "set_variable_stmt", "opt_semicolon", YY_NULLPTR
+  "opt_index_using", "opt_unique", "opt_index_include", "attr_name_list",
+  "drop_index_stmt", "create_table_stmt", "opt_cluster_by",
+  "attr_def_list", "attr_def", "number", "type", "insert_stmt",
+  "value_list", "value", "storage_format", "delete_stmt", "update_stmt",
+  "select_stmt", "calc_stmt", "expression_list", "expression", "rel_attr",
+  "relation", "rel_list", "where", "condition_list", "condition",
+  "comp_op", "group_by", "load_data_stmt", "explain_stmt",
+  "set_variable_stmt", "opt_semicolon", YY_NULLPTR
 };
 
 static const char *
@@ -695,7 +704,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-97)
+#define YYPACT_NINF (-170)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -707,25 +716,27 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-static const yytype_int8 yypact[] =
+static const yytype_int16 yypact[] =
 {
-      51,     6,    14,   -16,   -16,   -38,     2,   -97,    -5,    -3,
-     -24,   -97,   -97,   -97,   -97,   -97,   -23,    -6,    51,    32,
-      36,   -97,   -97,   -97,   -97,   -97,   -97,   -97,   -97,   -97,
-     -97,   -97,   -97,   -97,   -97,   -97,   -97,   -97,   -97,   -97,
-     -97,    -2,    17,    23,    25,   -16,   -97,   -97,    24,   -97,
-     -16,   -97,   -97,   -97,    -8,   -97,    45,   -97,   -97,    38,
-      39,    52,    49,    54,   -97,   -97,   -97,   -97,    77,    59,
-     -97,    60,   -12,    46,   -97,   -16,   -16,   -16,   -16,   -16,
-      47,    68,    67,    55,   -42,    53,    56,    57,    58,   -97,
-     -97,   -97,   -32,   -32,   -97,   -97,   -97,    91,    67,    94,
-     -47,   -97,    69,   -97,    83,    -7,    95,    98,   -97,    47,
-     -97,   -42,    37,    37,   -97,    82,   -42,   111,   -97,   -97,
-     -97,   -97,   101,    56,   102,    70,   -97,   -97,   100,   -97,
-     -97,   -97,   -97,   -97,   -97,   -47,   -47,   -47,    67,    71,
-      74,    95,    84,   106,   -42,   108,   -97,   -97,   -97,   -97,
-     -97,   -97,   -97,   -97,   109,   -97,    86,   -97,   -97,   100,
-     -97,   -97,    87,   -97,    78,   -97
+      65,    -6,    12,    -3,    -3,   -44,     6,  -170,   -11,    -2,
+      -9,  -170,  -170,  -170,  -170,  -170,    -7,    23,    65,    52,
+      61,  -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,
+    -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,
+    -170,    19,  -170,    64,    22,    31,    -3,  -170,  -170,   -12,
+    -170,    -3,  -170,  -170,  -170,    41,  -170,    51,  -170,  -170,
+      33,    47,    55,    56,    62,  -170,  -170,  -170,  -170,    86,
+      53,  -170,    74,     3,    -3,    60,  -170,    -3,    -3,    -3,
+      -3,    -3,    63,    81,    80,    66,    39,    67,    69,    79,
+      70,  -170,    11,  -170,  -170,   -23,   -23,  -170,  -170,  -170,
+      97,    80,   101,   -40,  -170,    82,  -170,    92,    83,   104,
+      73,  -170,  -170,    63,  -170,    39,    98,   -21,   -21,  -170,
+      94,    39,   120,  -170,  -170,  -170,  -170,   112,    69,   113,
+      84,  -170,  -170,   111,  -170,  -170,  -170,  -170,  -170,  -170,
+     -40,   -40,   -40,    80,    85,    88,   104,    87,    89,   115,
+      39,   116,  -170,  -170,  -170,  -170,  -170,  -170,  -170,  -170,
+     121,  -170,   131,   100,  -170,    91,   111,  -170,  -170,   126,
+     102,  -170,   127,   129,  -170,    91,   105,    91,    99,   133,
+     103,  -170,   128,  -170,  -170,  -170,    91,   134,  -170
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -733,43 +744,45 @@ static const yytype_int8 yypact[] =
    means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,    25,     0,     0,
+       0,    35,     0,     0,     0,     0,     0,    25,     0,     0,
        0,    26,    27,    28,    24,    23,     0,     0,     0,     0,
-      91,    22,    21,    14,    15,    16,    17,     9,    10,    11,
+     102,    22,    21,    14,    15,    16,    17,     9,    10,    11,
       12,    13,     8,     5,     7,     6,     4,     3,    18,    19,
-      20,     0,     0,     0,     0,     0,    47,    48,    67,    49,
-       0,    66,    64,    55,    56,    65,     0,    31,    30,     0,
-       0,     0,     0,     0,    89,     1,    92,     2,     0,     0,
-      29,     0,     0,     0,    63,     0,     0,     0,     0,     0,
-       0,     0,    72,     0,     0,     0,     0,     0,     0,    62,
-      68,    57,    58,    59,    60,    61,    69,    70,    72,     0,
-      74,    52,     0,    90,     0,     0,    35,     0,    33,     0,
-      87,     0,     0,     0,    73,    75,     0,     0,    40,    41,
-      42,    43,    38,     0,     0,     0,    71,    54,    45,    81,
-      82,    83,    84,    85,    86,     0,     0,    74,    72,     0,
-       0,    35,    50,     0,     0,     0,    78,    80,    77,    79,
-      76,    53,    88,    39,     0,    36,     0,    34,    32,    45,
-      44,    37,     0,    46,     0,    51
+      20,     0,    36,     0,     0,     0,     0,    57,    58,    78,
+      59,     0,    76,    74,    65,    66,    75,     0,    31,    30,
+       0,     0,     0,     0,     0,   100,     1,   103,     2,     0,
+       0,    29,     0,     0,     0,     0,    73,     0,     0,     0,
+       0,     0,     0,     0,    83,     0,     0,     0,     0,     0,
+       0,    72,     0,    79,    67,    68,    69,    70,    71,    80,
+      81,    83,     0,    85,    62,     0,   101,     0,     0,    45,
+       0,    41,    77,     0,    98,     0,    78,     0,     0,    84,
+      86,     0,     0,    50,    51,    52,    53,    48,     0,     0,
+      33,    82,    64,    55,    92,    93,    94,    95,    96,    97,
+       0,     0,    85,    83,     0,     0,    45,    43,     0,     0,
+       0,     0,    89,    91,    88,    90,    87,    63,    99,    49,
+       0,    46,     0,    60,    34,     0,    55,    54,    47,     0,
+       0,    42,    39,     0,    56,     0,     0,     0,    37,     0,
+       0,    40,     0,    32,    44,    61,     0,     0,    38
 };
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int16 yypgoto[] =
 {
-     -97,   -97,   115,   -97,   -97,   -97,   -97,   -97,   -97,   -97,
-     -97,   -97,   -97,   -97,   -97,    -1,    11,   -97,   -97,   -97,
-     -22,   -83,   -97,   -97,   -97,   -97,   -97,    -4,    27,   -77,
-     -97,    26,   -96,     1,   -97,    28,   -97,   -97,   -97,   -97,
-     -97
+    -170,  -170,   137,  -170,  -170,  -170,  -170,  -170,  -170,  -170,
+    -170,  -170,  -170,  -170,  -170,  -170,  -169,  -170,  -170,  -170,
+       5,    29,  -170,  -170,  -170,    -8,   -85,  -170,  -170,  -170,
+    -170,  -170,    -4,   -41,   -99,  -170,    46,   -98,    18,  -170,
+      43,  -170,  -170,  -170,  -170,  -170
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
        0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,    31,    32,   124,   106,   154,   122,    33,
-     145,    52,   157,    34,    35,    36,    37,    53,    54,    55,
-      97,    98,   101,   114,   115,   135,   127,    38,    39,    40,
-      67
+      28,    29,    30,   149,    43,   183,   173,    31,    32,   163,
+     129,   109,   160,   127,    33,   151,    53,   171,    34,    35,
+      36,    37,    54,    55,    56,   100,   101,   104,   119,   120,
+     140,   132,    38,    39,    40,    68
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -777,40 +790,44 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      56,   103,   110,    45,    46,    47,    48,    49,    89,    46,
-      47,    58,    49,    75,    41,    57,    42,   112,   118,   119,
-     120,   121,    43,   113,    44,    78,    79,    59,   128,    61,
-      62,    60,    65,   138,    63,    46,    47,    48,    49,    66,
-      50,    51,   151,    76,    77,    78,    79,    76,    77,    78,
-      79,    68,   146,   148,   112,    73,     1,     2,   147,   149,
-     113,   159,     3,     4,     5,     6,     7,     8,     9,    10,
-      69,    91,    72,    11,    12,    13,    70,    74,    71,    80,
-      14,    15,   129,   130,   131,   132,   133,   134,    16,    83,
-      17,    81,    82,    18,    84,    85,    86,    87,    88,    90,
-      96,    99,   100,    92,    93,    94,    95,   104,   102,   105,
-     107,   108,   109,   111,   116,   117,   123,   125,   137,   139,
-     140,   144,   142,   143,   152,   153,   158,   156,   160,   161,
-     162,   165,   164,    64,   141,   126,     0,   163,   150,     0,
-     155,   136
+      57,   106,    41,   114,   118,    73,   179,    74,   181,    58,
+      76,    47,    48,   116,    50,    59,    46,   187,   117,    75,
+      44,    60,    45,    91,   134,   135,   136,   137,   138,   139,
+     133,   112,    61,    92,    80,    81,   143,    95,    96,    97,
+      98,   153,   155,   118,    62,   157,    63,    42,    47,    48,
+      49,    50,    66,    51,    52,   152,   154,   117,    78,    79,
+      80,    81,    77,    64,    67,   166,    78,    79,    80,    81,
+       1,     2,    69,    94,    70,    71,     3,     4,     5,     6,
+       7,     8,     9,    10,    72,    82,    83,    11,    12,    13,
+      47,    48,    85,    50,    14,    15,    78,    79,    80,    81,
+      84,    86,    16,    87,    17,    88,    89,    18,   123,   124,
+     125,   126,    90,    93,   102,   103,    99,   110,   113,   105,
+     115,   107,   108,   111,   122,   128,   130,   121,   144,    75,
+     142,   145,   150,   147,   165,   169,   167,   148,   158,   159,
+     162,   168,   164,   170,   172,   175,   176,   186,   177,   178,
+     180,   161,   182,   184,   188,    65,   185,   146,   174,   131,
+     156,   141
 };
 
-static const yytype_int16 yycheck[] =
+static const yytype_uint8 yycheck[] =
 {
-       4,    84,    98,    19,    51,    52,    53,    54,    20,    51,
-      52,     9,    54,    21,     8,    53,    10,   100,    25,    26,
-      27,    28,     8,   100,    10,    57,    58,    32,   111,    53,
-      53,    34,     0,   116,    40,    51,    52,    53,    54,     3,
-      56,    57,   138,    55,    56,    57,    58,    55,    56,    57,
-      58,    53,   135,   136,   137,    31,     5,     6,   135,   136,
-     137,   144,    11,    12,    13,    14,    15,    16,    17,    18,
-      53,    75,    45,    22,    23,    24,    53,    50,    53,    34,
-      29,    30,    45,    46,    47,    48,    49,    50,    37,    37,
-      39,    53,    53,    42,    45,    41,    19,    38,    38,    53,
-      53,    33,    35,    76,    77,    78,    79,    54,    53,    53,
-      53,    53,    21,    19,    45,    32,    21,    19,    36,     8,
-      19,    21,    20,    53,    53,    51,    20,    43,    20,    20,
-      44,    53,    45,    18,   123,   109,    -1,   159,   137,    -1,
-     141,   113
+       4,    86,     8,   101,   103,    46,   175,    19,   177,    53,
+      51,    51,    52,    53,    54,     9,    19,   186,   103,    31,
+       8,    32,    10,    20,    45,    46,    47,    48,    49,    50,
+     115,    20,    34,    74,    57,    58,   121,    78,    79,    80,
+      81,   140,   141,   142,    53,   143,    53,    53,    51,    52,
+      53,    54,     0,    56,    57,   140,   141,   142,    55,    56,
+      57,    58,    21,    40,     3,   150,    55,    56,    57,    58,
+       5,     6,    53,    77,    10,    53,    11,    12,    13,    14,
+      15,    16,    17,    18,    53,    34,    53,    22,    23,    24,
+      51,    52,    37,    54,    29,    30,    55,    56,    57,    58,
+      53,    45,    37,    41,    39,    19,    53,    42,    25,    26,
+      27,    28,    38,    53,    33,    35,    53,    38,    21,    53,
+      19,    54,    53,    53,    32,    21,    53,    45,     8,    31,
+      36,    19,    21,    20,    19,     4,    20,    53,    53,    51,
+      53,    20,    53,    43,    53,    19,    44,    19,    21,    20,
+      45,   146,    53,    20,    20,    18,    53,   128,   166,   113,
+     142,   118
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -820,20 +837,22 @@ static const yytype_int8 yystos[] =
        0,     5,     6,    11,    12,    13,    14,    15,    16,    17,
       18,    22,    23,    24,    29,    30,    37,    39,    42,    61,
       62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
-      72,    73,    74,    79,    83,    84,    85,    86,    97,    98,
-      99,     8,    10,     8,    10,    19,    51,    52,    53,    54,
-      56,    57,    81,    87,    88,    89,    87,    53,     9,    32,
-      34,    53,    53,    40,    62,     0,     3,   100,    53,    53,
-      53,    53,    88,    31,    88,    21,    55,    56,    57,    58,
-      34,    53,    53,    37,    45,    41,    19,    38,    38,    20,
-      53,    87,    88,    88,    88,    88,    53,    90,    91,    33,
-      35,    92,    53,    81,    54,    53,    76,    53,    53,    21,
-      92,    19,    81,    89,    93,    94,    45,    32,    25,    26,
-      27,    28,    78,    21,    75,    19,    91,    96,    81,    45,
-      46,    47,    48,    49,    50,    95,    95,    36,    81,     8,
-      19,    76,    20,    53,    21,    80,    81,    89,    81,    89,
-      93,    92,    53,    51,    77,    75,    43,    82,    20,    81,
-      20,    20,    44,    80,    45,    53
+      72,    77,    78,    84,    88,    89,    90,    91,   102,   103,
+     104,     8,    53,    74,     8,    10,    19,    51,    52,    53,
+      54,    56,    57,    86,    92,    93,    94,    92,    53,     9,
+      32,    34,    53,    53,    40,    62,     0,     3,   105,    53,
+      10,    53,    53,    93,    19,    31,    93,    21,    55,    56,
+      57,    58,    34,    53,    53,    37,    45,    41,    19,    53,
+      38,    20,    93,    53,    92,    93,    93,    93,    93,    53,
+      95,    96,    33,    35,    97,    53,    86,    54,    53,    81,
+      38,    53,    20,    21,    97,    19,    53,    86,    94,    98,
+      99,    45,    32,    25,    26,    27,    28,    83,    21,    80,
+      53,    96,   101,    86,    45,    46,    47,    48,    49,    50,
+     100,   100,    36,    86,     8,    19,    81,    20,    53,    73,
+      21,    85,    86,    94,    86,    94,    98,    97,    53,    51,
+      82,    80,    53,    79,    53,    19,    86,    20,    20,     4,
+      43,    87,    53,    76,    85,    19,    44,    21,    20,    76,
+      45,    76,    53,    75,    20,    53,    19,    76,    20
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
@@ -842,13 +861,14 @@ static const yytype_int8 yyr1[] =
        0,    60,    61,    62,    62,    62,    62,    62,    62,    62,
       62,    62,    62,    62,    62,    62,    62,    62,    62,    62,
       62,    62,    62,    63,    64,    65,    66,    67,    68,    69,
-      70,    71,    72,    73,    74,    75,    75,    76,    76,    77,
-      78,    78,    78,    78,    79,    80,    80,    81,    81,    81,
-      82,    82,    83,    84,    85,    86,    87,    87,    88,    88,
-      88,    88,    88,    88,    88,    88,    88,    89,    89,    90,
-      91,    91,    92,    92,    93,    93,    93,    94,    94,    94,
-      94,    95,    95,    95,    95,    95,    95,    96,    97,    98,
-      99,   100,   100
+      70,    71,    72,    73,    73,    74,    74,    75,    75,    76,
+      76,    77,    78,    79,    79,    80,    80,    81,    81,    82,
+      83,    83,    83,    83,    84,    85,    85,    86,    86,    86,
+      87,    87,    88,    89,    90,    91,    92,    92,    93,    93,
+      93,    93,    93,    93,    93,    93,    93,    93,    94,    94,
+      95,    96,    96,    97,    97,    98,    98,    98,    99,    99,
+      99,    99,   100,   100,   100,   100,   100,   100,   101,   102,
+     103,   104,   105,   105
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -857,13 +877,14 @@ static const yytype_int8 yyr2[] =
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     3,
-       2,     2,     8,     5,     8,     0,     3,     5,     2,     1,
+       2,     2,    11,     0,     2,     0,     1,     0,     4,     1,
+       3,     5,     9,     0,     5,     0,     3,     5,     2,     1,
        1,     1,     1,     1,     8,     0,     3,     1,     1,     1,
        0,     4,     4,     7,     6,     2,     1,     3,     3,     3,
-       3,     3,     3,     2,     1,     1,     1,     1,     3,     1,
-       1,     3,     0,     2,     0,     1,     3,     3,     3,     3,
-       3,     1,     1,     1,     1,     1,     1,     0,     7,     2,
-       4,     0,     1
+       3,     3,     3,     2,     1,     1,     1,     4,     1,     3,
+       1,     1,     3,     0,     2,     0,     1,     3,     3,     3,
+       3,     3,     1,     1,     1,     1,     1,     1,     0,     7,
+       2,     4,     0,     1
 };
 
 
@@ -1725,108 +1746,205 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 190 "yacc_sql.y"
+#line 196 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1734 "yacc_sql.cpp"
+#line 1755 "yacc_sql.cpp"
     break;
 
   case 23: /* exit_stmt: EXIT  */
-#line 220 "yacc_sql.y"
+#line 226 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1743 "yacc_sql.cpp"
+#line 1764 "yacc_sql.cpp"
     break;
 
   case 24: /* help_stmt: HELP  */
-#line 226 "yacc_sql.y"
+#line 232 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1751 "yacc_sql.cpp"
+#line 1772 "yacc_sql.cpp"
     break;
 
   case 25: /* sync_stmt: SYNC  */
-#line 231 "yacc_sql.y"
+#line 237 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1759 "yacc_sql.cpp"
+#line 1780 "yacc_sql.cpp"
     break;
 
   case 26: /* begin_stmt: TRX_BEGIN  */
-#line 237 "yacc_sql.y"
+#line 243 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1767 "yacc_sql.cpp"
+#line 1788 "yacc_sql.cpp"
     break;
 
   case 27: /* commit_stmt: TRX_COMMIT  */
-#line 243 "yacc_sql.y"
+#line 249 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1775 "yacc_sql.cpp"
+#line 1796 "yacc_sql.cpp"
     break;
 
   case 28: /* rollback_stmt: TRX_ROLLBACK  */
-#line 249 "yacc_sql.y"
+#line 255 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1783 "yacc_sql.cpp"
+#line 1804 "yacc_sql.cpp"
     break;
 
   case 29: /* drop_table_stmt: DROP TABLE ID  */
-#line 255 "yacc_sql.y"
+#line 261 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1793 "yacc_sql.cpp"
+#line 1814 "yacc_sql.cpp"
     break;
 
   case 30: /* show_tables_stmt: SHOW TABLES  */
-#line 262 "yacc_sql.y"
+#line 268 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1801 "yacc_sql.cpp"
+#line 1822 "yacc_sql.cpp"
     break;
 
   case 31: /* desc_table_stmt: DESC ID  */
-#line 268 "yacc_sql.y"
+#line 274 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1811 "yacc_sql.cpp"
+#line 1832 "yacc_sql.cpp"
     break;
 
-  case 32: /* create_index_stmt: CREATE INDEX ID ON ID LBRACE ID RBRACE  */
-#line 277 "yacc_sql.y"
+  case 32: /* create_index_stmt: CREATE opt_unique INDEX ID ON ID opt_index_using LBRACE attr_name_list RBRACE opt_index_include  */
+#line 283 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-      create_index.index_name = (yyvsp[-5].string);
-      create_index.relation_name = (yyvsp[-3].string);
-      create_index.attribute_name = (yyvsp[-1].string);
+      create_index.unique = ((yyvsp[-9].number) != 0);
+      create_index.index_name = (yyvsp[-7].string);
+      create_index.relation_name = (yyvsp[-5].string);
+      if ((yyvsp[-4].string) != nullptr) {
+        create_index.index_type = (yyvsp[-4].string);
+        free((yyvsp[-4].string));
+      }
+      create_index.attribute_names.swap(*(yyvsp[-2].relation_list));
+      if ((yyvsp[0].relation_list) != nullptr) {
+        create_index.include_names.swap(*(yyvsp[0].relation_list));
+        delete (yyvsp[0].relation_list);
+      }
+      free((yyvsp[-7].string));
       free((yyvsp[-5].string));
-      free((yyvsp[-3].string));
+      delete (yyvsp[-2].relation_list);
+    }
+#line 1856 "yacc_sql.cpp"
+    break;
+
+  case 33: /* opt_index_using: %empty  */
+#line 307 "yacc_sql.y"
+    {
+      (yyval.string) = nullptr;
+    }
+#line 1864 "yacc_sql.cpp"
+    break;
+
+  case 34: /* opt_index_using: ID ID  */
+#line 311 "yacc_sql.y"
+    {
+      if (0 != strcasecmp((yyvsp[-1].string), "using")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect USING");
+        free((yyvsp[-1].string));
+        free((yyvsp[0].string));
+        YYERROR;
+      }
+      (yyval.string) = (yyvsp[0].string);
       free((yyvsp[-1].string));
     }
-#line 1826 "yacc_sql.cpp"
+#line 1879 "yacc_sql.cpp"
+    break;
+
+  case 35: /* opt_unique: %empty  */
+#line 326 "yacc_sql.y"
+    {
+      (yyval.number) = 0;
+    }
+#line 1887 "yacc_sql.cpp"
+    break;
+
+  case 36: /* opt_unique: ID  */
+#line 330 "yacc_sql.y"
+    {
+      if (0 != strcasecmp((yyvsp[0].string), "unique")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect UNIQUE");
+        free((yyvsp[0].string));
+        YYERROR;
+      }
+      (yyval.number) = 1;
+      free((yyvsp[0].string));
+    }
+#line 1901 "yacc_sql.cpp"
     break;
 
-  case 33: /* drop_index_stmt: DROP INDEX ID ON ID  */
-#line 291 "yacc_sql.y"
+  case 37: /* opt_index_include: %empty  */
+#line 344 "yacc_sql.y"
+    {
+      (yyval.relation_list) = nullptr;
+    }
+#line 1909 "yacc_sql.cpp"
+    break;
+
+  case 38: /* opt_index_include: ID LBRACE attr_name_list RBRACE  */
+#line 348 "yacc_sql.y"
+    {
+      if (0 != strcasecmp((yyvsp[-3].string), "include")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect INCLUDE");
+        free((yyvsp[-3].string));
+        delete (yyvsp[-1].relation_list);
+        YYERROR;
+      }
+      (yyval.relation_list) = (yyvsp[-1].relation_list);
+      free((yyvsp[-3].string));
+    }
+#line 1924 "yacc_sql.cpp"
+    break;
+
+  case 39: /* attr_name_list: ID  */
+#line 361 "yacc_sql.y"
+       {
+      (yyval.relation_list) = new std::vector<std::string>();
+      (yyval.relation_list)->push_back((yyvsp[0].string));
+      free((yyvsp[0].string));
+    }
+#line 1934 "yacc_sql.cpp"
+    break;
+
+  case 40: /* attr_name_list: ID COMMA attr_name_list  */
+#line 366 "yacc_sql.y"
+                              {
+      (yyval.relation_list) = (yyvsp[0].relation_list);
+      (yyval.relation_list)->insert((yyval.relation_list)->begin(), (yyvsp[-2].string));
+      free((yyvsp[-2].string));
+    }
+#line 1944 "yacc_sql.cpp"
+    break;
+
+  case 41: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 375 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -1834,44 +1952,71 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 1838 "yacc_sql.cpp"
+#line 1956 "yacc_sql.cpp"
     break;
 
-  case 34: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format  */
-#line 301 "yacc_sql.y"
+  case 42: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE opt_cluster_by storage_format  */
+#line 385 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name = (yyvsp[-5].string);
-      free((yyvsp[-5].string));
+      create_table.relation_name = (yyvsp[-6].string);
+      free((yyvsp[-6].string));
 
-      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-2].attr_infos);
+      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-3].attr_infos);
 
       if (src_attrs != nullptr) {
         create_table.attr_infos.swap(*src_attrs);
         delete src_attrs;
       }
-      create_table.attr_infos.emplace_back(*(yyvsp[-3].attr_info));
+      create_table.attr_infos.emplace_back(*(yyvsp[-4].attr_info));
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
-      delete (yyvsp[-3].attr_info);
+      delete (yyvsp[-4].attr_info);
+      if ((yyvsp[-1].relation_list) != nullptr) {
+        create_table.cluster_names.swap(*(yyvsp[-1].relation_list));
+        delete (yyvsp[-1].relation_list);
+      }
       if ((yyvsp[0].string) != nullptr) {
         create_table.storage_format = (yyvsp[0].string);
         free((yyvsp[0].string));
       }
     }
-#line 1863 "yacc_sql.cpp"
+#line 1985 "yacc_sql.cpp"
+    break;
+
+  case 43: /* opt_cluster_by: %empty  */
+#line 414 "yacc_sql.y"
+    {
+      (yyval.relation_list) = nullptr;
+    }
+#line 1993 "yacc_sql.cpp"
+    break;
+
+  case 44: /* opt_cluster_by: ID BY LBRACE attr_name_list RBRACE  */
+#line 418 "yacc_sql.y"
+    {
+      if (0 != strcasecmp((yyvsp[-4].string), "cluster")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect CLUSTER BY");
+        free((yyvsp[-4].string));
+        delete (yyvsp[-1].relation_list);
+        YYERROR;
+      }
+      (yyval.relation_list) = (yyvsp[-1].relation_list);
+      free((yyvsp[-4].string));
+    }
+#line 2008 "yacc_sql.cpp"
     break;
 
-  case 35: /* attr_def_list: %empty  */
-#line 324 "yacc_sql.y"
+  case 45: /* attr_def_list: %empty  */
+#line 431 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1871 "yacc_sql.cpp"
+#line 2016 "yacc_sql.cpp"
     break;
 
-  case 36: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 328 "yacc_sql.y"
+  case 46: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 435 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -1881,11 +2026,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 1885 "yacc_sql.cpp"
+#line 2030 "yacc_sql.cpp"
     break;
 
-  case 37: /* attr_def: ID type LBRACE number RBRACE  */
-#line 341 "yacc_sql.y"
+  case 47: /* attr_def: ID type LBRACE number RBRACE  */
+#line 448 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-3].number);
@@ -1893,11 +2038,11 @@ yyreduce:
       (yyval.attr_info)->length = (yyvsp[-1].number);
       free((yyvsp[-4].string));
     }
-#line 1897 "yacc_sql.cpp"
+#line 2042 "yacc_sql.cpp"
     break;
 
-  case 38: /* attr_def: ID type  */
-#line 349 "yacc_sql.y"
+  case 48: /* attr_def: ID type  */
+#line 456 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[0].number);
@@ -1905,41 +2050,41 @@ yyreduce:
       (yyval.attr_info)->length = 4;
       free((yyvsp[-1].string));
     }
-#line 1909 "yacc_sql.cpp"
+#line 2054 "yacc_sql.cpp"
     break;
 
-  case 39: /* number: NUMBER  */
-#line 358 "yacc_sql.y"
+  case 49: /* number: NUMBER  */
+#line 465 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 1915 "yacc_sql.cpp"
+#line 2060 "yacc_sql.cpp"
     break;
 
-  case 40: /* type: INT_T  */
-#line 361 "yacc_sql.y"
+  case 50: /* type: INT_T  */
+#line 468 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::INTS); }
-#line 1921 "yacc_sql.cpp"
+#line 2066 "yacc_sql.cpp"
     break;
 
-  case 41: /* type: STRING_T  */
-#line 362 "yacc_sql.y"
+  case 51: /* type: STRING_T  */
+#line 469 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::CHARS); }
-#line 1927 "yacc_sql.cpp"
+#line 2072 "yacc_sql.cpp"
     break;
 
-  case 42: /* type: FLOAT_T  */
-#line 363 "yacc_sql.y"
+  case 52: /* type: FLOAT_T  */
+#line 470 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::FLOATS); }
-#line 1933 "yacc_sql.cpp"
+#line 2078 "yacc_sql.cpp"
     break;
 
-  case 43: /* type: VECTOR_T  */
-#line 364 "yacc_sql.y"
+  case 53: /* type: VECTOR_T  */
+#line 471 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::VECTORS); }
-#line 1939 "yacc_sql.cpp"
+#line 2084 "yacc_sql.cpp"
     break;
 
-  case 44: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
-#line 368 "yacc_sql.y"
+  case 54: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
+#line 475 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-5].string);
@@ -1952,19 +2097,19 @@ yyreduce:
       delete (yyvsp[-2].value);
       free((yyvsp[-5].string));
     }
-#line 1956 "yacc_sql.cpp"
+#line 2101 "yacc_sql.cpp"
     break;
 
-  case 45: /* value_list: %empty  */
-#line 384 "yacc_sql.y"
+  case 55: /* value_list: %empty  */
+#line 491 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 1964 "yacc_sql.cpp"
+#line 2109 "yacc_sql.cpp"
     break;
 
-  case 46: /* value_list: COMMA value value_list  */
-#line 387 "yacc_sql.y"
+  case 56: /* value_list: COMMA value value_list  */
+#line 494 "yacc_sql.y"
                               { 
       if ((yyvsp[0].value_list) != nullptr) {
         (yyval.value_list) = (yyvsp[0].value_list);
@@ -1974,56 +2119,56 @@ yyreduce:
       (yyval.value_list)->emplace_back(*(yyvsp[-1].value));
       delete (yyvsp[-1].value);
     }
-#line 1978 "yacc_sql.cpp"
+#line 2123 "yacc_sql.cpp"
     break;
 
-  case 47: /* value: NUMBER  */
-#line 398 "yacc_sql.y"
+  case 57: /* value: NUMBER  */
+#line 505 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 1987 "yacc_sql.cpp"
+#line 2132 "yacc_sql.cpp"
     break;
 
-  case 48: /* value: FLOAT  */
-#line 402 "yacc_sql.y"
+  case 58: /* value: FLOAT  */
+#line 509 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 1996 "yacc_sql.cpp"
+#line 2141 "yacc_sql.cpp"
     break;
 
-  case 49: /* value: SSS  */
-#line 406 "yacc_sql.y"
+  case 59: /* value: SSS  */
+#line 513 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
       free((yyvsp[0].string));
     }
-#line 2007 "yacc_sql.cpp"
+#line 2152 "yacc_sql.cpp"
     break;
 
-  case 50: /* storage_format: %empty  */
-#line 415 "yacc_sql.y"
+  case 60: /* storage_format: %empty  */
+#line 522 "yacc_sql.y"
     {
       (yyval.string) = nullptr;
     }
-#line 2015 "yacc_sql.cpp"
+#line 2160 "yacc_sql.cpp"
     break;
 
-  case 51: /* storage_format: STORAGE FORMAT EQ ID  */
-#line 419 "yacc_sql.y"
+  case 61: /* storage_format: STORAGE FORMAT EQ ID  */
+#line 526 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2023 "yacc_sql.cpp"
+#line 2168 "yacc_sql.cpp"
     break;
 
-  case 52: /* delete_stmt: DELETE FROM ID where  */
-#line 426 "yacc_sql.y"
+  case 62: /* delete_stmt: DELETE FROM ID where  */
+#line 533 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2033,11 +2178,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2037 "yacc_sql.cpp"
+#line 2182 "yacc_sql.cpp"
     break;
 
-  case 53: /* update_stmt: UPDATE ID SET ID EQ value where  */
-#line 438 "yacc_sql.y"
+  case 63: /* update_stmt: UPDATE ID SET ID EQ value where  */
+#line 545 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-5].string);
@@ -2050,11 +2195,11 @@ yyreduce:
       free((yyvsp[-5].string));
       free((yyvsp[-3].string));
     }
-#line 2054 "yacc_sql.cpp"
+#line 2199 "yacc_sql.cpp"
     break;
 
-  case 54: /* select_stmt: SELECT expression_list FROM rel_list where group_by  */
-#line 453 "yacc_sql.y"
+  case 64: /* select_stmt: SELECT expression_list FROM rel_list where group_by  */
+#line 560 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[-4].expression_list) != nullptr) {
@@ -2077,30 +2222,30 @@ yyreduce:
         delete (yyvsp[0].expression_list);
       }
     }
-#line 2081 "yacc_sql.cpp"
+#line 2226 "yacc_sql.cpp"
     break;
 
-  case 55: /* calc_stmt: CALC expression_list  */
-#line 478 "yacc_sql.y"
+  case 65: /* calc_stmt: CALC expression_list  */
+#line 585 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2091 "yacc_sql.cpp"
+#line 2236 "yacc_sql.cpp"
     break;
 
-  case 56: /* expression_list: expression  */
-#line 487 "yacc_sql.y"
+  case 66: /* expression_list: expression  */
+#line 594 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<std::unique_ptr<Expression>>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2100 "yacc_sql.cpp"
+#line 2245 "yacc_sql.cpp"
     break;
 
-  case 57: /* expression_list: expression COMMA expression_list  */
-#line 492 "yacc_sql.y"
+  case 67: /* expression_list: expression COMMA expression_list  */
+#line 599 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2109,99 +2254,108 @@ yyreduce:
       }
       (yyval.expression_list)->emplace((yyval.expression_list)->begin(), (yyvsp[-2].expression));
     }
-#line 2113 "yacc_sql.cpp"
+#line 2258 "yacc_sql.cpp"
     break;
 
-  case 58: /* expression: expression '+' expression  */
-#line 502 "yacc_sql.y"
+  case 68: /* expression: expression '+' expression  */
+#line 609 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2121 "yacc_sql.cpp"
+#line 2266 "yacc_sql.cpp"
     break;
 
-  case 59: /* expression: expression '-' expression  */
-#line 505 "yacc_sql.y"
+  case 69: /* expression: expression '-' expression  */
+#line 612 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2129 "yacc_sql.cpp"
+#line 2274 "yacc_sql.cpp"
     break;
 
-  case 60: /* expression: expression '*' expression  */
-#line 508 "yacc_sql.y"
+  case 70: /* expression: expression '*' expression  */
+#line 615 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2137 "yacc_sql.cpp"
+#line 2282 "yacc_sql.cpp"
     break;
 
-  case 61: /* expression: expression '/' expression  */
-#line 511 "yacc_sql.y"
+  case 71: /* expression: expression '/' expression  */
+#line 618 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2145 "yacc_sql.cpp"
+#line 2290 "yacc_sql.cpp"
     break;
 
-  case 62: /* expression: LBRACE expression RBRACE  */
-#line 514 "yacc_sql.y"
+  case 72: /* expression: LBRACE expression RBRACE  */
+#line 621 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2154 "yacc_sql.cpp"
+#line 2299 "yacc_sql.cpp"
     break;
 
-  case 63: /* expression: '-' expression  */
-#line 518 "yacc_sql.y"
+  case 73: /* expression: '-' expression  */
+#line 625 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2162 "yacc_sql.cpp"
+#line 2307 "yacc_sql.cpp"
     break;
 
-  case 64: /* expression: value  */
-#line 521 "yacc_sql.y"
+  case 74: /* expression: value  */
+#line 628 "yacc_sql.y"
             {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 2172 "yacc_sql.cpp"
+#line 2317 "yacc_sql.cpp"
     break;
 
-  case 65: /* expression: rel_attr  */
-#line 526 "yacc_sql.y"
+  case 75: /* expression: rel_attr  */
+#line 633 "yacc_sql.y"
                {
       RelAttrSqlNode *node = (yyvsp[0].rel_attr);
       (yyval.expression) = new UnboundFieldExpr(node->relation_name, node->attribute_name);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].rel_attr);
     }
-#line 2183 "yacc_sql.cpp"
+#line 2328 "yacc_sql.cpp"
     break;
 
-  case 66: /* expression: '*'  */
-#line 532 "yacc_sql.y"
+  case 76: /* expression: '*'  */
+#line 639 "yacc_sql.y"
           {
       (yyval.expression) = new StarExpr();
     }
-#line 2191 "yacc_sql.cpp"
+#line 2336 "yacc_sql.cpp"
     break;
 
-  case 67: /* rel_attr: ID  */
-#line 539 "yacc_sql.y"
+  case 77: /* expression: ID LBRACE expression RBRACE  */
+#line 642 "yacc_sql.y"
+                                  {
+      (yyval.expression) = create_aggregate_expression((yyvsp[-3].string), (yyvsp[-1].expression), sql_string, &(yyloc));
+      free((yyvsp[-3].string));
+    }
+#line 2345 "yacc_sql.cpp"
+    break;
+
+  case 78: /* rel_attr: ID  */
+#line 650 "yacc_sql.y"
        {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2201 "yacc_sql.cpp"
+#line 2355 "yacc_sql.cpp"
     break;
 
-  case 68: /* rel_attr: ID DOT ID  */
-#line 544 "yacc_sql.y"
+  case 79: /* rel_attr: ID DOT ID  */
+#line 655 "yacc_sql.y"
                 {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
@@ -2209,29 +2363,29 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2213 "yacc_sql.cpp"
+#line 2367 "yacc_sql.cpp"
     break;
 
-  case 69: /* relation: ID  */
-#line 554 "yacc_sql.y"
+  case 80: /* relation: ID  */
+#line 665 "yacc_sql.y"
        {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2221 "yacc_sql.cpp"
+#line 2375 "yacc_sql.cpp"
     break;
 
-  case 70: /* rel_list: relation  */
-#line 559 "yacc_sql.y"
+  case 81: /* rel_list: relation  */
+#line 670 "yacc_sql.y"
              {
       (yyval.relation_list) = new std::vector<std::string>();
       (yyval.relation_list)->push_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 2231 "yacc_sql.cpp"
+#line 2385 "yacc_sql.cpp"
     break;
 
-  case 71: /* rel_list: relation COMMA rel_list  */
-#line 564 "yacc_sql.y"
+  case 82: /* rel_list: relation COMMA rel_list  */
+#line 675 "yacc_sql.y"
                               {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
@@ -2242,55 +2396,55 @@ yyreduce:
       (yyval.relation_list)->insert((yyval.relation_list)->begin(), (yyvsp[-2].string));
       free((yyvsp[-2].string));
     }
-#line 2246 "yacc_sql.cpp"
+#line 2400 "yacc_sql.cpp"
     break;
 
-  case 72: /* where: %empty  */
-#line 578 "yacc_sql.y"
+  case 83: /* where: %empty  */
+#line 689 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2254 "yacc_sql.cpp"
+#line 2408 "yacc_sql.cpp"
     break;
 
-  case 73: /* where: WHERE condition_list  */
-#line 581 "yacc_sql.y"
+  case 84: /* where: WHERE condition_list  */
+#line 692 "yacc_sql.y"
                            {
       (yyval.condition_list) = (yyvsp[0].condition_list);  
     }
-#line 2262 "yacc_sql.cpp"
+#line 2416 "yacc_sql.cpp"
     break;
 
-  case 74: /* condition_list: %empty  */
-#line 587 "yacc_sql.y"
+  case 85: /* condition_list: %empty  */
+#line 698 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2270 "yacc_sql.cpp"
+#line 2424 "yacc_sql.cpp"
     break;
 
-  case 75: /* condition_list: condition  */
-#line 590 "yacc_sql.y"
+  case 86: /* condition_list: condition  */
+#line 701 "yacc_sql.y"
                 {
       (yyval.condition_list) = new std::vector<ConditionSqlNode>;
       (yyval.condition_list)->emplace_back(*(yyvsp[0].condition));
       delete (yyvsp[0].condition);
     }
-#line 2280 "yacc_sql.cpp"
+#line 2434 "yacc_sql.cpp"
     break;
 
-  case 76: /* condition_list: condition AND condition_list  */
-#line 595 "yacc_sql.y"
+  case 87: /* condition_list: condition AND condition_list  */
+#line 706 "yacc_sql.y"
                                    {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->emplace_back(*(yyvsp[-2].condition));
       delete (yyvsp[-2].condition);
     }
-#line 2290 "yacc_sql.cpp"
+#line 2444 "yacc_sql.cpp"
     break;
 
-  case 77: /* condition: rel_attr comp_op value  */
-#line 603 "yacc_sql.y"
+  case 88: /* condition: rel_attr comp_op value  */
+#line 714 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2302,11 +2456,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].value);
     }
-#line 2306 "yacc_sql.cpp"
+#line 2460 "yacc_sql.cpp"
     break;
 
-  case 78: /* condition: value comp_op value  */
-#line 615 "yacc_sql.y"
+  case 89: /* condition: value comp_op value  */
+#line 726 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2318,11 +2472,11 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].value);
     }
-#line 2322 "yacc_sql.cpp"
+#line 2476 "yacc_sql.cpp"
     break;
 
-  case 79: /* condition: rel_attr comp_op rel_attr  */
-#line 627 "yacc_sql.y"
+  case 90: /* condition: rel_attr comp_op rel_attr  */
+#line 738 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2334,11 +2488,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].rel_attr);
     }
-#line 2338 "yacc_sql.cpp"
+#line 2492 "yacc_sql.cpp"
     break;
 
-  case 80: /* condition: value comp_op rel_attr  */
-#line 639 "yacc_sql.y"
+  case 91: /* condition: value comp_op rel_attr  */
+#line 750 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2350,55 +2504,55 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].rel_attr);
     }
-#line 2354 "yacc_sql.cpp"
+#line 2508 "yacc_sql.cpp"
     break;
 
-  case 81: /* comp_op: EQ  */
-#line 653 "yacc_sql.y"
+  case 92: /* comp_op: EQ  */
+#line 764 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 2360 "yacc_sql.cpp"
+#line 2514 "yacc_sql.cpp"
     break;
 
-  case 82: /* comp_op: LT  */
-#line 654 "yacc_sql.y"
+  case 93: /* comp_op: LT  */
+#line 765 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 2366 "yacc_sql.cpp"
+#line 2520 "yacc_sql.cpp"
     break;
 
-  case 83: /* comp_op: GT  */
-#line 655 "yacc_sql.y"
+  case 94: /* comp_op: GT  */
+#line 766 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 2372 "yacc_sql.cpp"
+#line 2526 "yacc_sql.cpp"
     break;
 
-  case 84: /* comp_op: LE  */
-#line 656 "yacc_sql.y"
+  case 95: /* comp_op: LE  */
+#line 767 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 2378 "yacc_sql.cpp"
+#line 2532 "yacc_sql.cpp"
     break;
 
-  case 85: /* comp_op: GE  */
-#line 657 "yacc_sql.y"
+  case 96: /* comp_op: GE  */
+#line 768 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 2384 "yacc_sql.cpp"
+#line 2538 "yacc_sql.cpp"
     break;
 
-  case 86: /* comp_op: NE  */
-#line 658 "yacc_sql.y"
+  case 97: /* comp_op: NE  */
+#line 769 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 2390 "yacc_sql.cpp"
+#line 2544 "yacc_sql.cpp"
     break;
 
-  case 87: /* group_by: %empty  */
-#line 664 "yacc_sql.y"
+  case 98: /* group_by: %empty  */
+#line 775 "yacc_sql.y"
     {
       (yyval.expression_list) = nullptr;
     }
-#line 2398 "yacc_sql.cpp"
+#line 2552 "yacc_sql.cpp"
     break;
 
-  case 88: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
-#line 670 "yacc_sql.y"
+  case 99: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 781 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -2408,20 +2562,20 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 2412 "yacc_sql.cpp"
+#line 2566 "yacc_sql.cpp"
     break;
 
-  case 89: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 683 "yacc_sql.y"
+  case 100: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 794 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 2421 "yacc_sql.cpp"
+#line 2575 "yacc_sql.cpp"
     break;
 
-  case 90: /* set_variable_stmt: SET ID EQ value  */
-#line 691 "yacc_sql.y"
+  case 101: /* set_variable_stmt: SET ID EQ value  */
+#line 802 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -2429,11 +2583,11 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2433 "yacc_sql.cpp"
+#line 2587 "yacc_sql.cpp"
     break;
 
 
-#line 2437 "yacc_sql.cpp"
+#line 2591 "yacc_sql.cpp"
 
       default: break;
     }
@@ -2662,7 +2816,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 703 "yacc_sql.y"
+#line 814 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
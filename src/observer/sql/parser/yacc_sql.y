@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <algorithm>
 
 #include "common/log/log.h"
@@ -144,6 +145,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <condition>           condition
 %type <value>               value
 %type <number>              number
+%type <number>              opt_unique
 %type <string>              relation
 %type <comp>                comp_op
 %type <rel_attr>            rel_attr
@@ -154,6 +156,10 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <condition_list>      condition_list
 %type <string>              storage_format
 %type <relation_list>       rel_list
+%type <relation_list>       attr_name_list
+%type <relation_list>       opt_index_include
+%type <relation_list>       opt_cluster_by
+%type <string>              opt_index_using
 %type <expression>          expression
 %type <expression_list>     expression_list
 %type <expression_list>     group_by
@@ -273,16 +279,94 @@ desc_table_stmt:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE ID RBRACE
+    CREATE opt_unique INDEX ID ON ID opt_index_using LBRACE attr_name_list RBRACE opt_index_include
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
-      create_index.index_name = $3;
-      create_index.relation_name = $5;
-      create_index.attribute_name = $7;
-      free($3);
-      free($5);
-      free($7);
+      create_index.unique = ($2 != 0);
+      create_index.index_name = $4;
+      create_index.relation_name = $6;
+      if ($7 != nullptr) {
+        create_index.index_type = $7;
+        free($7);
+      }
+      create_index.attribute_names.swap(*$9);
+      if ($11 != nullptr) {
+        create_index.include_names.swap(*$11);
+        delete $11;
+      }
+      free($4);
+      free($6);
+      delete $9;
+    }
+    ;
+
+/* USING 也按照标识符解析，索引类型的名字在创建语句时再检查 */
+opt_index_using:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID ID
+    {
+      if (0 != strcasecmp($1, "using")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect USING");
+        free($1);
+        free($2);
+        YYERROR;
+      }
+      $$ = $2;
+      free($1);
+    }
+    ;
+
+/* 与 INCLUDE 一样，UNIQUE 也按照标识符解析 */
+opt_unique:
+    /* empty */
+    {
+      $$ = 0;
+    }
+    | ID
+    {
+      if (0 != strcasecmp($1, "unique")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect UNIQUE");
+        free($1);
+        YYERROR;
+      }
+      $$ = 1;
+      free($1);
+    }
+    ;
+
+/* INCLUDE 不是保留字，按照标识符解析，避免影响用 include 做名字的表和字段 */
+opt_index_include:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID LBRACE attr_name_list RBRACE
+    {
+      if (0 != strcasecmp($1, "include")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect INCLUDE");
+        free($1);
+        delete $3;
+        YYERROR;
+      }
+      $$ = $3;
+      free($1);
+    }
+    ;
+
+attr_name_list:
+    ID {
+      $$ = new std::vector<std::string>();
+      $$->push_back($1);
+      free($1);
+    }
+    | ID COMMA attr_name_list {
+      $$ = $3;
+      $$->insert($$->begin(), $1);
+      free($1);
     }
     ;
 
@@ -297,7 +381,7 @@ drop_index_stmt:      /*drop index 语句的语法解析树*/
     }
     ;
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format
+    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE opt_cluster_by storage_format
     {
       $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = $$->create_table;
@@ -314,9 +398,32 @@ create_table_stmt:    /*create table 语句的语法解析树*/
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete $5;
       if ($8 != nullptr) {
-        create_table.storage_format = $8;
-        free($8);
+        create_table.cluster_names.swap(*$8);
+        delete $8;
+      }
+      if ($9 != nullptr) {
+        create_table.storage_format = $9;
+        free($9);
+      }
+    }
+    ;
+
+/* CLUSTER 也按照标识符解析，参考 opt_index_include */
+opt_cluster_by:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID BY LBRACE attr_name_list RBRACE
+    {
+      if (0 != strcasecmp($1, "cluster")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect CLUSTER BY");
+        free($1);
+        delete $4;
+        YYERROR;
       }
+      $$ = $4;
+      free($1);
     }
     ;
 attr_def_list:
@@ -532,6 +639,10 @@ expression:
     | '*' {
       $$ = new StarExpr();
     }
+    | ID LBRACE expression RBRACE {
+      $$ = create_aggregate_expression($1, $3, sql_string, &@$);
+      free($1);
+    }
     // your code here
     ;
 
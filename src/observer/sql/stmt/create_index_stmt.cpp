@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/stmt/create_index_stmt.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "storage/db/db.h"
@@ -26,10 +27,9 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
   stmt = nullptr;
 
   const char *table_name = create_index.relation_name.c_str();
-  if (is_blank(table_name) || is_blank(create_index.index_name.c_str()) ||
-      is_blank(create_index.attribute_name.c_str())) {
-    LOG_WARN("invalid argument. db=%p, table_name=%p, index name=%s, attribute name=%s",
-        db, table_name, create_index.index_name.c_str(), create_index.attribute_name.c_str());
+  if (is_blank(table_name) || is_blank(create_index.index_name.c_str()) || create_index.attribute_names.empty()) {
+    LOG_WARN("invalid argument. db=%p, table_name=%p, index name=%s, attribute num=%d",
+        db, table_name, create_index.index_name.c_str(), static_cast<int>(create_index.attribute_names.size()));
     return RC::INVALID_ARGUMENT;
   }
 
@@ -40,11 +40,46 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
-  const FieldMeta *field_meta = table->table_meta().field(create_index.attribute_name.c_str());
-  if (nullptr == field_meta) {
-    LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", 
-             db->name(), table_name, create_index.attribute_name.c_str());
-    return RC::SCHEMA_FIELD_NOT_EXIST;
+  // 键值字段和包含字段都不能重复出现
+  vector<const FieldMeta *> all_field_metas;
+  auto resolve_fields = [&](const vector<string> &attribute_names, vector<const FieldMeta *> &field_metas) {
+    for (const string &attribute_name : attribute_names) {
+      const FieldMeta *field_meta = table->table_meta().field(attribute_name.c_str());
+      if (nullptr == field_meta) {
+        LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", 
+                 db->name(), table_name, attribute_name.c_str());
+        return RC::SCHEMA_FIELD_NOT_EXIST;
+      }
+
+      if (find(all_field_metas.begin(), all_field_metas.end(), field_meta) != all_field_metas.end()) {
+        LOG_WARN("duplicate field in index. db=%s, table=%s, field name=%s",
+                 db->name(), table_name, attribute_name.c_str());
+        return RC::INVALID_ARGUMENT;
+      }
+      all_field_metas.push_back(field_meta);
+      field_metas.push_back(field_meta);
+    }
+    return RC::SUCCESS;
+  };
+
+  vector<const FieldMeta *> field_metas;
+  vector<const FieldMeta *> include_field_metas;
+  RC                        rc = resolve_fields(create_index.attribute_names, field_metas);
+  if (OB_SUCC(rc)) {
+    rc = resolve_fields(create_index.include_names, include_field_metas);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  IndexType index_type = IndexType::BPLUS_TREE;
+  if (!create_index.index_type.empty() && OB_FAIL(index_type_from_string(create_index.index_type.c_str(), index_type))) {
+    LOG_WARN("unknown index type. index=%s, type=%s", create_index.index_name.c_str(), create_index.index_type.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (index_type == IndexType::HASH && !include_field_metas.empty()) {
+    LOG_WARN("hash index does not support include fields. index=%s", create_index.index_name.c_str());
+    return RC::UNSUPPORTED;
   }
 
   Index *index = table->find_index(create_index.index_name.c_str());
@@ -53,6 +88,8 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, field_meta, create_index.index_name);
+  stmt = new CreateIndexStmt(
+      table, std::move(field_metas), create_index.index_name, std::move(include_field_metas), create_index.unique,
+      index_type);
   return RC::SUCCESS;
 }
@@ -15,8 +15,10 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "sql/stmt/stmt.h"
+#include "storage/index/index_meta.h"
 
 struct CreateIndexSqlNode;
 class Table;
@@ -29,23 +31,36 @@ class FieldMeta;
 class CreateIndexStmt : public Stmt
 {
 public:
-  CreateIndexStmt(Table *table, const FieldMeta *field_meta, const std::string &index_name)
-      : table_(table), field_meta_(field_meta), index_name_(index_name)
+  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> field_metas, const std::string &index_name,
+      std::vector<const FieldMeta *> include_field_metas = {}, bool unique = false,
+      IndexType index_type = IndexType::BPLUS_TREE)
+      : table_(table),
+        field_metas_(std::move(field_metas)),
+        include_field_metas_(std::move(include_field_metas)),
+        index_name_(index_name),
+        unique_(unique),
+        index_type_(index_type)
   {}
 
   virtual ~CreateIndexStmt() = default;
 
   StmtType type() const override { return StmtType::CREATE_INDEX; }
 
-  Table             *table() const { return table_; }
-  const FieldMeta   *field_meta() const { return field_meta_; }
-  const std::string &index_name() const { return index_name_; }
+  Table                                *table() const { return table_; }
+  const std::vector<const FieldMeta *> &field_metas() const { return field_metas_; }
+  const std::vector<const FieldMeta *> &include_field_metas() const { return include_field_metas_; }
+  const std::string                    &index_name() const { return index_name_; }
+  bool                                  unique() const { return unique_; }
+  IndexType                             index_type() const { return index_type_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
 
 private:
-  Table           *table_      = nullptr;
-  const FieldMeta *field_meta_ = nullptr;
-  std::string      index_name_;
+  Table                         *table_ = nullptr;
+  std::vector<const FieldMeta *> field_metas_;          ///< 索引包含的字段，按照键值中的顺序排列
+  std::vector<const FieldMeta *> include_field_metas_;  ///< INCLUDE 的字段，不参与键值比较
+  std::string                    index_name_;
+  bool                           unique_ = false;  ///< 是否是唯一索引
+  IndexType                      index_type_ = IndexType::BPLUS_TREE;  ///< USING 指定的索引类型
 };
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/6/13.
 //
 
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "common/types.h"
 #include "sql/stmt/create_table_stmt.h"
@@ -28,7 +29,27 @@ RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt
   if (storage_format == StorageFormat::UNKNOWN_FORMAT) {
     return RC::INVALID_ARGUMENT;
   }
-  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos, storage_format);
+
+  // 聚簇键的字段必须是表中的字段，而且不能重复
+  for (size_t i = 0; i < create_table.cluster_names.size(); i++) {
+    const std::string &cluster_name = create_table.cluster_names[i];
+    auto               iter         = std::find_if(create_table.attr_infos.begin(), create_table.attr_infos.end(),
+        [&cluster_name](const AttrInfoSqlNode &attr_info) { return attr_info.name == cluster_name; });
+    if (iter == create_table.attr_infos.end()) {
+      LOG_WARN("no such field in cluster key. table=%s, field=%s",
+               create_table.relation_name.c_str(), cluster_name.c_str());
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+    if (std::find(create_table.cluster_names.begin(), create_table.cluster_names.begin() + i, cluster_name) !=
+        create_table.cluster_names.begin() + i) {
+      LOG_WARN("duplicate field in cluster key. table=%s, field=%s",
+               create_table.relation_name.c_str(), cluster_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  stmt = new CreateTableStmt(
+      create_table.relation_name, create_table.attr_infos, create_table.cluster_names, storage_format);
   sql_debug("create table statement: table name %s", create_table.relation_name.c_str());
   return RC::SUCCESS;
 }
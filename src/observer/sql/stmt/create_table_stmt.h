@@ -29,9 +29,9 @@ class Db;
 class CreateTableStmt : public Stmt
 {
 public:
-  CreateTableStmt(
-      const std::string &table_name, const std::vector<AttrInfoSqlNode> &attr_infos, StorageFormat storage_format)
-      : table_name_(table_name), attr_infos_(attr_infos), storage_format_(storage_format)
+  CreateTableStmt(const std::string &table_name, const std::vector<AttrInfoSqlNode> &attr_infos,
+      const std::vector<std::string> &cluster_names, StorageFormat storage_format)
+      : table_name_(table_name), attr_infos_(attr_infos), cluster_names_(cluster_names), storage_format_(storage_format)
   {}
   virtual ~CreateTableStmt() = default;
 
@@ -39,6 +39,7 @@ public:
 
   const std::string                  &table_name() const { return table_name_; }
   const std::vector<AttrInfoSqlNode> &attr_infos() const { return attr_infos_; }
+  const std::vector<std::string>     &cluster_names() const { return cluster_names_; }
   const StorageFormat                 storage_format() const { return storage_format_; }
 
   static RC            create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt);
@@ -47,5 +48,6 @@ public:
 private:
   std::string                  table_name_;
   std::vector<AttrInfoSqlNode> attr_infos_;
+  std::vector<std::string>     cluster_names_;  ///< 聚簇键的字段，参考 TableMeta::cluster_index
   StorageFormat                storage_format_;
 };
\ No newline at end of file
@@ -40,6 +40,11 @@ public:
     return &column(idx);
   }
 
+  /**
+   * @brief 返回 field id 为 `col_id` 的列在 chunk 中的下标，找不到时返回 -1
+   */
+  int column_index(int col_id) const;
+
   int column_ids(size_t i)
   {
     ASSERT(i < column_ids_.size(), "invalid column index");
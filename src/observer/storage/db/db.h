@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/unordered_map.h"
 #include "common/lang/memory.h"
 #include "common/lang/span.h"
+#include "common/lang/mutex.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/clog/disk_log_handler.h"
@@ -62,9 +63,10 @@ public:
    * @param table_name 表名
    * @param attributes 表的属性
    * @param storage_format 表的存储格式
+   * @param cluster_fields 聚簇键的字段，为空时不是聚簇表，参考 TableMeta::cluster_index
    */
   RC create_table(const char *table_name, span<const AttrInfoSqlNode> attributes,
-      const StorageFormat storage_format = StorageFormat::ROW_FORMAT);
+      const StorageFormat storage_format = StorageFormat::ROW_FORMAT, span<const string> cluster_fields = {});
 
   /**
    * @brief 根据表名查找表
@@ -96,6 +98,13 @@ public:
   /// @brief 获取当前数据库的事务管理器
   TrxKit &trx_kit();
 
+  /**
+   * @brief 前台语句与后台任务之间的锁
+   * @details 执行语句时持有共享锁，后台任务(比如页面整理)修改记录位置时持有排他锁。
+   * 语句可能会在页面锁之外保存记录的RID，比如删除时先收集记录再逐条删除。
+   */
+  shared_mutex &background_latch() { return background_latch_; }
+
 private:
   /// @brief 打开所有的表。在数据库初始化的时候会执行
   RC open_all_tables();
@@ -122,4 +131,6 @@ private:
   int32_t next_table_id_ = 0;
 
   LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+
+  shared_mutex background_latch_;  ///< 前台语句与后台任务之间的锁
 };
@@ -16,6 +16,9 @@ See the Mulan PSL v2 for more details. */
 #include <span>
 
 #include "storage/index/bplus_tree.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/defer.h"
+#include "common/lang/limits.h"
 #include "common/lang/lower_bound.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
@@ -31,17 +34,19 @@ using namespace common;
  */
 #define FIRST_INDEX_PAGE 1
 
+// 预留了键值压缩格式的头部，这样完全不能压缩的时候也能放下这么多元素
 int calc_internal_page_capacity(int attr_length)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
+  int capacity =
+      ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE - IndexNodeKeyLayout::HEADER_SIZE) / item_size;
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int include_length)
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
+  int item_size = attr_length + sizeof(RID) + sizeof(RID) + include_length;
+  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - IndexNodeKeyLayout::HEADER_SIZE) / item_size;
   return capacity;
 }
 
@@ -56,6 +61,7 @@ void IndexNodeHandler::init_empty(bool leaf)
   node_->is_leaf = leaf;
   node_->key_num = 0;
   node_->parent  = BP_INVALID_PAGE_NUM;
+  reset_layout();
 }
 PageNum IndexNodeHandler::page_num() const { return frame_->page_num(); }
 
@@ -63,8 +69,7 @@ int IndexNodeHandler::key_size() const { return header_.key_length; }
 
 int IndexNodeHandler::value_size() const
 {
-  // return header_.value_size;
-  return sizeof(RID);
+  return is_leaf() ? sizeof(RID) + header_.include_length : sizeof(PageNum);
 }
 
 int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
@@ -159,26 +164,383 @@ bool IndexNodeHandler::validate() const
   return true;
 }
 
-RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
+int IndexNodeHandler::header_size() const
+{
+  if (!is_leaf()) {
+    return InternalIndexNode::HEADER_SIZE;
+  }
+  return header_.prev_leaf_links != 0 ? LeafIndexNode::HEADER_SIZE : LeafIndexNode::NO_PREV_HEADER_SIZE;
+}
+
+char *IndexNodeHandler::node_array() const { return reinterpret_cast<char *>(node_) + header_size(); }
+
+IndexNodeHandler::KeyLayout IndexNodeHandler::key_layout() const
+{
+  if (!key_compressed()) {
+    return KeyLayout{0, header_.attr_length};
+  }
+
+  const auto *layout = reinterpret_cast<const IndexNodeKeyLayout *>(node_array());
+  return KeyLayout{layout->prefix_len, layout->key_end};
+}
+
+const char *IndexNodeHandler::prefix() const { return reinterpret_cast<const IndexNodeKeyLayout *>(node_array())->prefix; }
+
+void IndexNodeHandler::reset_layout()
+{
+  if (key_compressed()) {
+    auto *layout       = reinterpret_cast<IndexNodeKeyLayout *>(node_array());
+    layout->prefix_len = 0;
+    layout->key_end    = 0;
+  }
+}
+
+IndexNodeHandler::KeyLayout IndexNodeHandler::key_layout_of(const char *key) const
+{
+  KeyLayout layout{header_.attr_length, 0};
+  for (int i = header_.attr_length; i > 0; i--) {
+    if (key[i - 1] != 0) {
+      layout.key_end = i;
+      break;
+    }
+  }
+  return layout;
+}
+
+IndexNodeHandler::KeyLayout IndexNodeHandler::merge_key_layout(
+    const KeyLayout &layout, const char *prefix, const char *key) const
+{
+  KeyLayout result{0, max(layout.key_end, key_layout_of(key).key_end)};
+  while (result.prefix_len < layout.prefix_len && prefix[result.prefix_len] == key[result.prefix_len]) {
+    result.prefix_len++;
+  }
+  return result;
+}
+
+int IndexNodeHandler::capacity(const KeyLayout &layout) const
+{
+  const int max_size = this->max_size();
+  if (!key_compressed()) {
+    return max_size;
+  }
+
+  const int space = (int)BP_PAGE_DATA_SIZE - header_size() - IndexNodeKeyLayout::HEADER_SIZE - layout.prefix_len;
+  // 节点分裂后，每一半再插入一个元素时，即使完全不能压缩也要放得下
+  return min(space / stored_item_size(layout), max(max_size, 2 * (max_size - 1)));
+}
+
+int IndexNodeHandler::stored_key_size(const KeyLayout &layout) const
+{
+  return max(layout.prefix_len, layout.key_end) - layout.prefix_len + (key_size() - header_.attr_length);
+}
+
+int IndexNodeHandler::stored_item_size(const KeyLayout &layout) const { return stored_key_size(layout) + value_size(); }
+
+int IndexNodeHandler::key_stride(const KeyLayout &layout) const
+{
+  return values_separated() ? stored_key_size(layout) : stored_item_size(layout);
+}
+
+void IndexNodeHandler::encode_key(const char *key, const KeyLayout &layout, char *stored) const
+{
+  const int attr_length        = header_.attr_length;
+  const int stored_attr_length = max(layout.prefix_len, layout.key_end) - layout.prefix_len;
+  memcpy(stored, key + layout.prefix_len, stored_attr_length);
+  memcpy(stored + stored_attr_length, key + attr_length, key_size() - attr_length);
+}
+
+void IndexNodeHandler::decode_key(const char *stored, const KeyLayout &layout, char *key) const
+{
+  const int attr_length        = header_.attr_length;
+  const int stored_attr_length = max(layout.prefix_len, layout.key_end) - layout.prefix_len;
+  if (layout.prefix_len > 0) {
+    memcpy(key, prefix(), layout.prefix_len);
+  }
+  memcpy(key + layout.prefix_len, stored, stored_attr_length);
+  memset(key + layout.prefix_len + stored_attr_length, 0, attr_length - layout.prefix_len - stored_attr_length);
+  memcpy(key + attr_length, stored + stored_attr_length, key_size() - attr_length);
+}
+
+char *IndexNodeHandler::key_buffer() const
+{
+  const int key_size = this->key_size();
+  key_buffer_index_ ^= 1;
+  if (2 * key_size <= KEY_BUFFER_SIZE) {
+    return key_buffer_ + key_buffer_index_ * key_size;
+  }
+
+  large_key_buffer_.resize(2 * key_size);
+  return large_key_buffer_.data() + key_buffer_index_ * key_size;
+}
+
+char *IndexNodeHandler::__item_at(int index) const
+{
+  if (!key_compressed()) {
+    return node_array() + index * (values_separated() ? key_size() : item_size());
+  }
+
+  const KeyLayout layout = key_layout();
+  return node_array() + IndexNodeKeyLayout::HEADER_SIZE + layout.prefix_len + index * key_stride(layout);
+}
+
+const char *IndexNodeHandler::__key_at(int index) const
+{
+  if (!key_compressed()) {
+    return __item_at(index);
+  }
+
+  char *key = key_buffer();
+  decode_key(__item_at(index), key_layout(), key);
+  return key;
+}
+
+char *IndexNodeHandler::__value_at(int index) const
+{
+  if (values_separated()) {
+    // 值从页面末尾向前存放，与键值的存放方式无关
+    return reinterpret_cast<char *>(node_) + BP_PAGE_DATA_SIZE - (index + 1) * value_size();
+  }
+  return __item_at(index) + stored_key_size(key_layout());
+}
+
+int IndexNodeHandler::lower_bound(const KeyComparator &comparator, const char *key, int begin, bool *found) const
+{
+  if (!key_compressed() && comparator.search_method() != KeySearchMethod::GENERIC) {
+    return begin + numeric_key_lower_bound(
+                       comparator.search_method(), __item_at(begin), key_stride(key_layout()), size() - begin, key, found);
+  }
+
+  // 按照字段类型分派一次，查找过程中的比较都是内联的
+  return comparator.visit(
+      [this, key, begin, found](const auto &typed_comparator) { return lower_bound_with(typed_comparator, key, begin, found); });
+}
+
+template <typename Comparator>
+int IndexNodeHandler::lower_bound_with(const Comparator &comparator, const char *key, int begin, bool *found) const
+{
+  const int size = this->size();
+  if (!key_compressed()) {
+    const int                    stride = key_stride(key_layout());
+    common::BinaryIterator<char> iter_begin(stride, __item_at(begin));
+    common::BinaryIterator<char> iter_end(stride, __item_at(size));
+    common::BinaryIterator<char> iter = common::lower_bound(iter_begin, iter_end, key, comparator, found);
+    return begin + static_cast<int>(iter - iter_begin);
+  }
+
+  // 与 common::lower_bound 一样，只是比较之前先把键值还原出来
+  const KeyLayout layout = key_layout();
+  char            key_buffer[KEY_BUFFER_SIZE];
+  vector<char>    large_key_buffer;
+  char           *node_key = key_buffer;
+  if (key_size() > KEY_BUFFER_SIZE) {
+    large_key_buffer.resize(key_size());
+    node_key = large_key_buffer.data();
+  }
+
+  bool equal = false;
+  int  first = begin;
+  int  count = size - begin;
+  while (count > 0) {
+    const int step = count / 2;
+    const int mid  = first + step;
+    decode_key(__item_at(mid), layout, node_key);
+    const int result = comparator(node_key, key);
+    if (0 == result) {
+      first = mid;
+      equal = true;
+      break;
+    }
+    if (result < 0) {
+      first = mid + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+
+  if (found) {
+    *found = equal;
+  }
+  return first;
+}
+
+bool IndexNodeHandler::has_room_for(const char *key, int new_items /* = 1 */, float fill_factor /* = 1.0f */) const
+{
+  int limit = 0;
+  if (!key_compressed()) {
+    limit = max_size();
+  } else {
+    const KeyLayout layout = (size() == 0) ? key_layout_of(key) : merge_key_layout(key_layout(), prefix(), key);
+    limit                  = capacity(layout);
+  }
+
+  if (fill_factor < 1.0f) {
+    // 至少要放两个元素，内部节点才有意义
+    limit = max(2, static_cast<int>(limit * fill_factor));
+  }
+  return size() + new_items <= limit;
+}
+
+bool IndexNodeHandler::can_merge(const IndexNodeHandler &other) const
+{
+  const int total = size() + other.size();
+  if (!key_compressed()) {
+    return total <= max_size();
+  }
+  if (other.size() == 0) {
+    return true;
+  }
+  if (size() == 0) {
+    return total <= capacity(other.key_layout());
+  }
+
+  const KeyLayout layout       = key_layout();
+  const KeyLayout other_layout = other.key_layout();
+  const char     *this_prefix  = prefix();
+  const char     *other_prefix = other.prefix();
+  const int       prefix_len   = min(layout.prefix_len, other_layout.prefix_len);
+
+  KeyLayout merged{0, max(layout.key_end, other_layout.key_end)};
+  while (merged.prefix_len < prefix_len && this_prefix[merged.prefix_len] == other_prefix[merged.prefix_len]) {
+    merged.prefix_len++;
+  }
+  return total <= capacity(merged);
+}
+
+void IndexNodeHandler::copy_items(int index, int num, vector<char> &items) const
+{
+  const int item_size = this->item_size();
+  items.resize(static_cast<size_t>(num) * item_size);
+  if (!key_compressed() && !values_separated()) {
+    memcpy(items.data(), __item_at(index), items.size());
+    return;
+  }
+
+  const KeyLayout layout = key_layout();
+  for (int i = 0; i < num; i++) {
+    char *item = items.data() + static_cast<size_t>(i) * item_size;
+    decode_key(__item_at(index + i), layout, item);
+    memcpy(item + key_size(), __value_at(index + i), value_size());
+  }
+}
+
+void IndexNodeHandler::write_items(int index, const char *items, int num)
+{
+  const int item_size = this->item_size();
+  if (!key_compressed() && !values_separated()) {
+    memcpy(__item_at(index), items, static_cast<size_t>(num) * item_size);
+    return;
+  }
+
+  const KeyLayout layout = key_layout();
+  for (int i = 0; i < num; i++) {
+    const char *item = items + static_cast<size_t>(i) * item_size;
+    encode_key(item, layout, __item_at(index + i));
+    memcpy(__value_at(index + i), item + key_size(), value_size());
+  }
+}
+
+void IndexNodeHandler::relayout(const KeyLayout &layout, const char *prefix)
+{
+  vector<char> items;
+  copy_items(0, size(), items);
+  vector<char> new_prefix(prefix, prefix + layout.prefix_len);
+
+  auto *node_layout       = reinterpret_cast<IndexNodeKeyLayout *>(node_array());
+  node_layout->prefix_len = static_cast<int16_t>(layout.prefix_len);
+  node_layout->key_end    = static_cast<int16_t>(layout.key_end);
+  memcpy(node_layout->prefix, new_prefix.data(), layout.prefix_len);
+
+  write_items(0, items.data(), size());
+}
+
+void IndexNodeHandler::shrink_layout()
 {
+  if (!key_compressed()) {
+    return;
+  }
+  if (size() == 0) {
+    reset_layout();
+    return;
+  }
+
+  vector<char> items;
+  copy_items(0, size(), items);
   const int item_size = this->item_size();
+  KeyLayout layout    = key_layout_of(items.data());
+  for (int i = 1; i < size(); i++) {
+    layout = merge_key_layout(layout, items.data(), items.data() + static_cast<size_t>(i) * item_size);
+  }
+  if (layout != key_layout()) {
+    relayout(layout, items.data());
+  }
+}
+
+RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
+{
+  if (key_compressed() && num > 0) {
+    // 先确定插入之后的存放方式，公共前缀可能变短，key_end 可能变大
+    const int   item_size  = this->item_size();
+    const char *prefix_src = (size() == 0) ? items : prefix();
+    KeyLayout   layout     = (size() == 0) ? key_layout_of(items) : key_layout();
+    for (int i = 0; i < num; i++) {
+      layout = merge_key_layout(layout, prefix_src, items + static_cast<size_t>(i) * item_size);
+    }
+
+    if (size() + num > capacity(layout)) {
+      LOG_WARN("no room for items. page num=%d, size=%d, insert num=%d, capacity=%d",
+               page_num(), size(), num, capacity(layout));
+      return RC::INTERNAL;
+    }
+
+    if (layout != key_layout()) {
+      relayout(layout, prefix_src);
+    }
+  }
+
+  const int key_stride = this->key_stride(key_layout());
   if (index < size()) {
-    memmove(__item_at(index + num), __item_at(index), (static_cast<size_t>(size()) - index) * item_size);
+    const size_t move_num = static_cast<size_t>(size()) - index;
+    memmove(__item_at(index + num), __item_at(index), move_num * key_stride);
+    if (values_separated()) {
+      // 值是倒着存放的，后面的元素地址更小
+      memmove(__value_at(size() + num - 1), __value_at(size() - 1), move_num * value_size());
+    }
   }
 
-  memcpy(__item_at(index), items, static_cast<size_t>(num) * item_size);
+  write_items(index, items, num);
   increase_size(num);
   return RC::SUCCESS;
 }
 
+RC IndexNodeHandler::bulk_append(const char *items, int num)
+{
+  RC rc = mtr_.logger().node_insert_items(*this, size(), span<const char>(items, num * item_size()), num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to log append items. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  return recover_insert_items(size(), items, num);
+}
+
 RC IndexNodeHandler::recover_remove_items(int index, int num)
 {
-  const int item_size = this->item_size();
+  const int key_stride = this->key_stride(key_layout());
   if (index < size() - num) {
-    memmove(__item_at(index), __item_at(index + num), (static_cast<size_t>(size()) - index - num) * item_size);
+    const size_t move_num = static_cast<size_t>(size()) - index - num;
+    memmove(__item_at(index), __item_at(index + num), move_num * key_stride);
+    if (values_separated()) {
+      memmove(__value_at(size() - num - 1), __value_at(size() - 1), move_num * value_size());
+    }
   }
 
   increase_size(-num);
+
+  // 删除一个元素时不调整，移走一批元素时公共前缀可能变长
+  if (num > 1 || size() == 0) {
+    shrink_layout();
+  }
   return RC::SUCCESS;
 }
 
@@ -196,6 +558,9 @@ RC LeafIndexNodeHandler::init_empty()
   }
   IndexNodeHandler::init_empty(true/*leaf*/);
   leaf_node_->next_brother = BP_INVALID_PAGE_NUM;
+  if (header_.prev_leaf_links != 0) {
+    leaf_node_->prev_brother = BP_INVALID_PAGE_NUM;
+  }
   return RC::SUCCESS;
 }
 
@@ -213,7 +578,28 @@ RC LeafIndexNodeHandler::set_next_page(PageNum page_num)
 
 PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brother; }
 
-char *LeafIndexNodeHandler::key_at(int index)
+RC LeafIndexNodeHandler::set_prev_page(PageNum page_num)
+{
+  if (header_.prev_leaf_links == 0) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = mtr_.logger().leaf_set_prev_page(*this, page_num, leaf_node_->prev_brother);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to log set prev page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  leaf_node_->prev_brother = page_num;
+  return RC::SUCCESS;
+}
+
+PageNum LeafIndexNodeHandler::prev_page() const
+{
+  return header_.prev_leaf_links != 0 ? leaf_node_->prev_brother : BP_INVALID_PAGE_NUM;
+}
+
+const char *LeafIndexNodeHandler::key_at(int index) const
 {
   assert(index >= 0 && index < size());
   return __key_at(index);
@@ -227,11 +613,7 @@ char *LeafIndexNodeHandler::value_at(int index)
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
-  const int                    size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
+  return lower_bound(comparator, key, 0 /*begin*/, found);
 }
 
 RC LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
@@ -246,22 +628,22 @@ RC LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
     return rc;
   }
 
-  recover_insert_items(index, item.data(), 1);
-  return RC::SUCCESS;
+  return recover_insert_items(index, item.data(), 1);
 }
 
 RC LeafIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
-  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char> item;
+  copy_items(index, 1, item);
+  RC rc = mtr_.logger().node_remove_items(*this, index, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s", strrc(rc));
     return rc;
   }
 
-  recover_remove_items(index, 1);
-  return RC::SUCCESS;
+  return recover_remove_items(index, 1);
 }
 
 int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparator)
@@ -281,46 +663,65 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
   const int move_index = size / 2;
   const int move_item_num = size - move_index;
 
-  other.append(__item_at(move_index), move_item_num);
+  vector<char> items;
+  copy_items(move_index, move_item_num, items);
+  RC rc = other.append(items.data(), move_item_num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy items to new node. rc=%s", strrc(rc));
+    return rc;
+  }
 
-  RC rc = mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_item_num * item_size()), move_item_num);
+  rc = mtr_.logger().node_remove_items(*this, move_index, items, move_item_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
     return rc;
   }
 
-  recover_remove_items(move_index, move_item_num);
-  return RC::SUCCESS;
+  return recover_remove_items(move_index, move_item_num);
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  vector<char> item;
+  copy_items(0, 1, item);
+  RC rc = other.append(item.data());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
   return this->remove(0);
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  vector<char> item;
+  copy_items(size() - 1, 1, item);
+  RC rc = other.preappend(item.data());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
-  this->remove(size() - 1);
-  return RC::SUCCESS;
+  return this->remove(size() - 1);
 }
 /**
  * move all items to left page
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0), this->size());
+  vector<char> items;
+  copy_items(0, this->size(), items);
+  RC rc = other.append(items.data(), this->size());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy items to other node. rc=%s", strrc(rc));
+    return rc;
+  }
   other.set_next_page(this->next_page());
 
-  RC rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), this->size() * item_size()), this->size());
+  rc = mtr_.logger().node_remove_items(*this, 0, items, this->size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
   }
-  this->increase_size(-this->size());
 
-  return RC::SUCCESS;
+  return recover_remove_items(0, this->size());
 }
 
 // 复制一些数据到当前节点的最右边
@@ -345,12 +746,11 @@ RC LeafIndexNodeHandler::preappend(const char *item)
   return insert(0, item, item + key_size());
 }
 
-char *LeafIndexNodeHandler::__item_at(int index) const { return leaf_node_->array + (index * item_size()); }
-
 string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
   stringstream ss;
-  ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
+  ss << to_string((const IndexNodeHandler &)handler) << ",prev page:" << handler.prev_page()
+     << ",next page:" << handler.next_page();
   ss << ",values=[" << printer(handler.__key_at(0));
   for (int i = 1; i < handler.size(); i++) {
     ss << "," << printer(handler.__key_at(i));
@@ -457,12 +857,13 @@ RC InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char
     LOG_WARN("failed to log create new root. rc=%s", strrc(rc));
   }
 
-  memset(__key_at(0), 0, key_size());
-  memcpy(__value_at(0), &first_page_num, value_size());
-  memcpy(__item_at(1), key, key_size());
-  memcpy(__value_at(1), &page_num, value_size());
-  increase_size(2);
-  return RC::SUCCESS;
+  // key0 是没有用的，与 key1 相同的话不会影响节点的公共前缀
+  vector<char> items(2 * item_size());
+  memcpy(items.data(), key, key_size());
+  memcpy(items.data() + key_size(), &first_page_num, value_size());
+  memcpy(items.data() + item_size(), key, key_size());
+  memcpy(items.data() + item_size() + key_size(), &page_num, value_size());
+  return recover_insert_items(0, items.data(), 2);
 }
 
 /**
@@ -496,15 +897,17 @@ RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other)
   const int size       = this->size();
   const int move_index = size / 2;
   const int move_num   = size - move_index;
-  RC        rc         = other.append(this->__item_at(move_index), size - move_index);
+
+  vector<char> items;
+  copy_items(move_index, move_num, items);
+  RC rc = other.append(items.data(), move_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_num * item_size()), move_num);
-  increase_size(-(size - move_index));
-  return rc;
+  mtr_.logger().node_remove_items(*this, move_index, items, move_num);
+  return recover_remove_items(move_index, move_num);
 }
 
 /**
@@ -526,21 +929,23 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int                          ret  = static_cast<int>(iter - iter_begin) + 1;
+  bool      equal = false;
+  const int ret   = lower_bound(comparator, key, 1 /*begin*/, &equal);
   if (insert_position) {
     *insert_position = ret;
   }
+  if (found) {
+    *found = equal;
+  }
 
-  if (ret >= size || comparator(key, __key_at(ret)) < 0) {
+  // lower_bound 找到的键值不小于 key，不相等时 key 属于前一个子节点
+  if (ret >= size || !equal) {
     return ret - 1;
   }
   return ret;
 }
 
-char *InternalIndexNodeHandler::key_at(int index)
+const char *InternalIndexNodeHandler::key_at(int index) const
 {
   assert(index >= 0 && index < size());
   return __key_at(index);
@@ -551,7 +956,18 @@ void InternalIndexNodeHandler::set_key_at(int index, const char *key)
   assert(index >= 0 && index < size());
 
   mtr_.logger().internal_update_key(*this, index, span<const char>(key, key_size()), span<const char>(__key_at(index), key_size()));
-  memcpy(__key_at(index), key, key_size());
+  if (!key_compressed()) {
+    memcpy(__item_at(index), key, key_size());
+    return;
+  }
+
+  // 新的键值可能让元素变长，调用前需要用 has_room_for 检查
+  const KeyLayout layout = merge_key_layout(key_layout(), prefix(), key);
+  ASSERT(size() <= capacity(layout), "no room for new key. page num=%d, size=%d", page_num(), size());
+  if (layout != key_layout()) {
+    relayout(layout, prefix());
+  }
+  encode_key(key, layout, __item_at(index));
 }
 
 PageNum InternalIndexNodeHandler::value_at(int index)
@@ -574,8 +990,11 @@ void InternalIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
+  vector<char> item;
+  copy_items(index, 1, item);
+
   BplusTreeLogger &logger = mtr_.logger();
-  RC rc = logger.node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  RC rc = logger.node_remove_items(*this, index, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s. node=%s", strrc(rc), to_string(*this).c_str());
   }
@@ -585,13 +1004,15 @@ void InternalIndexNodeHandler::remove(int index)
 
 RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0), size());
+  vector<char> items;
+  copy_items(0, size(), items);
+  RC rc = other.append(items.data(), size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), size() * item_size()), size());
+  rc = mtr_.logger().node_remove_items(*this, 0, items, size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -602,7 +1023,9 @@ RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0));
+  vector<char> item;
+  copy_items(0, 1, item);
+  RC rc = other.append(item.data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append item to others.");
     return rc;
@@ -614,19 +1037,20 @@ RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other)
 {
-  RC rc = other.preappend(__item_at(size() - 1));
+  vector<char> item;
+  copy_items(size() - 1, 1, item);
+  RC rc = other.preappend(item.data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to preappend to others");
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, size() - 1, span<const char>(__item_at(size() - 1), item_size()), 1);
+  rc = mtr_.logger().node_remove_items(*this, size() - 1, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  increase_size(-1);
-  return rc;
+  return recover_remove_items(size() - 1, 1);
 }
 
 RC InternalIndexNodeHandler::insert_items(int index, const char *items, int num)
@@ -637,7 +1061,10 @@ RC InternalIndexNodeHandler::insert_items(int index, const char *items, int num)
     return rc;
   }
 
-  recover_insert_items(index, items, num);
+  rc = recover_insert_items(index, items, num);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
   LatchMemo &latch_memo = mtr_.latch_memo();
   PageNum this_page_num = this->page_num();
@@ -676,12 +1103,8 @@ RC InternalIndexNodeHandler::preappend(const char *item)
   return this->insert_items(0, item, 1);
 }
 
-char *InternalIndexNodeHandler::__item_at(int index) const { return internal_node_->array + (index * item_size()); }
-
 int InternalIndexNodeHandler::value_size() const { return sizeof(PageNum); }
 
-int InternalIndexNodeHandler::item_size() const { return key_size() + this->value_size(); }
-
 bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
 {
   bool result = IndexNodeHandler::validate();
@@ -801,6 +1224,42 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
                             int attr_length, 
                             int internal_max_size /* = -1*/,
                             int leaf_max_size /* = -1 */)
+{
+  return this->create(log_handler,
+      bpm,
+      file_name,
+      span<const AttrType>(&attr_type, 1),
+      span<const int>(&attr_length, 1),
+      internal_max_size,
+      leaf_max_size);
+}
+
+RC BplusTreeHandler::create(LogHandler &log_handler,
+            DiskBufferPool &buffer_pool,
+            AttrType attr_type,
+            int attr_length,
+            int internal_max_size /* = -1 */,
+            int leaf_max_size /* = -1 */)
+{
+  return this->create(log_handler,
+      buffer_pool,
+      span<const AttrType>(&attr_type, 1),
+      span<const int>(&attr_length, 1),
+      internal_max_size,
+      leaf_max_size);
+}
+
+RC BplusTreeHandler::create(LogHandler &log_handler,
+                            BufferPoolManager &bpm,
+                            const char *file_name,
+                            span<const AttrType> attr_types,
+                            span<const int> attr_lengths,
+                            int internal_max_size /* = -1*/,
+                            int leaf_max_size /* = -1 */,
+                            bool key_compression /* = true */,
+                            bool separate_leaf_values /* = true */,
+                            int include_length /* = 0 */,
+                            bool unique_keys /* = false */)
 {
   RC rc = bpm.create_file(file_name);
   if (OB_FAIL(rc)) {
@@ -818,7 +1277,16 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
   }
   LOG_INFO("Successfully open index file %s.", file_name);
 
-  rc = this->create(log_handler, *bp, attr_type, attr_length, internal_max_size, leaf_max_size);
+  rc = this->create(log_handler,
+      *bp,
+      attr_types,
+      attr_lengths,
+      internal_max_size,
+      leaf_max_size,
+      key_compression,
+      separate_leaf_values,
+      include_length,
+      unique_keys);
   if (OB_FAIL(rc)) {
     bpm.close_file(file_name);
     return rc;
@@ -830,16 +1298,40 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
 
 RC BplusTreeHandler::create(LogHandler &log_handler,
             DiskBufferPool &buffer_pool,
-            AttrType attr_type,
-            int attr_length,
+            span<const AttrType> attr_types,
+            span<const int> attr_lengths,
             int internal_max_size /* = -1 */,
-            int leaf_max_size /* = -1 */)
-{
+            int leaf_max_size /* = -1 */,
+            bool key_compression /* = true */,
+            bool separate_leaf_values /* = true */,
+            int include_length /* = 0 */,
+            bool unique_keys /* = false */)
+{
+  if (attr_types.empty() || attr_types.size() != attr_lengths.size() ||
+      attr_types.size() > static_cast<size_t>(IndexFileHeader::MAX_ATTR_NUM)) {
+    LOG_WARN("invalid attributes of bplus tree. attr num=%d", static_cast<int>(attr_types.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+  if (include_length < 0) {
+    LOG_WARN("invalid include length of bplus tree. include length=%d", include_length);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  int attr_length = 0;
+  for (int length : attr_lengths) {
+    attr_length += length;
+  }
+
   if (internal_max_size < 0) {
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = calc_leaf_page_capacity(attr_length, include_length);
+    if (leaf_max_size < 3) {
+      LOG_WARN("key or include data is too long for bplus tree. attr length=%d, include length=%d",
+               attr_length, include_length);
+      return RC::INVALID_ARGUMENT;
+    }
   }
 
   log_handler_      = &log_handler;
@@ -863,14 +1355,24 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
     return RC::INTERNAL;
   }
 
-  char            *pdata         = header_frame->data();
-  IndexFileHeader *file_header   = (IndexFileHeader *)pdata;
-  file_header->attr_length       = attr_length;
-  file_header->key_length        = attr_length + sizeof(RID);
-  file_header->attr_type         = attr_type;
-  file_header->internal_max_size = internal_max_size;
-  file_header->leaf_max_size     = leaf_max_size;
-  file_header->root_page         = BP_INVALID_PAGE_NUM;
+  char            *pdata            = header_frame->data();
+  IndexFileHeader *file_header      = (IndexFileHeader *)pdata;
+  file_header->attr_length          = attr_length;
+  file_header->key_length           = attr_length + sizeof(RID);
+  file_header->attr_type            = attr_types[0];
+  file_header->attr_num             = static_cast<int32_t>(attr_types.size());
+  for (size_t i = 0; i < attr_types.size(); i++) {
+    file_header->attr_types[i]      = attr_types[i];
+    file_header->attr_lengths[i]    = attr_lengths[i];
+  }
+  file_header->internal_max_size    = internal_max_size;
+  file_header->leaf_max_size        = leaf_max_size;
+  file_header->root_page            = BP_INVALID_PAGE_NUM;
+  file_header->key_compression      = key_compression ? 1 : 0;
+  file_header->separate_leaf_values = separate_leaf_values ? 1 : 0;
+  file_header->include_length       = include_length;
+  file_header->unique_keys          = unique_keys ? 1 : 0;
+  file_header->prev_leaf_links      = 1;
 
   // 取消记录日志的原因请参考下面的sync调用的地方。
   // mtr.logger().init_header_page(header_frame, *file_header);
@@ -887,8 +1389,8 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
     return RC::NOMEM;
   }
 
-  key_comparator_.init(file_header->attr_type, file_header->attr_length);
-  key_printer_.init(file_header->attr_type, file_header->attr_length);
+  key_comparator_.init(file_header->attr_type_list(), file_header->attr_length_list());
+  key_printer_.init(file_header->attr_type_list(), file_header->attr_length_list());
 
   /*
   虽然我们针对B+树记录了WAL，但是我们记录的都是逻辑日志，并没有记录某个页面如何修改的物理日志。
@@ -959,8 +1461,8 @@ RC BplusTreeHandler::open(LogHandler &log_handler, DiskBufferPool &buffer_pool)
   // close old page_handle
   buffer_pool.unpin_page(frame);
 
-  key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
-  key_printer_.init(file_header_.attr_type, file_header_.attr_length);
+  key_comparator_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
+  key_printer_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
   LOG_INFO("Successfully open index");
   return RC::SUCCESS;
 }
@@ -1132,6 +1634,11 @@ bool BplusTreeHandler::validate_leaf_link(BplusTreeMiniTransaction &mtr)
 
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   PageNum              next_page_num = leaf_node.next_page();
+  PageNum              prev_page_num = frame->page_num();
+  if (file_header_.prev_leaf_links != 0 && leaf_node.prev_page() != BP_INVALID_PAGE_NUM) {
+    LOG_WARN("invalid page. left most page has prev page. prev page num=%d", leaf_node.prev_page());
+    return false;
+  }
 
   MemPoolItem::item_unique_ptr prev_key = mem_pool_item_->alloc_unique_ptr();
   memcpy(prev_key.get(), leaf_node.key_at(leaf_node.size() - 1), file_header_.key_length);
@@ -1149,7 +1656,12 @@ bool BplusTreeHandler::validate_leaf_link(BplusTreeMiniTransaction &mtr)
       LOG_WARN("invalid page. current first key is not bigger than last");
       result = false;
     }
+    if (file_header_.prev_leaf_links != 0 && leaf_node.prev_page() != prev_page_num) {
+      LOG_WARN("invalid page. prev page num=%d, expected=%d", leaf_node.prev_page(), prev_page_num);
+      result = false;
+    }
 
+    prev_page_num = next_page_num;
     next_page_num = leaf_node.next_page();
     memcpy(prev_key.get(), leaf_node.key_at(leaf_node.size() - 1), file_header_.key_length);
   }
@@ -1184,22 +1696,159 @@ bool BplusTreeHandler::validate_tree()
   return true;
 }
 
-bool BplusTreeHandler::is_empty() const { return file_header_.root_page == BP_INVALID_PAGE_NUM; }
-
-RC BplusTreeHandler::find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame)
+RC BplusTreeHandler::stat_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame, int level, BplusTreeStat &stat)
 {
-  auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
-    return internal_node.value_at(internal_node.lookup(key_comparator_, key));
-  };
-  return find_leaf_internal(mtr, op, child_page_getter, frame);
+  stat.height = max(stat.height, level);
+
+  IndexNodeHandler node(mtr, file_header_, frame);
+  if (node.is_leaf()) {
+    stat.leaf_pages++;
+    stat.entry_num += node.size();
+    return RC::SUCCESS;
+  }
+
+  stat.internal_pages++;
+  InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
+  for (int i = 0; i < internal_node.size(); i++) {
+    const PageNum page_num    = internal_node.value_at(i);
+    Frame        *child_frame = nullptr;
+    RC            rc          = disk_buffer_pool_->get_this_page(page_num, &child_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch child page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    // 节点很多，不放到 latch memo 中，访问完就释放
+    rc = stat_node_recursive(mtr, child_frame, level + 1, stat);
+    disk_buffer_pool_->unpin_page(child_frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame)
+RC BplusTreeHandler::get_stat(BplusTreeStat &stat)
+{
+  stat = BplusTreeStat();
+  if (is_empty()) {
+    return RC::SUCCESS;
+  }
+
+  BplusTreeMiniTransaction mtr(*this);
+  Frame                   *frame = nullptr;
+
+  RC rc = mtr.latch_memo().get_page(file_header_.root_page, frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch root page. page num=%d, rc=%s", file_header_.root_page, strrc(rc));
+    return rc;
+  }
+  return stat_node_recursive(mtr, frame, 1 /*level*/, stat);
+}
+
+bool BplusTreeHandler::is_empty() const { return file_header_.root_page == BP_INVALID_PAGE_NUM; }
+
+RC BplusTreeHandler::find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame)
+{
+  if (op != BplusTreeOperationType::READ) {
+    bool safe = false;
+    RC   rc   = find_leaf_optimistic(mtr, op, key, frame, safe);
+    if (OB_FAIL(rc) || safe) {
+      return rc;
+    }
+  }
+
+  auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
+    return internal_node.value_at(internal_node.lookup(key_comparator_, key));
+  };
+  return find_leaf_internal(mtr, op, child_page_getter, frame);
+}
+
+RC BplusTreeHandler::find_leaf_optimistic(
+    BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame, bool &safe)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  safe = false;
+  latch_memo.slatch(&root_lock_);
+  if (is_empty()) {
+    return RC::EMPTY;
+  }
+
+  PageNum page_num     = file_header_.root_page;
+  bool    is_root_node = true;
+  while (true) {
+    const int memo_point = latch_memo.memo_point();
+
+    RC rc = latch_memo.get_page(page_num, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get frame. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    // 持有父节点(根节点是 root_lock_)的读锁时，子节点不会被删除，所以加锁之前就可以判断是不是叶子节点
+    const bool is_leaf = reinterpret_cast<IndexNode *>(frame->data())->is_leaf;
+    latch_memo.latch(frame, is_leaf ? LatchMemoType::EXCLUSIVE : LatchMemoType::SHARED);
+    latch_memo.release_to(memo_point);
+    if (is_leaf) {
+      break;
+    }
+
+    InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
+    page_num     = internal_node.value_at(internal_node.lookup(key_comparator_, key));
+    is_root_node = false;
+  }
+
+  LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
+  if (op == BplusTreeOperationType::INSERT) {
+    safe = leaf_node.has_room_for(key);
+  } else {
+    safe = leaf_node.is_safe(op, is_root_node);
+  }
+
+  if (!safe) {
+    latch_memo.release();
+    frame = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame)
 {
   auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
   return find_leaf_internal(mtr, BplusTreeOperationType::READ, child_page_getter, frame);
 }
 
+RC BplusTreeHandler::right_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame)
+{
+  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) {
+    return internal_node.value_at(internal_node.size() - 1);
+  };
+  return find_leaf_internal(mtr, BplusTreeOperationType::READ, child_page_getter, frame);
+}
+
+RC BplusTreeHandler::set_leaf_prev_page(BplusTreeMiniTransaction &mtr, PageNum page_num, PageNum prev_page_num)
+{
+  if (file_header_.prev_leaf_links == 0 || page_num == BP_INVALID_PAGE_NUM) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = mtr.latch_memo().get_page(page_num, frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch leaf page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+  mtr.latch_memo().xlatch(frame);
+
+  LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
+  rc = leaf_node.set_prev_page(prev_page_num);
+  if (OB_SUCC(rc)) {
+    frame->mark_dirty();
+  }
+  return rc;
+}
+
 RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
     const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
 {
@@ -1260,7 +1909,7 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
   return rc;
 }
 
-RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const RID *rid)
+RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const char *value)
 {
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   bool                 exists          = false;  // 该数据是否已经存在指定的叶子节点中了
@@ -1270,8 +1919,8 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+  if (leaf_node.has_room_for(key)) {
+    leaf_node.insert(insert_position, key, value);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
     return RC::SUCCESS;
@@ -1285,17 +1934,35 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
   }
 
   LeafIndexNodeHandler new_index_node(mtr, file_header_, new_frame);
-  new_index_node.set_next_page(leaf_node.next_page());
+  const PageNum        next_page_num = leaf_node.next_page();
+  new_index_node.set_next_page(next_page_num);
+  new_index_node.set_prev_page(frame->page_num());
   new_index_node.set_parent_page_num(leaf_node.parent_page_num());
   leaf_node.set_next_page(new_frame->page_num());
+  rc = set_leaf_prev_page(mtr, next_page_num, new_frame->page_num());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to set prev page of next leaf node. rc=%s", strrc(rc));
+    return rc;
+  }
 
   if (insert_position < leaf_node.size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+    rc = leaf_node.insert(insert_position, key, value);
   } else {
-    new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
+    rc = new_index_node.insert(insert_position - leaf_node.size(), key, value);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert into leaf node after split. rc=%s", strrc(rc));
+    return rc;
   }
 
-  return insert_entry_into_parent(mtr, frame, new_frame, new_index_node.key_at(0));
+  MemPoolItem::item_unique_ptr separator = mem_pool_item_->alloc_unique_ptr();
+  if (separator == nullptr) {
+    LOG_WARN("Failed to alloc memory for key.");
+    return RC::NOMEM;
+  }
+  char *separator_key = static_cast<char *>(separator.get());
+  make_separator(leaf_node.key_at(leaf_node.size() - 1), new_index_node.key_at(0), separator_key);
+  return insert_entry_into_parent(mtr, frame, new_frame, separator_key);
 }
 
 RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *new_frame, const char *key)
@@ -1350,7 +2017,7 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
     InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
 
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
-    if (parent_node.size() < parent_node.max_size()) {
+    if (parent_node.has_room_for(key)) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
       new_node_handler.set_parent_page_num(parent_page_num);
 
@@ -1438,8 +2105,8 @@ RC BplusTreeHandler::recover_init_header_page(BplusTreeMiniTransaction &mtr, Fra
   header_dirty_ = false;
   frame->mark_dirty();
 
-  key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
-  key_printer_.init(file_header_.attr_type, file_header_.attr_length);
+  key_comparator_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
+  key_printer_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
 
   return RC::SUCCESS;
 }
@@ -1458,7 +2125,7 @@ void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr
   LOG_DEBUG("set root page to %d", root_page_num);
 }
 
-RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid)
+RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value)
 {
   RC rc = RC::SUCCESS;
   if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
@@ -1477,7 +2144,7 @@ RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *
 
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   leaf_node.init_empty();
-  leaf_node.insert(0, key, (const char *)rid);
+  leaf_node.insert(0, key, value);
   update_root_page_num_locked(mtr, frame->page_num());
   frame->mark_dirty();
 
@@ -1485,6 +2152,25 @@ RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *
   return rc;
 }
 
+void BplusTreeHandler::make_separator(const char *left_key, const char *right_key, char *separator) const
+{
+  memcpy(separator, right_key, file_header_.key_length);
+  if (file_header_.key_compression == 0) {
+    return;
+  }
+
+  // 字段的类型可能不是按照字节比较的，逐个长度尝试，找到满足 left < separator <= right 的最短前缀
+  const int attr_length = file_header_.attr_length;
+  for (int prefix_len = 0; prefix_len < attr_length; prefix_len++) {
+    memset(separator + prefix_len, 0, attr_length - prefix_len);
+    if (key_comparator_(left_key, separator) < 0 && key_comparator_(separator, right_key) <= 0) {
+      return;
+    }
+    separator[prefix_len] = right_key[prefix_len];
+  }
+  memcpy(separator, right_key, attr_length);
+}
+
 MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, const RID &rid)
 {
   MemPoolItem::item_unique_ptr key = mem_pool_item_->alloc_unique_ptr();
@@ -1497,14 +2183,30 @@ MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, co
   return key;
 }
 
-RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
+RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid, const char *include /* = nullptr */)
 {
   if (user_key == nullptr || rid == nullptr) {
     LOG_WARN("Invalid arguments, key is empty or rid is empty");
     return RC::INVALID_ARGUMENT;
   }
 
-  MemPoolItem::item_unique_ptr pkey = make_key(user_key, *rid);
+  // 叶子节点中的值是 RID，后面跟着附带的数据
+  const int    include_length = file_header_.include_length;
+  const char  *value          = reinterpret_cast<const char *>(rid);
+  vector<char> value_buffer;
+  if (include_length > 0) {
+    if (include == nullptr) {
+      LOG_WARN("Invalid arguments, include data is empty. include length=%d", include_length);
+      return RC::INVALID_ARGUMENT;
+    }
+    value_buffer.resize(sizeof(RID) + include_length);
+    memcpy(value_buffer.data(), rid, sizeof(RID));
+    memcpy(value_buffer.data() + sizeof(RID), include, include_length);
+    value = value_buffer.data();
+  }
+
+  // 唯一索引的键值中没有RID，相同的 user_key 会在叶子节点中找到同样的键值，返回 RECORD_DUPLICATE_KEY
+  MemPoolItem::item_unique_ptr pkey = make_key(user_key, key_rid(*rid));
   if (pkey == nullptr) {
     LOG_WARN("Failed to alloc memory for key.");
     return RC::NOMEM;
@@ -1519,7 +2221,7 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
   if (is_empty()) {
     root_lock_.lock();
     if (is_empty()) {
-      rc = create_new_tree(mtr, key, rid);
+      rc = create_new_tree(mtr, key, value);
       root_lock_.unlock();
       return rc;
     }
@@ -1534,7 +2236,7 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
     return rc;
   }
 
-  rc = insert_entry_into_leaf_node(mtr, frame, key, rid);
+  rc = insert_entry_into_leaf_node(mtr, frame, key, value);
   if (OB_FAIL(rc)) {
     LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid->to_string().c_str(), strrc(rc));
     return rc;
@@ -1567,6 +2269,124 @@ RC BplusTreeHandler::get_entry(const char *user_key, int key_len, list<RID> &rid
   return rc;
 }
 
+RC BplusTreeHandler::get_entries(span<const char *const> user_keys, vector<vector<RID>> &rids)
+{
+  rids.clear();
+  rids.resize(user_keys.size());
+
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+  for (size_t i = 1; i < user_keys.size(); i++) {
+    if (attr_comparator(user_keys[i - 1], user_keys[i]) > 0) {
+      LOG_WARN("user keys should be sorted. index=%d", static_cast<int>(i));
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  BplusTreeMiniTransaction mtr(*this);
+  Frame                   *frame = nullptr;
+  vector<char>             seek_key(file_header_.key_length);
+  for (size_t i = 0; i < user_keys.size(); i++) {
+    if (i > 0 && attr_comparator(user_keys[i - 1], user_keys[i]) == 0) {
+      rids[i] = rids[i - 1];
+      continue;
+    }
+
+    RC rc = get_entries_of_key(mtr, user_keys[i], seek_key.data(), frame, rids[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get entries. index=%d, rc=%s", static_cast<int>(i), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::get_entries_of_key(
+    BplusTreeMiniTransaction &mtr, const char *user_key, char *seek_key, Frame *&frame, vector<RID> &rids)
+{
+  LatchMemo            &latch_memo      = mtr.latch_memo();
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+
+  // 从 seek_key 开始查找，seek_inclusive 为 false 时表示 seek_key 是已经找到的最后一条数据
+  memcpy(seek_key, user_key, file_header_.attr_length);
+  memcpy(seek_key + file_header_.attr_length, RID::min(), sizeof(RID));
+  bool seek_inclusive = true;
+  // 没有找到数据时最多向右移动一个叶子节点，再远就从根节点查找
+  bool may_move_right = true;
+
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (nullptr == frame) {
+      rc = find_leaf(mtr, BplusTreeOperationType::READ, seek_key, frame);
+      if (rc == RC::EMPTY) {
+        latch_memo.release();
+        frame = nullptr;
+        return RC::SUCCESS;
+      } else if (OB_FAIL(rc)) {
+        latch_memo.release();
+        frame = nullptr;
+        LOG_WARN("failed to find leaf. rc=%s", strrc(rc));
+        return rc;
+      }
+      may_move_right = true;
+    }
+
+    LeafIndexNodeHandler leaf(mtr, file_header_, frame);
+    const int            size  = leaf.size();
+    int                  index = leaf.lookup(key_comparator_, seek_key);
+    if (!seek_inclusive && index < size && key_comparator_(leaf.key_at(index), seek_key) == 0) {
+      index++;
+    }
+
+    if (index >= size && seek_inclusive && !may_move_right) {
+      latch_memo.release();
+      frame = nullptr;
+      continue;
+    }
+
+    for (; index < size; index++) {
+      if (attr_comparator(leaf.key_at(index), user_key) != 0) {
+        return RC::SUCCESS;
+      }
+
+      RID rid;
+      memcpy(&rid, leaf.value_at(index), sizeof(rid));
+      rids.push_back(rid);
+    }
+
+    // 相同的键值可能延续到下一个叶子节点
+    if (size > 0 && attr_comparator(leaf.key_at(size - 1), user_key) == 0) {
+      memcpy(seek_key, leaf.key_at(size - 1), file_header_.key_length);
+      seek_inclusive = false;
+    } else {
+      may_move_right = false;
+    }
+
+    const PageNum next_page_num = leaf.next_page();
+    if (BP_INVALID_PAGE_NUM == next_page_num) {
+      return RC::SUCCESS;
+    }
+
+    const int memo_point = latch_memo.memo_point();
+    Frame    *next_frame = nullptr;
+    rc                   = latch_memo.get_page(next_page_num, next_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+      return rc;
+    }
+
+    // 与 BplusTreeScanner::next_entry 一样，向右加锁时不能等待，加锁失败就从根节点重新查找
+    if (!latch_memo.try_slatch(next_frame)) {
+      latch_memo.release();
+      frame = nullptr;
+      continue;
+    }
+
+    latch_memo.release_to(memo_point);
+    frame = next_frame;
+  }
+  return rc;
+}
+
 RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame)
 {
   LatchMemo &latch_memo = mtr.latch_memo();
@@ -1639,10 +2459,10 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
 
   InternalIndexNodeHandler parent_index_node(mtr, file_header_, parent_frame);
 
-  int index = parent_index_node.lookup(key_comparator_, index_node.key_at(index_node.size() - 1));
-  ASSERT(parent_index_node.value_at(index) == frame->page_num(),
-         "lookup return an invalid value. index=%d, this page num=%d, but got %d",
-         index, frame->page_num(), parent_index_node.value_at(index));
+  // 分隔键值可能比节点中的键值短，这里直接按照页号查找
+  int index = parent_index_node.value_index(frame->page_num());
+  ASSERT(index >= 0, "cannot find page in parent. this page num=%d, parent page num=%d",
+         frame->page_num(), parent_page_num);
 
   PageNum neighbor_page_num;
   if (index == 0) {
@@ -1664,7 +2484,9 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  // 右边节点的数据都会合并到左边节点上，能否放得下还与压缩后的键值长度有关
+  const bool can_merge = (index == 0) ? index_node.can_merge(neighbor_node) : neighbor_node.can_merge(index_node);
+  if (!can_merge) {
     rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
@@ -1722,6 +2544,11 @@ RC BplusTreeHandler::coalesce(
     LeafIndexNodeHandler left_leaf_node(mtr, file_header_, left_frame);
     LeafIndexNodeHandler right_leaf_node(mtr, file_header_, right_frame);
     left_leaf_node.set_next_page(right_leaf_node.next_page());
+    rc = set_leaf_prev_page(mtr, right_leaf_node.next_page(), left_frame->page_num());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to set prev page of next leaf node. rc=%s", strrc(rc));
+      return rc;
+    }
   }
 
   // 释放右边节点
@@ -1740,21 +2567,61 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
   if (neighbor_node.size() < node.size()) {
     LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
   }
+
+  // 先算出移动之后父节点中新的分隔键值。父节点放不下的话就不移动了，当前节点只是比较空，不影响正确性
+  MemPoolItem::item_unique_ptr separator = mem_pool_item_->alloc_unique_ptr();
+  if (separator == nullptr) {
+    LOG_WARN("Failed to alloc memory for key.");
+    return RC::NOMEM;
+  }
+  char     *separator_key = static_cast<char *>(separator.get());
+  const int neighbor_size = neighbor_node.size();
+  if (neighbor_size < 2) {
+    return RC::SUCCESS;
+  }
   if (index == 0) {
     // the neighbor is at right
-    neighbor_node.move_first_to_end(node);
+    if (neighbor_node.is_leaf()) {
+      make_separator(neighbor_node.key_at(0), neighbor_node.key_at(1), separator_key);
+    } else {
+      memcpy(separator_key, neighbor_node.key_at(1), file_header_.key_length);
+    }
+  } else {
+    // the neighbor is at left
+    if (neighbor_node.is_leaf()) {
+      make_separator(neighbor_node.key_at(neighbor_size - 2), neighbor_node.key_at(neighbor_size - 1), separator_key);
+    } else {
+      memcpy(separator_key, neighbor_node.key_at(neighbor_size - 1), file_header_.key_length);
+    }
+  }
+
+  if (!parent_node.has_room_for(separator_key, 0 /*new_items*/)) {
+    LOG_TRACE("no room for new separator in parent node. skip redistribute. parent page num=%d", parent_node.page_num());
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (index == 0) {
+    rc = neighbor_node.move_first_to_end(node);
     // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
     // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index + 1, neighbor_node.key_at(0));
+    if (OB_SUCC(rc)) {
+      parent_node.set_key_at(index + 1, separator_key);
+    }
     // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
   } else {
-    // the neighbor is at left
-    neighbor_node.move_last_to_front(node);
+    rc = neighbor_node.move_last_to_front(node);
     // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
     // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index, node.key_at(0));
+    if (OB_SUCC(rc)) {
+      parent_node.set_key_at(index, separator_key);
+    }
     // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
   }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to move item between nodes. rc=%s", strrc(rc));
+    return rc;
+  }
 
   neighbor_frame->mark_dirty();
   frame->mark_dirty();
@@ -1763,16 +2630,25 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame *leaf_frame, const char *key)
+RC BplusTreeHandler::delete_entry_internal(
+    BplusTreeMiniTransaction &mtr, Frame *leaf_frame, const char *key, const RID &rid)
 {
   LeafIndexNodeHandler leaf_index_node(mtr, file_header_, leaf_frame);
 
-  const int remove_count = leaf_index_node.remove(key, key_comparator_);
-  if (remove_count == 0) {
+  bool      found = false;
+  const int index = leaf_index_node.lookup(key_comparator_, key, &found);
+  // 唯一索引的键值中没有RID，还要确认找到的数据属于这个RID
+  if (found && file_header_.unique_keys) {
+    RID entry_rid;
+    memcpy(&entry_rid, leaf_index_node.value_at(index), sizeof(entry_rid));
+    found = (entry_rid == rid);
+  }
+  if (!found) {
     LOG_TRACE("no data need to remove");
     // disk_buffer_pool_->unpin_page(leaf_frame);
     return RC::RECORD_NOT_EXIST;
   }
+  leaf_index_node.remove(index);
   // leaf_index_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
 
   leaf_frame->mark_dirty();
@@ -1794,7 +2670,7 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
   char *key = static_cast<char *>(pkey.get());
 
   memcpy(key, user_key, file_header_.attr_length);
-  memcpy(key + file_header_.attr_length, rid, sizeof(*rid));
+  memcpy(key + file_header_.attr_length, &key_rid(*rid), sizeof(*rid));
 
   BplusTreeOperationType op = BplusTreeOperationType::DELETE;
 
@@ -1815,7 +2691,7 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
     return rc;
   }
 
-  rc = delete_entry_internal(mtr, leaf_frame, key);
+  rc = delete_entry_internal(mtr, leaf_frame, key, *rid);
   return rc;
 }
 
@@ -1828,7 +2704,7 @@ BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler)
 BplusTreeScanner::~BplusTreeScanner() { close(); }
 
 RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key,
-    int right_len, bool right_inclusive)
+    int right_len, bool right_inclusive, bool reverse /* = false */)
 {
   RC rc = RC::SUCCESS;
   if (inited_) {
@@ -1836,15 +2712,45 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     return RC::INTERNAL;
   }
 
+  if (reverse && tree_handler_.file_header_.prev_leaf_links == 0) {
+    LOG_WARN("cannot scan backward. the bplus tree is created without prev leaf links");
+    return RC::UNSUPPORTED;
+  }
+
   inited_        = true;
   first_emitted_ = false;
+  reverse_       = reverse;
 
-  LatchMemo &latch_memo = mtr_.latch_memo();
+  // 把左右边界都调整成与B+树中的键值一样长的数据
+  char *fixed_left_key  = const_cast<char *>(left_user_key);
+  char *fixed_right_key = const_cast<char *>(right_user_key);
+  DEFER({
+    if (fixed_left_key != left_user_key) {
+      delete[] fixed_left_key;
+    }
+    if (fixed_right_key != right_user_key) {
+      delete[] fixed_right_key;
+    }
+  });
+  if (left_user_key != nullptr) {
+    rc = fix_bound_key(left_user_key, left_len, true /*is_left*/, left_inclusive, &fixed_left_key);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (right_user_key != nullptr) {
+    rc = fix_bound_key(right_user_key, right_len, false /*is_left*/, right_inclusive, &fixed_right_key);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fix right user key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
 
   // 校验输入的键值是否是合法范围
   if (left_user_key && right_user_key) {
     const auto &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
-    const int   result          = attr_comparator(left_user_key, right_user_key);
+    const int   result          = attr_comparator(fixed_left_key, fixed_right_key);
     if (result > 0 ||  // left < right
                        // left == right but is (left,right)/[left,right) or (left,right]
         (result == 0 && (left_inclusive == false || right_inclusive == false))) {
@@ -1852,116 +2758,168 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     }
   }
 
-  if (nullptr == left_user_key) {
+  rc = reverse ? open_backward(right_user_key == nullptr ? nullptr : fixed_right_key, right_inclusive)
+               : open_forward(left_user_key == nullptr ? nullptr : fixed_left_key, left_inclusive);
+  if (OB_FAIL(rc) || current_frame_ == nullptr) {
+    return rc;
+  }
+
+  // 没有指定结束位置，那么就一直扫描到最后
+  // 边界上的RID取最小值还是最大值，要让边界上的数据正好落在扫描范围的内侧或者外侧
+  const char *end_key       = reverse ? (left_user_key == nullptr ? nullptr : fixed_left_key)
+                                      : (right_user_key == nullptr ? nullptr : fixed_right_key);
+  const bool  end_inclusive = reverse ? left_inclusive : right_inclusive;
+  end_inclusive_            = end_inclusive;
+  if (nullptr == end_key) {
+    end_key_ = nullptr;
+  } else if (end_inclusive == reverse) {
+    // 正向扫描不包含右边界，或者反向扫描包含左边界
+    end_key_ = tree_handler_.make_key(end_key, *RID::min());
+  } else {
+    end_key_ = tree_handler_.make_key(end_key, *RID::max());
+  }
+
+  if (touch_end()) {
+    current_frame_ = nullptr;
+  }
+
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::open_forward(const char *left_key, bool left_inclusive)
+{
+  LatchMemo &latch_memo = mtr_.latch_memo();
+
+  RC rc = RC::SUCCESS;
+  if (nullptr == left_key) {
     rc = tree_handler_.left_most_page(mtr_, current_frame_);
     if (OB_FAIL(rc)) {
+      current_frame_ = nullptr;
       if (rc == RC::EMPTY) {
-        current_frame_ = nullptr;
         return RC::SUCCESS;
       }
-      
+
       LOG_WARN("failed to find left most page. rc=%s", strrc(rc));
       return rc;
     }
 
     iter_index_ = 0;
-  } else {
-
-    char *fixed_left_key = const_cast<char *>(left_user_key);
-    if (tree_handler_.file_header_.attr_type == AttrType::CHARS) {
-      bool should_inclusive_after_fix = false;
-      rc = fix_user_key(left_user_key, left_len, true /*greater*/, &fixed_left_key, &should_inclusive_after_fix);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
-        return rc;
-      }
+    return RC::SUCCESS;
+  }
 
-      if (should_inclusive_after_fix) {
-        left_inclusive = true;
-      }
-    }
+  MemPoolItem::item_unique_ptr left_pkey;
+  if (left_inclusive) {
+    left_pkey = tree_handler_.make_key(left_key, *RID::min());
+  } else {
+    left_pkey = tree_handler_.make_key(left_key, *RID::max());
+  }
 
-    MemPoolItem::item_unique_ptr left_pkey;
-    if (left_inclusive) {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::min());
-    } else {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::max());
-    }
+  const char *left_full_key = (const char *)left_pkey.get();
 
-    const char *left_key = (const char *)left_pkey.get();
+  rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, left_full_key, current_frame_);
+  if (rc == RC::EMPTY) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    current_frame_ = nullptr;
+    LOG_WARN("failed to find left page. rc=%s", strrc(rc));
+    return rc;
+  }
 
-    if (fixed_left_key != left_user_key) {
-      delete[] fixed_left_key;
-      fixed_left_key = nullptr;
+  LeafIndexNodeHandler left_node(mtr_, tree_handler_.file_header_, current_frame_);
+  int                  left_index = left_node.lookup(tree_handler_.key_comparator_, left_full_key);
+  // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
+  if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
+    const PageNum next_page_num = left_node.next_page();
+    if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
+      latch_memo.release();
+      current_frame_ = nullptr;
+      return RC::SUCCESS;
     }
 
-    rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, left_key, current_frame_);
-    if (rc == RC::EMPTY) {
-      rc             = RC::SUCCESS;
+    rc = latch_memo.get_page(next_page_num, current_frame_);
+    if (OB_FAIL(rc)) {
       current_frame_ = nullptr;
-      return rc;
-    } else if (OB_FAIL(rc)) {
-      LOG_WARN("failed to find left page. rc=%s", strrc(rc));
+      LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
       return rc;
     }
+    latch_memo.slatch(current_frame_);
 
-    LeafIndexNodeHandler left_node(mtr_, tree_handler_.file_header_, current_frame_);
-    int                  left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
-    // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
-    if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
-      const PageNum next_page_num = left_node.next_page();
-      if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
-        latch_memo.release();
-        current_frame_ = nullptr;
-        return RC::SUCCESS;
-      }
+    left_index = 0;
+  }
+  iter_index_ = left_index;
+  return RC::SUCCESS;
+}
 
-      rc = latch_memo.get_page(next_page_num, current_frame_);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-        return rc;
+RC BplusTreeScanner::open_backward(const char *right_key, bool right_inclusive)
+{
+  LatchMemo &latch_memo = mtr_.latch_memo();
+
+  RC rc = RC::SUCCESS;
+  if (nullptr == right_key) {
+    rc = tree_handler_.right_most_page(mtr_, current_frame_);
+    if (OB_FAIL(rc)) {
+      current_frame_ = nullptr;
+      if (rc == RC::EMPTY) {
+        return RC::SUCCESS;
       }
-      latch_memo.slatch(current_frame_);
 
-      left_index = 0;
+      LOG_WARN("failed to find right most page. rc=%s", strrc(rc));
+      return rc;
     }
-    iter_index_ = left_index;
+
+    LeafIndexNodeHandler right_node(mtr_, tree_handler_.file_header_, current_frame_);
+    iter_index_ = right_node.size() - 1;
+    return RC::SUCCESS;
   }
 
-  // 没有指定右边界范围，那么就返回右边界最大值
-  if (nullptr == right_user_key) {
-    right_key_ = nullptr;
-  } else {
+  // 与正向扫描的左边界相反，包含右边界时RID取最大值，这样边界上的数据都在查找位置的左边
+  MemPoolItem::item_unique_ptr right_pkey =
+      tree_handler_.make_key(right_key, right_inclusive ? *RID::max() : *RID::min());
+  const char *right_full_key = (const char *)right_pkey.get();
 
-    char *fixed_right_key          = const_cast<char *>(right_user_key);
-    bool  should_include_after_fix = false;
-    if (tree_handler_.file_header_.attr_type == AttrType::CHARS) {
-      rc = fix_user_key(right_user_key, right_len, false /*want_greater*/, &fixed_right_key, &should_include_after_fix);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fix right user key. rc=%s", strrc(rc));
-        return rc;
-      }
+  rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, right_full_key, current_frame_);
+  if (rc == RC::EMPTY) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    current_frame_ = nullptr;
+    LOG_WARN("failed to find right page. rc=%s", strrc(rc));
+    return rc;
+  }
 
-      if (should_include_after_fix) {
-        right_inclusive = true;
-      }
-    }
-    if (right_inclusive) {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::max());
-    } else {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::min());
-    }
+  // lookup 返回的是适合插入的位置，前一个位置才是扫描的第一条数据
+  LeafIndexNodeHandler right_node(mtr_, tree_handler_.file_header_, current_frame_);
+  iter_index_ = right_node.lookup(tree_handler_.key_comparator_, right_full_key) - 1;
+  if (iter_index_ >= 0) {
+    return RC::SUCCESS;
+  }
 
-    if (fixed_right_key != right_user_key) {
-      delete[] fixed_right_key;
-      fixed_right_key = nullptr;
-    }
+  // 在当前页的最左边，就要移动到前一页的最后一条数据
+  const PageNum prev_page_num = right_node.prev_page();
+  if (prev_page_num == BP_INVALID_PAGE_NUM) {
+    latch_memo.release();
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
   }
 
-  if (touch_end()) {
+  const int memo_point = latch_memo.memo_point();
+  rc                   = latch_memo.get_page(prev_page_num, current_frame_);
+  if (OB_FAIL(rc)) {
     current_frame_ = nullptr;
+    LOG_WARN("failed to fetch prev page. page num=%d, rc=%s", prev_page_num, strrc(rc));
+    return rc;
+  }
+
+  // 向左访问兄弟节点与修改时加锁的顺序相反，不能等待，参考 next_entry
+  if (!latch_memo.try_slatch(current_frame_)) {
+    current_frame_ = nullptr;
+    return RC::LOCKED_NEED_WAIT;
   }
+  latch_memo.release_to(memo_point);
 
+  LeafIndexNodeHandler prev_node(mtr_, tree_handler_.file_header_, current_frame_);
+  iter_index_ = prev_node.size() - 1;
   return RC::SUCCESS;
 }
 
@@ -1973,15 +2931,19 @@ void BplusTreeScanner::fetch_item(RID &rid)
 
 bool BplusTreeScanner::touch_end()
 {
-  if (right_key_ == nullptr) {
+  if (end_key_ == nullptr) {
     return false;
   }
 
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
 
   const char *this_key       = node.key_at(iter_index_);
-  int         compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(right_key_.get()));
-  return compare_result > 0;
+  int         compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(end_key_.get()));
+  // 唯一索引的键值中的RID就是 RID::min()，不包含右边界时相等也要结束
+  if (reverse_) {
+    return end_inclusive_ ? compare_result < 0 : compare_result <= 0;
+  }
+  return end_inclusive_ ? compare_result > 0 : compare_result >= 0;
 }
 
 RC BplusTreeScanner::next_entry(RID &rid)
@@ -1996,6 +2958,10 @@ RC BplusTreeScanner::next_entry(RID &rid)
     return RC::SUCCESS;
   }
 
+  if (reverse_) {
+    return prev_entry(rid);
+  }
+
   iter_index_++;
 
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
@@ -2038,6 +3004,61 @@ RC BplusTreeScanner::next_entry(RID &rid)
   return next_entry(rid);
 }
 
+RC BplusTreeScanner::prev_entry(RID &rid)
+{
+  iter_index_--;
+  if (iter_index_ >= 0) {
+    if (touch_end()) {
+      return RC::RECORD_EOF;
+    }
+
+    fetch_item(rid);
+    return RC::SUCCESS;
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  const PageNum        prev_page_num = node.prev_page();
+  if (BP_INVALID_PAGE_NUM == prev_page_num) {
+    return RC::RECORD_EOF;
+  }
+
+  LatchMemo &latch_memo = mtr_.latch_memo();
+
+  const int memo_point = latch_memo.memo_point();
+  RC        rc         = latch_memo.get_page(prev_page_num, current_frame_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get prev page. page num=%d, rc=%s", prev_page_num, strrc(rc));
+    return rc;
+  }
+
+  // 与 next_entry 一样，加锁失败时由上层做重试。持有当前节点的锁时，它的前一个兄弟节点不会变化
+  bool locked = latch_memo.try_slatch(current_frame_);
+  if (!locked) {
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  latch_memo.release_to(memo_point);
+  LeafIndexNodeHandler prev_node(mtr_, tree_handler_.file_header_, current_frame_);
+  iter_index_ = prev_node.size();  // `prev` will sub 1
+  return prev_entry(rid);
+}
+
+RC BplusTreeScanner::next_entry(RID &rid, const char *&key, const char *&include)
+{
+  RC rc = next_entry(rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const IndexFileHeader &header = tree_handler_.file_header_;
+  LeafIndexNodeHandler   node(mtr_, header, current_frame_);
+  current_key_.resize(header.key_length);
+  memcpy(current_key_.data(), node.key_at(iter_index_), header.key_length);
+  key     = current_key_.data();
+  include = header.include_length > 0 ? node.value_at(iter_index_) + sizeof(RID) : nullptr;
+  return RC::SUCCESS;
+}
+
 RC BplusTreeScanner::close()
 {
   inited_ = false;
@@ -2095,3 +3116,326 @@ RC BplusTreeScanner::fix_user_key(
   *fixed_key = key_buf;
   return RC::SUCCESS;
 }
+
+/**
+ * @brief 用字段类型的最小值或最大值填充键值中的一个字段
+ */
+static void fill_attr_bound(AttrType attr_type, int attr_length, bool want_max, char *data)
+{
+  switch (attr_type) {
+    case AttrType::INTS: {
+      int value = want_max ? numeric_limits<int>::max() : numeric_limits<int>::min();
+      memcpy(data, &value, min(attr_length, static_cast<int>(sizeof(value))));
+    } break;
+    case AttrType::FLOATS: {
+      float value = want_max ? numeric_limits<float>::infinity() : -numeric_limits<float>::infinity();
+      memcpy(data, &value, min(attr_length, static_cast<int>(sizeof(value))));
+    } break;
+    default: {
+      // 字符串按照无符号字节比较
+      memset(data, want_max ? 0xFF : 0, attr_length);
+    } break;
+  }
+}
+
+RC BplusTreeScanner::fill_user_key(const char *user_key, int key_len, bool want_max, char **fixed_key)
+{
+  const AttrComparator &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+
+  // 找出 user_key 完整包含了前几个字段
+  int prefix_num = 0;
+  while (prefix_num < attr_comparator.attr_num() &&
+         attr_comparator.attr_offset(prefix_num) + attr_comparator.attr_length(prefix_num) <= key_len) {
+    prefix_num++;
+  }
+
+  char *key_buf = new char[attr_comparator.attr_length()];
+  if (prefix_num > 0) {
+    memcpy(key_buf, user_key, attr_comparator.attr_offset(prefix_num - 1) + attr_comparator.attr_length(prefix_num - 1));
+  }
+  for (int i = prefix_num; i < attr_comparator.attr_num(); i++) {
+    fill_attr_bound(attr_comparator.attr_type(i),
+        attr_comparator.attr_length(i),
+        want_max,
+        key_buf + attr_comparator.attr_offset(i));
+  }
+
+  *fixed_key = key_buf;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::fix_bound_key(const char *user_key, int key_len, bool is_left, bool &inclusive, char **fixed_key)
+{
+  const IndexFileHeader &header = tree_handler_.file_header_;
+  if (header.attr_count() > 1) {
+    // 只给出了前几个字段时，剩下的字段取最小值还是最大值，要看边界是否包含在内
+    // 比如左边界 >= (1) 相当于 >= (1, 最小值)，左边界 > (1) 相当于 > (1, 最大值)
+    const bool want_max = is_left ? !inclusive : inclusive;
+    return fill_user_key(user_key, key_len, want_max, fixed_key);
+  }
+
+  if (header.attr_type == AttrType::CHARS) {
+    bool should_inclusive_after_fix = false;
+    RC   rc = fix_user_key(user_key, key_len, is_left /*want_greater*/, fixed_key, &should_inclusive_after_fix);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (should_inclusive_after_fix) {
+      inclusive = true;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BplusTreeBulkBuilder::BplusTreeBulkBuilder(BplusTreeHandler &tree_handler, float fill_factor /* = 1.0f */)
+    : tree_handler_(tree_handler), fill_factor_(min(1.0f, max(MIN_FILL_FACTOR, fill_factor))), mtr_(tree_handler)
+{}
+
+BplusTreeBulkBuilder::~BplusTreeBulkBuilder()
+{
+  // 没有调用 finish 或者 finish 失败了，这些页面不会被用到
+  for (Level &level : levels_) {
+    if (level.frame != nullptr) {
+      tree_handler_.disk_buffer_pool_->unpin_page(level.frame);
+      level.frame = nullptr;
+    }
+  }
+}
+
+RC BplusTreeBulkBuilder::allocate_node(bool leaf, Frame *&frame)
+{
+  RC rc = tree_handler_.disk_buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate page while building bplus tree. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  IndexNodeHandler node(mtr_, tree_handler_.file_header_, frame);
+  node.init_empty(leaf);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkBuilder::append(const char *user_key, const RID &rid, const char *include /* = nullptr */)
+{
+  const IndexFileHeader &header = tree_handler_.file_header_;
+
+  RC rc = RC::SUCCESS;
+  if (levels_.empty()) {
+    if (!tree_handler_.is_empty()) {
+      LOG_WARN("cannot bulk build a bplus tree which is not empty");
+      return RC::INVALID_ARGUMENT;
+    }
+
+    Frame *frame = nullptr;
+    rc           = allocate_node(true /*leaf*/, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    levels_.emplace_back();
+    levels_[0].frame = frame;
+    item_.resize(header.key_length + sizeof(RID) + header.include_length);
+    separator_.resize(header.key_length);
+  }
+
+  if (header.include_length > 0 && include == nullptr) {
+    LOG_WARN("include data is empty while building bplus tree. include length=%d", header.include_length);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 叶子节点的元素是 | attr | rid | rid | include |，前两部分是键值
+  memcpy(item_.data(), user_key, header.attr_length);
+  memcpy(item_.data() + header.attr_length, &tree_handler_.key_rid(rid), sizeof(RID));
+  memcpy(item_.data() + header.key_length, &rid, sizeof(RID));
+  if (header.include_length > 0) {
+    memcpy(item_.data() + header.key_length + sizeof(RID), include, header.include_length);
+  }
+
+  LeafIndexNodeHandler leaf_node(mtr_, header, levels_[0].frame);
+  if (leaf_node.size() > 0) {
+    const char *last_key = leaf_node.key_at(leaf_node.size() - 1);
+    const int result = tree_handler_.key_comparator_(last_key, item_.data());
+    if (result == 0 && header.unique_keys) {
+      LOG_WARN("duplicate key while building unique bplus tree. rid=%s", rid.to_string().c_str());
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+    if (result >= 0) {
+      LOG_WARN("keys are not in ascending order while building bplus tree. rid=%s", rid.to_string().c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  if (!leaf_node.has_room_for(item_.data(), 1, fill_factor_)) {
+    tree_handler_.make_separator(leaf_node.key_at(leaf_node.size() - 1), item_.data(), separator_.data());
+
+    Frame *new_frame = nullptr;
+    rc               = allocate_node(true /*leaf*/, new_frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    PageNum       parent_page_num = BP_INVALID_PAGE_NUM;
+    const PageNum prev_page_num   = levels_[0].frame->page_num();
+    rc = add_child(1, separator_.data(), new_frame->page_num(), parent_page_num);
+    if (OB_SUCC(rc)) {
+      rc = finish_node(0, new_frame->page_num());
+    }
+    if (OB_FAIL(rc)) {
+      tree_handler_.disk_buffer_pool_->unpin_page(new_frame);
+      return rc;
+    }
+
+    levels_[0].prev_page_num   = prev_page_num;
+    levels_[0].frame           = new_frame;
+    levels_[0].parent_page_num = parent_page_num;
+  }
+
+  LeafIndexNodeHandler current_leaf(mtr_, header, levels_[0].frame);
+  return current_leaf.recover_insert_items(current_leaf.size(), item_.data(), 1);
+}
+
+RC BplusTreeBulkBuilder::add_child(int level, const char *key, PageNum child_page_num, PageNum &parent_page_num)
+{
+  const IndexFileHeader &header = tree_handler_.file_header_;
+
+  vector<char> item(header.key_length + sizeof(PageNum));
+
+  RC rc = RC::SUCCESS;
+  if (level == static_cast<int>(levels_.size())) {
+    // 下一层出现了第二个节点，需要新增一层，第一个子节点就是下一层原来的节点
+    Frame *frame = nullptr;
+    rc           = allocate_node(false /*leaf*/, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    levels_.emplace_back();
+    levels_[level].frame = frame;
+
+    // 内部节点的第一个键值是没有用的，与第二个键值相同，不影响公共前缀
+    const PageNum first_child = levels_[level - 1].frame->page_num();
+    memcpy(item.data(), key, header.key_length);
+    memcpy(item.data() + header.key_length, &first_child, sizeof(PageNum));
+
+    InternalIndexNodeHandler new_node(mtr_, header, levels_[level].frame);
+    rc = new_node.recover_insert_items(0, item.data(), 1);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    levels_[level - 1].parent_page_num = levels_[level].frame->page_num();
+  } else {
+    InternalIndexNodeHandler node(mtr_, header, levels_[level].frame);
+    if (!node.has_room_for(key, 1, fill_factor_)) {
+      Frame *new_frame = nullptr;
+      rc               = allocate_node(false /*leaf*/, new_frame);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      PageNum new_parent_page_num = BP_INVALID_PAGE_NUM;
+      rc = add_child(level + 1, key, new_frame->page_num(), new_parent_page_num);
+      if (OB_SUCC(rc)) {
+        rc = finish_node(level, BP_INVALID_PAGE_NUM);
+      }
+      if (OB_FAIL(rc)) {
+        tree_handler_.disk_buffer_pool_->unpin_page(new_frame);
+        return rc;
+      }
+
+      levels_[level].frame           = new_frame;
+      levels_[level].parent_page_num = new_parent_page_num;
+    }
+  }
+
+  memcpy(item.data(), key, header.key_length);
+  memcpy(item.data() + header.key_length, &child_page_num, sizeof(PageNum));
+  InternalIndexNodeHandler node(mtr_, header, levels_[level].frame);
+  rc = node.recover_insert_items(node.size(), item.data(), 1);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  parent_page_num = levels_[level].frame->page_num();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkBuilder::finish_node(int level, PageNum next_page_num)
+{
+  Level &node = levels_[level];
+
+  BplusTreeMiniTransaction mtr(tree_handler_);
+  unique_ptr<IndexNodeHandler> node_handler;
+  RC                           rc = RC::SUCCESS;
+
+  // 页面上已经有所有的元素了，复制出来之后按照正常的方式重新写一遍，这样才会记录日志
+  vector<char> items;
+  int          item_num = 0;
+  if (level == 0) {
+    auto leaf_node = make_unique<LeafIndexNodeHandler>(mtr, tree_handler_.file_header_, node.frame);
+    item_num       = leaf_node->size();
+    leaf_node->copy_items(0, item_num, items);
+    rc = leaf_node->init_empty();
+    if (OB_SUCC(rc) && next_page_num != BP_INVALID_PAGE_NUM) {
+      rc = leaf_node->set_next_page(next_page_num);
+    }
+    if (OB_SUCC(rc) && node.prev_page_num != BP_INVALID_PAGE_NUM) {
+      rc = leaf_node->set_prev_page(node.prev_page_num);
+    }
+    node_handler = std::move(leaf_node);
+  } else {
+    auto internal_node = make_unique<InternalIndexNodeHandler>(mtr, tree_handler_.file_header_, node.frame);
+    item_num           = internal_node->size();
+    internal_node->copy_items(0, item_num, items);
+    rc           = internal_node->init_empty();
+    node_handler = std::move(internal_node);
+  }
+
+  if (OB_SUCC(rc)) {
+    rc = node_handler->bulk_append(items.data(), item_num);
+  }
+  if (OB_SUCC(rc) && node.parent_page_num != BP_INVALID_PAGE_NUM) {
+    rc = node_handler->set_parent_page_num(node.parent_page_num);
+  }
+
+  if (OB_SUCC(rc)) {
+    node.frame->mark_dirty();
+    rc = mtr.commit();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to finish node while building bplus tree. page num=%d, rc=%s", node.frame->page_num(), strrc(rc));
+    return rc;
+  }
+
+  tree_handler_.disk_buffer_pool_->unpin_page(node.frame);
+  node.frame = nullptr;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkBuilder::finish()
+{
+  if (levels_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const PageNum root_page_num = levels_.back().frame->page_num();
+  for (int level = 0; level < static_cast<int>(levels_.size()); level++) {
+    RC rc = finish_node(level, BP_INVALID_PAGE_NUM);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  BplusTreeMiniTransaction mtr(tree_handler_);
+  tree_handler_.update_root_page_num_locked(mtr, root_page_num);
+  RC rc = mtr.commit();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to update root page while building bplus tree. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("bulk build bplus tree done. root page=%d, height=%d, fill factor=%.2f",
+           root_page_num, static_cast<int>(levels_.size()), fill_factor_);
+  levels_.clear();
+  return RC::SUCCESS;
+}
@@ -22,6 +22,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/comparator.h"
 #include "common/lang/memory.h"
 #include "common/lang/sstream.h"
+#include "common/lang/span.h"
+#include "common/lang/vector.h"
 #include "common/lang/functional.h"
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
@@ -29,6 +31,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/record/record_manager.h"
 #include "storage/index/latch_memo.h"
 #include "storage/index/bplus_tree_log.h"
+#include "storage/index/numeric_key_search.h"
+#include "storage/index/typed_key_comparator.h"
 
 class BplusTreeHandler;
 class BplusTreeMiniTransaction;
@@ -56,44 +60,177 @@ enum class BplusTreeOperationType
 class AttrComparator
 {
 public:
-  void init(AttrType type, int length)
+  void init(AttrType type, int length) { init(span<const AttrType>(&type, 1), span<const int>(&length, 1)); }
+
+  /**
+   * @brief 初始化多个字段组成的键值的比较器
+   * @details 键值是各个字段的数据依次拼接起来的，按照字段顺序逐个比较
+   */
+  void init(span<const AttrType> types, span<const int> lengths)
   {
-    attr_type_   = type;
-    attr_length_ = length;
+    attrs_.clear();
+    attr_length_ = 0;
+    for (size_t i = 0; i < types.size(); i++) {
+      attrs_.push_back(AttrDesc{types[i], lengths[i], attr_length_, compare_func_of(types[i])});
+      attr_length_ += lengths[i];
+    }
   }
 
   int attr_length() const { return attr_length_; }
+  int attr_num() const { return static_cast<int>(attrs_.size()); }
 
-  int operator()(const char *v1, const char *v2) const
+  AttrType attr_type(int index) const { return attrs_[index].type; }
+  int      attr_length(int index) const { return attrs_[index].length; }
+  int      attr_offset(int index) const { return attrs_[index].offset; }
+
+  int operator()(const char *v1, const char *v2) const { return compare(v1, v2, attr_num()); }
+
+  /**
+   * @brief 只比较前 attr_num 个字段
+   */
+  int compare(const char *v1, const char *v2, int attr_num) const
   {
-    // TODO: optimized the comparison
-    Value left;
-    left.set_type(attr_type_);
-    left.set_data(v1, attr_length_);
-    Value right;
-    right.set_type(attr_type_);
-    right.set_data(v2, attr_length_);
-    return DataType::type_instance(attr_type_)->compare(left, right);
+    for (int i = 0; i < attr_num; i++) {
+      const AttrDesc &attr   = attrs_[i];
+      const int       result = attr.compare(v1 + attr.offset, v2 + attr.offset, attr.length);
+      if (result != 0) {
+        return result;
+      }
+    }
+    return 0;
   }
 
 private:
-  AttrType attr_type_;
-  int      attr_length_;
+  using CompareFunc = int (*)(const char *, const char *, int);
+
+  /// @brief 初始化时按照字段类型选好比较函数，比较时不再判断类型
+  static CompareFunc compare_func_of(AttrType type)
+  {
+    switch (type) {
+      case AttrType::CHARS: return &AttrCompare<AttrType::CHARS>::compare;
+      case AttrType::INTS: return &AttrCompare<AttrType::INTS>::compare;
+      case AttrType::FLOATS: return &AttrCompare<AttrType::FLOATS>::compare;
+      case AttrType::VECTORS: return &AttrCompare<AttrType::VECTORS>::compare;
+      case AttrType::BOOLEANS: return &AttrCompare<AttrType::BOOLEANS>::compare;
+      default: return &AttrCompare<AttrType::UNDEFINED>::compare;
+    }
+  }
+
+  struct AttrDesc
+  {
+    AttrType    type;
+    int         length;
+    int         offset;   ///< 在键值中的偏移量
+    CompareFunc compare;  ///< 这个字段的比较函数
+  };
+
+  vector<AttrDesc> attrs_;
+  int              attr_length_ = 0;  ///< 所有字段的总长度
 };
 
 /**
  * @brief 键值比较(BplusTree)
  * @details BplusTree的键值除了字段属性，还有RID，是为了避免属性值重复而增加的。
+ * 只有一个字段时，初始化(打开或创建索引)时就根据字段类型选好 TypedKeyComparator 的实例，
+ * CHARS 类型对常见的长度也有单独的实例。需要大量比较的循环使用 visit 拿到具体类型的比较器，
+ * 比较可以内联；单独的一次比较通过初始化时选好的函数指针调用，也不再需要判断类型。
  * @ingroup BPlusTree
  */
 class KeyComparator
 {
 public:
-  void init(AttrType type, int length) { attr_comparator_.init(type, length); }
+  void init(AttrType type, int length) { init(span<const AttrType>(&type, 1), span<const int>(&length, 1)); }
+  void init(span<const AttrType> types, span<const int> lengths)
+  {
+    attr_comparator_.init(types, lengths);
+    search_method_ = key_search_method_of(types, lengths);
+    kind_          = kind_of(types, lengths);
+
+    switch (kind_) {
+      case Kind::INTS: compare_func_ = &TypedKeyComparator<AttrType::INTS>::compare; break;
+      case Kind::FLOATS: compare_func_ = &TypedKeyComparator<AttrType::FLOATS>::compare; break;
+      case Kind::CHARS: compare_func_ = &TypedKeyComparator<AttrType::CHARS>::compare; break;
+      case Kind::CHARS_4: compare_func_ = &TypedKeyComparator<AttrType::CHARS, 4>::compare; break;
+      case Kind::CHARS_8: compare_func_ = &TypedKeyComparator<AttrType::CHARS, 8>::compare; break;
+      case Kind::CHARS_16: compare_func_ = &TypedKeyComparator<AttrType::CHARS, 16>::compare; break;
+      case Kind::CHARS_32: compare_func_ = &TypedKeyComparator<AttrType::CHARS, 32>::compare; break;
+      default: compare_func_ = nullptr; break;
+    }
+  }
 
   const AttrComparator &attr_comparator() const { return attr_comparator_; }
 
+  /// @brief 在节点中查找键值的方式，数值类型的键值有专门的查找方法
+  KeySearchMethod search_method() const { return search_method_; }
+
   int operator()(const char *v1, const char *v2) const
+  {
+    if (compare_func_ != nullptr) {
+      return compare_func_(v1, v2, attr_comparator_.attr_length());
+    }
+    return generic_compare(v1, v2);
+  }
+
+  /**
+   * @brief 使用具体类型的比较器调用 func
+   * @details func 的参数是一个可以像 KeyComparator 一样调用的比较器。只有一个字段时是 TypedKeyComparator，
+   * 否则就是当前对象。func 会对每种比较器实例化一次，所以只在一次调用中会比较很多次的地方使用。
+   */
+  template <typename Func>
+  decltype(auto) visit(Func &&func) const
+  {
+    const int attr_length = attr_comparator_.attr_length();
+    switch (kind_) {
+      case Kind::INTS: return func(TypedKeyComparator<AttrType::INTS>(attr_length));
+      case Kind::FLOATS: return func(TypedKeyComparator<AttrType::FLOATS>(attr_length));
+      case Kind::CHARS: return func(TypedKeyComparator<AttrType::CHARS>(attr_length));
+      case Kind::CHARS_4: return func(TypedKeyComparator<AttrType::CHARS, 4>(attr_length));
+      case Kind::CHARS_8: return func(TypedKeyComparator<AttrType::CHARS, 8>(attr_length));
+      case Kind::CHARS_16: return func(TypedKeyComparator<AttrType::CHARS, 16>(attr_length));
+      case Kind::CHARS_32: return func(TypedKeyComparator<AttrType::CHARS, 32>(attr_length));
+      default: return func(*this);
+    }
+  }
+
+private:
+  /**
+   * @brief 比较器的种类，GENERIC 表示多个字段或者没有特化的类型
+   */
+  enum class Kind
+  {
+    GENERIC,
+    INTS,
+    FLOATS,
+    CHARS,  ///< 长度在运行时确定
+    CHARS_4,
+    CHARS_8,
+    CHARS_16,
+    CHARS_32,
+  };
+
+  static Kind kind_of(span<const AttrType> types, span<const int> lengths)
+  {
+    if (types.size() != 1) {
+      return Kind::GENERIC;
+    }
+
+    switch (types[0]) {
+      case AttrType::INTS: return Kind::INTS;
+      case AttrType::FLOATS: return Kind::FLOATS;
+      case AttrType::CHARS: {
+        switch (lengths[0]) {
+          case 4: return Kind::CHARS_4;
+          case 8: return Kind::CHARS_8;
+          case 16: return Kind::CHARS_16;
+          case 32: return Kind::CHARS_32;
+          default: return Kind::CHARS;
+        }
+      }
+      default: return Kind::GENERIC;
+    }
+  }
+
+  int generic_compare(const char *v1, const char *v2) const
   {
     int result = attr_comparator_(v1, v2);
     if (result != 0) {
@@ -106,7 +243,12 @@ public:
   }
 
 private:
-  AttrComparator attr_comparator_;
+  using CompareFunc = int (*)(const char *, const char *, int);
+
+  AttrComparator  attr_comparator_;
+  KeySearchMethod search_method_ = KeySearchMethod::GENERIC;
+  Kind            kind_          = Kind::GENERIC;
+  CompareFunc     compare_func_  = nullptr;  ///< 只有一个字段时使用的比较函数
 };
 
 /**
@@ -116,23 +258,38 @@ private:
 class AttrPrinter
 {
 public:
-  void init(AttrType type, int length)
+  void init(AttrType type, int length) { init(span<const AttrType>(&type, 1), span<const int>(&length, 1)); }
+
+  void init(span<const AttrType> types, span<const int> lengths)
   {
-    attr_type_   = type;
-    attr_length_ = length;
+    attr_types_.assign(types.begin(), types.end());
+    attr_lengths_.assign(lengths.begin(), lengths.end());
+    attr_length_ = 0;
+    for (int length : lengths) {
+      attr_length_ += length;
+    }
   }
 
   int attr_length() const { return attr_length_; }
 
   string operator()(const char *v) const
   {
-    Value value(attr_type_, const_cast<char *>(v), attr_length_);
-    return value.to_string();
+    string result;
+    for (size_t i = 0; i < attr_types_.size(); i++) {
+      Value value(attr_types_[i], const_cast<char *>(v), attr_lengths_[i]);
+      if (i > 0) {
+        result += ",";
+      }
+      result += value.to_string();
+      v += attr_lengths_[i];
+    }
+    return result;
   }
 
 private:
-  AttrType attr_type_;
-  int      attr_length_;
+  vector<AttrType> attr_types_;
+  vector<int>      attr_lengths_;
+  int              attr_length_ = 0;
 };
 
 /**
@@ -143,6 +300,7 @@ class KeyPrinter
 {
 public:
   void init(AttrType type, int length) { attr_printer_.init(type, length); }
+  void init(span<const AttrType> types, span<const int> lengths) { attr_printer_.init(types, lengths); }
 
   const AttrPrinter &attr_printer() const { return attr_printer_; }
 
@@ -164,10 +322,12 @@ private:
  * @brief the meta information of bplus tree
  * @ingroup BPlusTree
  * @details this is the first page of bplus tree.
- * only one field can be supported, can you extend it to multi-fields?
+ * 键值可以由多个字段组成，各个字段的数据依次拼接在一起。
  */
 struct IndexFileHeader
 {
+  static constexpr int MAX_ATTR_NUM = 8;  ///< 键值最多包含的字段数
+
   IndexFileHeader()
   {
     memset(this, 0, sizeof(IndexFileHeader));
@@ -176,9 +336,28 @@ struct IndexFileHeader
   PageNum  root_page;          ///< 根节点在磁盘中的页号
   int32_t  internal_max_size;  ///< 内部节点最大的键值对数
   int32_t  leaf_max_size;      ///< 叶子节点最大的键值对数
-  int32_t  attr_length;        ///< 键值的长度
+  int32_t  attr_length;        ///< 键值的长度，所有字段长度的和
   int32_t  key_length;         ///< attr length + sizeof(RID)
-  AttrType attr_type;          ///< 键值的类型
+  AttrType attr_type;          ///< 第一个字段的类型
+  int32_t  attr_num;           ///< 键值包含的字段数。只支持单个字段时创建的文件中是0，当作1个字段处理
+  AttrType attr_types[MAX_ATTR_NUM];    ///< 每个字段的类型
+  int32_t  attr_lengths[MAX_ATTR_NUM];  ///< 每个字段的长度
+  int32_t  key_compression;             ///< 节点中的键值是否压缩存放，参考 IndexNodeKeyLayout。之前创建的文件中是0
+  int32_t  separate_leaf_values;        ///< 叶子节点中的键值和值是否分开存放，参考 LeafIndexNode。之前创建的文件中是0
+  int32_t  include_length;              ///< 叶子节点的值中RID之后附带的数据长度，参考 LeafIndexNode。之前创建的文件中是0
+  int32_t  unique_keys;                 ///< 是否是唯一索引，参考 LeafIndexNode。之前创建的文件中是0
+  int32_t  prev_leaf_links;             ///< 叶子节点是否记录了前一个兄弟节点，参考 LeafIndexNode。之前创建的文件中是0
+
+  int attr_count() const { return attr_num == 0 ? 1 : attr_num; }
+
+  span<const AttrType> attr_type_list() const
+  {
+    return attr_num == 0 ? span<const AttrType>(&attr_type, 1) : span<const AttrType>(attr_types, attr_num);
+  }
+  span<const int> attr_length_list() const
+  {
+    return attr_num == 0 ? span<const int>(&attr_length, 1) : span<const int>(attr_lengths, attr_num);
+  }
 
   const string to_string() const
   {
@@ -187,6 +366,12 @@ struct IndexFileHeader
     ss << "attr_length:" << attr_length << ","
        << "key_length:" << key_length << ","
        << "attr_type:" << attr_type_to_string(attr_type) << ","
+       << "attr_num:" << attr_count() << ","
+       << "key_compression:" << key_compression << ","
+       << "separate_leaf_values:" << separate_leaf_values << ","
+       << "include_length:" << include_length << ","
+       << "unique_keys:" << unique_keys << ","
+       << "prev_leaf_links:" << prev_leaf_links << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
        << "leaf_max_size:" << leaf_max_size << ";";
@@ -224,12 +409,32 @@ struct IndexNode
  * so the key in leaf page must be unique.
  * the value is rid.
  * can you implenment a cluster index ?
+ *
+ * 如果 IndexFileHeader::include_length 不是0，值是 RID 后面再跟着这么长的数据，
+ * 通常是索引的包含字段(INCLUDE)，覆盖索引扫描时不用再读取记录，参考 BplusTreeScanner::next_entry。
+ *
+ * 如果 IndexFileHeader::unique_keys 不是0，键值中的 rid 都是 RID::min()，真正的RID只存放在值中。
+ * 这样相同的 key value 就是相同的键值，插入时查找叶子节点的同时就能发现重复，也不会分散在多个节点中。
+ *
+ * IndexFileHeader::prev_leaf_links 是0的文件(之前创建的)中没有 prev page id，元素紧跟在 next page id 后面，
+ * 这样的B+树不能反向扫描，参考 BplusTreeScanner::open。
+ *
+ * 如果 IndexFileHeader::separate_leaf_values 不是0，键值和值分开存放。键值从前向后连续存放，
+ * 值从页面末尾向前存放，第i个值在页面末尾往前数第i+1个位置。
+ * 这样节点内二分查找时访问的只有键值，每次比较浪费的缓存行更少。
+ * 键值部分与不分开存放时一样，可能是压缩过的，参考 IndexNodeKeyLayout。
+ * @code
+ * | common header | prev page id | next page id |
+ * | key0 | key1 | ... | keyn | (free space) | ridn | ... | rid1 | rid0 |
+ * @endcode
  */
 struct LeafIndexNode : public IndexNode
 {
-  static constexpr int HEADER_SIZE = IndexNode::HEADER_SIZE + 4;
+  static constexpr int HEADER_SIZE         = IndexNode::HEADER_SIZE + 8;
+  static constexpr int NO_PREV_HEADER_SIZE = IndexNode::HEADER_SIZE + 4;  ///< 没有 prev_brother 时的头部长度
 
   PageNum next_brother;
+  PageNum prev_brother;  ///< 只有 IndexFileHeader::prev_leaf_links 不是0时才有
   /**
    * leaf can store order keys and rids at most
    */
@@ -246,6 +451,7 @@ struct LeafIndexNode : public IndexNode
  * @endcode
  * the first key is ignored(key0).
  * so it will waste space, can you fix this?
+ * 开启键值压缩后，key0 与 key1 相同，不会影响节点的公共前缀。
  */
 struct InternalIndexNode : public IndexNode
 {
@@ -257,6 +463,28 @@ struct InternalIndexNode : public IndexNode
   char array[0];
 };
 
+/**
+ * @brief 节点中键值的压缩格式
+ * @ingroup BPlusTree
+ * @details 开启键值压缩时，节点数组的开头是这个结构，后面跟着节点的公共前缀，然后才是各个元素。
+ * 节点中所有键值的前 prefix_len 个字节都相同，只保存一份；key_end 之后的字节都是0，也不保存。
+ * 元素中保存的是 key[prefix_len, key_end) + rid + value，每个节点内元素仍然是定长的，
+ * 查找时还是二分查找，只是比较之前要把键值还原出来。
+ * 内部节点中的键值在分裂时会选择最短的分隔键值，末尾大部分是0，参考 BplusTreeHandler::make_separator。
+ * @code
+ * storage format:
+ * | prefix_len | key_end | prefix | item0 | item1 | ... |
+ * @endcode
+ */
+struct IndexNodeKeyLayout
+{
+  static constexpr int HEADER_SIZE = 4;
+
+  int16_t prefix_len;  ///< 公共前缀的长度
+  int16_t key_end;     ///< 所有键值最后一个非0字节之后的位置，不包含RID
+  char    prefix[0];
+};
+
 /**
  * @brief IndexNode 仅作为数据在内存或磁盘中的表示
  * @ingroup BPlusTree
@@ -276,21 +504,40 @@ public:
   /// 是否叶子节点
   bool is_leaf() const;
 
-  /// @brief 存储的键值大小
+  /// @brief 完整的键值大小
   virtual int key_size() const;
-  /// @brief 存储的值的大小。内部节点和叶子节点是不一样的，但是这里返回的是叶子节点存储的大小
+  /// @brief 存储的值的大小。内部节点和叶子节点是不一样的
   virtual int value_size() const;
-  /// @brief 存储的键值对的大小。值是指叶子节点中存放的数据
+  /// @brief 完整的键值对的大小。记录日志和在节点之间移动元素时都使用完整的格式
   virtual int item_size() const;
 
   void    increase_size(int n);
   int     size() const;
+  /// @brief 不压缩时节点最多能放多少个元素。压缩之后可以放更多，参考 has_room_for
   int     max_size() const;
   int     min_size() const;
   RC      set_parent_page_num(PageNum page_num);
   PageNum parent_page_num() const;
   PageNum page_num() const;
 
+  /**
+   * @brief 再放入 new_items 个元素并加入这个键值之后，节点是否还放得下
+   * @details 键值可能让公共前缀变短，或者让 key_end 变大，每个元素都会变长。
+   * new_items 是0时表示替换某个键值
+   * @param fill_factor 只使用节点容量的这个比例，自底向上构建时给之后的插入留出空间
+   */
+  bool has_room_for(const char *key, int new_items = 1, float fill_factor = 1.0f) const;
+
+  /**
+   * @brief 另一个节点的元素能否全部合并到当前节点
+   */
+  bool can_merge(const IndexNodeHandler &other) const;
+
+  /**
+   * @brief 按照完整的格式复制一些元素
+   */
+  void copy_items(int index, int num, vector<char> &items) const;
+
   /**
    * @brief 判断对指定的操作，是否安全的
    * @details 安全是指在操作执行后，节点不需要调整，比如分裂、合并或重新分配
@@ -311,21 +558,87 @@ public:
   RC recover_insert_items(int index, const char *items, int num);
   RC recover_remove_items(int index, int num);
 
+  /**
+   * @brief 在节点最后追加一批元素，只记录一条日志
+   * @details 自底向上构建B+树时使用，不会修改子节点的父节点编号，参考 BplusTreeBulkBuilder
+   */
+  RC bulk_append(const char *items, int num);
+
 protected:
   /**
-   * @brief 获取指定元素的开始内存位置
-   * @note 这并不是一个纯虚函数，是为了可以直接使用 IndexNodeHandler 类。
-   * 但是使用这个类时，注意不能使用与这个函数相关的函数。
+   * @brief 节点中键值的存放方式
+   * @details 不压缩时前缀长度是0，key_end 是字段的长度，元素就是完整的键值对
+   */
+  struct KeyLayout
+  {
+    int prefix_len = 0;
+    int key_end    = 0;
+
+    bool operator==(const KeyLayout &other) const = default;
+  };
+
+  bool      key_compressed() const { return header_.key_compression != 0; }
+  /// 键值和值是否分开存放，只有叶子节点会分开，参考 LeafIndexNode
+  bool      values_separated() const { return header_.separate_leaf_values != 0 && is_leaf(); }
+  KeyLayout key_layout() const;
+  /// 只包含这个键值时的存放方式
+  KeyLayout key_layout_of(const char *key) const;
+  /// 加入一个键值后的存放方式。prefix 是当前的公共前缀
+  KeyLayout merge_key_layout(const KeyLayout &layout, const char *prefix, const char *key) const;
+  /// 按照这种存放方式，节点最多能放多少个元素
+  int       capacity(const KeyLayout &layout) const;
+  /// 按照新的方式重新存放节点中的元素。prefix 是新的公共前缀，可以指向当前节点的页面
+  void      relayout(const KeyLayout &layout, const char *prefix);
+  void      reset_layout();
+  /// 删除一批元素之后，公共前缀可能变长，重新计算存放方式
+  void      shrink_layout();
+
+  /// 节点头部的长度，叶子节点和内部节点不同，叶子节点还与 IndexFileHeader::prev_leaf_links 有关
+  int         header_size() const;
+  /// 存放元素的区域，在节点头部之后
+  char       *node_array() const;
+  const char *prefix() const;
+  int         stored_key_size(const KeyLayout &layout) const;
+  int         stored_item_size(const KeyLayout &layout) const;
+  /// 相邻两个键值在节点中的距离。键值和值分开存放时是键值的大小，否则是整个元素的大小
+  int         key_stride(const KeyLayout &layout) const;
+  /// 把完整格式的元素写到节点的指定位置，调用前要保证当前的存放方式放得下这些键值
+  void        write_items(int index, const char *items, int num);
+  void        encode_key(const char *key, const KeyLayout &layout, char *stored) const;
+  void        decode_key(const char *stored, const KeyLayout &layout, char *key) const;
+
+  /**
+   * @brief 查找第一个不小于key的元素，从begin开始
    */
-  virtual char *__item_at(int index) const { return nullptr; }
-  char         *__key_at(int index) const { return __item_at(index); }
-  char         *__value_at(int index) const { return __item_at(index) + key_size(); };
+  int lower_bound(const KeyComparator &comparator, const char *key, int begin, bool *found) const;
+  /// @brief lower_bound 的实现，Comparator 是 KeyComparator::visit 给出的具体类型的比较器
+  template <typename Comparator>
+  int lower_bound_with(const Comparator &comparator, const char *key, int begin, bool *found) const;
+
+  /**
+   * @brief 获取指定元素在页面中的开始位置，元素可能是压缩过的
+   * @details 键值和值分开存放时，这里只有键值，值要通过 __value_at 获取
+   */
+  char       *__item_at(int index) const;
+  /// 还原出来的完整键值。没有压缩时直接指向页面，否则保存在当前对象的缓存中，再调用两次就会被覆盖
+  const char *__key_at(int index) const;
+  char       *__value_at(int index) const;
 
 protected:
   BplusTreeMiniTransaction &mtr_;
   const IndexFileHeader    &header_;
   Frame                    *frame_ = nullptr;
   IndexNode                *node_  = nullptr;
+
+private:
+  static constexpr int KEY_BUFFER_SIZE = 256;
+
+  /// 还原键值的缓存。有两个，轮流使用，这样可以直接比较两个还原出来的键值
+  char *key_buffer() const;
+
+  mutable char         key_buffer_[KEY_BUFFER_SIZE];
+  mutable vector<char> large_key_buffer_;  ///< 键值比较长时使用
+  mutable int          key_buffer_index_ = 0;
 };
 
 /**
@@ -341,9 +654,13 @@ public:
   RC      init_empty();
   RC      set_next_page(PageNum page_num);
   PageNum next_page() const;
+  /// 没有记录前一个兄弟节点时(IndexFileHeader::prev_leaf_links 是0)什么都不做
+  RC      set_prev_page(PageNum page_num);
+  /// 没有记录前一个兄弟节点时返回 BP_INVALID_PAGE_NUM
+  PageNum prev_page() const;
 
-  char *key_at(int index);
-  char *value_at(int index);
+  const char *key_at(int index) const;
+  char       *value_at(int index);
 
   /**
    * 查找指定key的插入位置(注意不是key本身)
@@ -367,8 +684,6 @@ public:
   friend string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer);
 
 protected:
-  char *__item_at(int index) const override;
-
   RC append(const char *items, int num);
   RC append(const char *item);
   RC preappend(const char *item);
@@ -391,8 +706,8 @@ public:
   RC create_new_root(PageNum first_page_num, const char *key, PageNum page_num);
 
   RC      insert(const char *key, PageNum page_num, const KeyComparator &comparator);
-  char   *key_at(int index);
-  PageNum value_at(int index);
+  const char *key_at(int index) const;
+  PageNum     value_at(int index);
 
   /**
    * 返回指定子节点在当前节点中的索引
@@ -433,15 +748,24 @@ private:
   RC preappend(const char *item);
 
 private:
-  char *__item_at(int index) const override;
-
   int value_size() const override;
-  int item_size() const override;
 
 private:
   InternalIndexNode *internal_node_ = nullptr;
 };
 
+/**
+ * @brief B+树的统计信息
+ * @ingroup BPlusTree
+ */
+struct BplusTreeStat
+{
+  int     height         = 0;  ///< 层数，空树是0
+  int     leaf_pages     = 0;  ///< 叶子节点个数
+  int     internal_pages = 0;  ///< 内部节点个数
+  int64_t entry_num      = 0;  ///< 数据条数
+};
+
 /**
  * @brief B+树的实现
  * @ingroup BPlusTree
@@ -464,6 +788,22 @@ public:
   RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, AttrType attr_type, int attr_length,
       int internal_max_size = -1, int leaf_max_size = -1);
 
+  /**
+   * @brief 创建一个多个字段组成键值的B+树
+   * @param attr_types 每个字段的类型
+   * @param attr_lengths 每个字段的长度
+   * @param key_compression 节点中的键值是否压缩存放，参考 IndexNodeKeyLayout
+   * @param separate_leaf_values 叶子节点中的键值和值是否分开存放，参考 LeafIndexNode
+   * @param include_length 叶子节点中每个元素在RID之后附带的数据长度，参考 LeafIndexNode
+   * @param unique_keys 是否不允许插入相同的 key value，参考 LeafIndexNode
+   */
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, span<const AttrType> attr_types,
+      span<const int> attr_lengths, int internal_max_size = -1, int leaf_max_size = -1, bool key_compression = true,
+      bool separate_leaf_values = true, int include_length = 0, bool unique_keys = false);
+  RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, span<const AttrType> attr_types,
+      span<const int> attr_lengths, int internal_max_size = -1, int leaf_max_size = -1, bool key_compression = true,
+      bool separate_leaf_values = true, int include_length = 0, bool unique_keys = false);
+
   /**
    * @brief 打开一个B+树
    * @param log_handler 记录日志
@@ -483,12 +823,14 @@ public:
    * @details 参数user_key指向要插入的属性值，参数rid标识该索引项对应的元组，
    * 即向索引中插入一个值为（user_key，rid）的键值对
    * @note 这里假设user_key的内存大小与attr_length 一致
+   * @param include 附带在RID之后的数据，长度是 IndexFileHeader::include_length，没有时可以是 nullptr
+   * @return RECORD_DUPLICATE_KEY 数据已经存在，唯一索引中是 user_key 已经存在
    */
-  RC insert_entry(const char *user_key, const RID *rid);
+  RC insert_entry(const char *user_key, const RID *rid, const char *include = nullptr);
 
   /**
    * @brief 从IndexHandle句柄对应的索引中删除一个值为（user_key，rid）的索引项
-   * @return RECORD_INVALID_KEY 指定值不存在
+   * @return RECORD_INVALID_KEY 指定值不存在。唯一索引中 user_key 对应的不是这个 rid 时也不会删除
    * @note 这里假设user_key的内存大小与attr_length 一致
    */
   RC delete_entry(const char *user_key, const RID *rid);
@@ -502,6 +844,15 @@ public:
    */
   RC get_entry(const char *user_key, int key_len, list<RID> &rids);
 
+  /**
+   * @brief 批量查找多个键值对应的record
+   * @details 键值需要从小到大排好序(可以重复)，每个键值都是完整的 attr_length 长度。
+   * 相邻的键值落在同一个叶子节点或者下一个叶子节点时，直接在当前节点上继续查找，不需要每个键值都从根节点
+   * 向下查找一遍。适合 IN 列表或者用另一个表的数据排序之后来查找索引。
+   * @param rids 返回值，与 user_keys 一一对应
+   */
+  RC get_entries(span<const char *const> user_keys, vector<vector<RID>> &rids);
+
   RC sync();
 
   /**
@@ -511,6 +862,12 @@ public:
    */
   bool validate_tree();
 
+  /**
+   * @brief 遍历所有节点，统计层数和节点个数
+   * @note thread unsafe
+   */
+  RC get_stat(BplusTreeStat &stat);
+
 public:
   const IndexFileHeader &file_header() const { return file_header_; }
   DiskBufferPool        &buffer_pool() const { return *disk_buffer_pool_; }
@@ -544,21 +901,54 @@ private:
 
   bool validate_leaf_link(BplusTreeMiniTransaction &mtr);
   bool validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame);
+  RC   stat_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame, int level, BplusTreeStat &stat);
 
 protected:
   /**
    * @brief 查找叶子节点
+   * @details 修改数据时先使用 find_leaf_optimistic 乐观地查找，叶子节点需要分裂或合并时，
+   * 再从根节点开始按照 crabing protocol 加写锁重新查找。
    * @param op 当前想要执行的操作。操作类型不同会在查找的过程中加不同类型的锁
    * @param key 查找的键值
    * @param[out] frame 返回找到的叶子节点
    */
   RC find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame);
 
+  /**
+   * @brief 乐观地查找要修改的叶子节点
+   * @details 大部分插入和删除只修改叶子节点。查找时对 root_lock_ 和内部节点只加读锁，逐层加子节点的锁、
+   * 释放父节点的锁，只对叶子节点加写锁，这样不会修改树结构的操作在根节点附近不会互相阻塞。
+   * 如果叶子节点在这次操作后需要分裂或合并，就释放所有的锁，由调用者使用悲观的方式重新查找。
+   * @param[out] safe 叶子节点是否可以直接修改。不可以时 frame 无效，也没有持有任何锁
+   */
+  RC find_leaf_optimistic(
+      BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame, bool &safe);
+
   /**
    * @brief 找到最左边的叶子节点
    */
   RC left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame);
 
+  /**
+   * @brief 找到最右边的叶子节点
+   */
+  RC right_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame);
+
+  /**
+   * @brief 修改叶子节点的前一个兄弟节点
+   * @details 分裂和合并叶子节点时，右边的兄弟节点也要修改。这个节点在当前节点的右边，
+   * 与扫描时访问兄弟节点的顺序一样，可以直接加锁。page_num 是 BP_INVALID_PAGE_NUM 时什么都不做
+   */
+  RC set_leaf_prev_page(BplusTreeMiniTransaction &mtr, PageNum page_num, PageNum prev_page_num);
+
+  /**
+   * @brief 查找一个键值对应的所有数据，参考 get_entries
+   * @param frame 当前持有读锁的叶子节点，可以为空。返回时是最后访问的叶子节点，用来查找下一个键值
+   * @param seek_key 长度为 key_length 的缓存
+   */
+  RC get_entries_of_key(BplusTreeMiniTransaction &mtr, const char *user_key, char *seek_key, Frame *&frame,
+      vector<RID> &rids);
+
   /**
    * @brief 查找指定的叶子节点
    * @param op 当前想要执行的操作。操作类型不同会在查找的过程中加不同类型的锁
@@ -577,7 +967,7 @@ protected:
   /**
    * @brief 从叶子节点中删除指定的键值对
    */
-  RC delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame *leaf_frame, const char *key);
+  RC delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame *leaf_frame, const char *key, const RID &rid);
 
   /**
    * @brief 拆分节点
@@ -614,13 +1004,14 @@ protected:
 
   /**
    * @brief 在叶子节点插入一个元素
+   * @param value 叶子节点中的值，RID 后面跟着附带的数据
    */
-  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const RID *rid);
+  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const char *value);
 
   /**
    * @brief 创建一个新的B+树
    */
-  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid);
+  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value);
 
   /**
    * @brief 更新根节点的页号
@@ -632,9 +1023,20 @@ protected:
    */
   RC adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame);
 
+  /**
+   * @brief 生成叶子节点分裂后放到父节点中的分隔键值
+   * @details 返回满足 left_key < separator <= right_key 的键值。开启键值压缩时，尽量只保留 right_key
+   * 的前面一部分，后面都填0，这样内部节点的键值末尾大多是0，可以存放更多的元素。
+   * @param[out] separator 长度是 key_length
+   */
+  void make_separator(const char *left_key, const char *right_key, char *separator) const;
+
 private:
   common::MemPoolItem::item_unique_ptr make_key(const char *user_key, const RID &rid);
 
+  /// @brief 数据的键值中存放的RID，唯一索引中都是 RID::min()，参考 LeafIndexNode
+  const RID &key_rid(const RID &rid) const { return file_header_.unique_keys ? *RID::min() : rid; }
+
 protected:
   LogHandler     *log_handler_      = nullptr;  /// 日志处理器
   DiskBufferPool *disk_buffer_pool_ = nullptr;  /// 磁盘缓冲池
@@ -653,6 +1055,72 @@ protected:
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
+  friend class BplusTreeBulkBuilder;
+};
+
+/**
+ * @brief 按照键值顺序自底向上地构建B+树
+ * @ingroup BPlusTree
+ * @details 只能用于空的B+树。逐条插入时每条数据都要从根节点查找叶子节点，还会不停地分裂页面。
+ * 如果数据已经按照键值排好序，就可以直接从左到右填满叶子节点，每填满一个节点，就把下一个节点的
+ * 第一个键值插入到上一层，上一层节点满了也是同样处理。每一层只有最右边的节点还没有写完。
+ * 节点写完之后才记录日志，每个节点只记录初始化、追加所有元素、设置父节点和兄弟节点这几条，
+ * 最后再更新根节点。中途失败的话B+树仍然是空的，只是浪费了一些页面。
+ * 构建期间不能有其它人访问这棵B+树。
+ */
+class BplusTreeBulkBuilder
+{
+public:
+  static constexpr float MIN_FILL_FACTOR = 0.5f;
+
+  /**
+   * @param fill_factor 每个节点填充的比例，最后一个节点除外。比例太小时会让节点在删除时马上合并，
+   * 所以不会小于 MIN_FILL_FACTOR
+   */
+  explicit BplusTreeBulkBuilder(BplusTreeHandler &tree_handler, float fill_factor = 1.0f);
+  ~BplusTreeBulkBuilder();
+
+  /**
+   * @brief 追加一条数据
+   * @details 键值(包含RID)必须严格递增
+   * @param include 附带在RID之后的数据，参考 BplusTreeHandler::insert_entry
+   */
+  RC append(const char *user_key, const RID &rid, const char *include = nullptr);
+
+  /**
+   * @brief 写完所有节点并更新根节点
+   */
+  RC finish();
+
+private:
+  /**
+   * @brief 每一层当前正在填充的节点
+   * @details 元素直接写到页面上，不记录日志，这样可以按照压缩之后的大小判断节点是否满了。
+   * 节点写完之后再按照正常的方式重新初始化页面并记录日志。
+   */
+  struct Level
+  {
+    Frame  *frame           = nullptr;
+    PageNum parent_page_num = BP_INVALID_PAGE_NUM;
+    PageNum prev_page_num   = BP_INVALID_PAGE_NUM;  ///< 叶子节点的前一个兄弟节点，内部节点不使用
+  };
+
+  /**
+   * @brief 把子节点加入到 level 层，必要时创建新的节点或者新的一层
+   * @param parent_page_num 返回子节点的父节点
+   */
+  RC add_child(int level, const char *key, PageNum child_page_num, PageNum &parent_page_num);
+  RC finish_node(int level, PageNum next_page_num);
+  /// 分配一个页面并初始化成空的节点
+  RC allocate_node(bool leaf, Frame *&frame);
+
+private:
+  BplusTreeHandler        &tree_handler_;
+  float                    fill_factor_ = 1.0f;
+  BplusTreeMiniTransaction mtr_;        ///< 填充节点时使用，不会记录日志
+  vector<Level>            levels_;     ///< levels_[0] 是叶子节点
+  vector<char>             item_;       ///< 构造叶子节点元素的缓存
+  vector<char>             separator_;  ///< 叶子节点之间的分隔键值
 };
 
 /**
@@ -668,15 +1136,20 @@ public:
   /**
    * @brief 扫描指定范围的数据
    * @param left_user_key 扫描范围的左边界，如果是null，则没有左边界
-   * @param left_len left_user_key 的内存大小(只有在变长字段中才会关注)
+   * @param left_len left_user_key 的内存大小(只有在变长字段和多字段键值中才会关注)
    * @param left_inclusive 左边界的值是否包含在内
    * @param right_user_key 扫描范围的右边界。如果是null，则没有右边界
-   * @param right_len right_user_key 的内存大小(只有在变长字段中才会关注)
+   * @param right_len right_user_key 的内存大小(只有在变长字段和多字段键值中才会关注)
    * @param right_inclusive 右边界的值是否包含在内
+   * @param reverse 是否从右边界向左边界反向扫描
+   * @details 多个字段组成的键值可以只给出前几个字段，此时 len 是这几个字段长度的和，
+   * 比较时只看这几个字段。比如索引(a,b)上，左右边界都是 a=1 时，扫描的是 a=1 的所有数据。
+   * 反向扫描需要叶子节点记录前一个兄弟节点，之前创建的文件不支持，返回 UNSUPPORTED，
+   * 参考 IndexFileHeader::prev_leaf_links
    * TODO 重构参数表示方法
    */
   RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, bool reverse = false);
 
   /**
    * @brief 获取下一条记录
@@ -689,6 +1162,14 @@ public:
    */
   RC next_entry(RID &rid);
 
+  /**
+   * @brief 获取下一条记录，同时返回叶子节点中的键值和附带的数据
+   * @details 覆盖索引扫描时使用，需要的字段都在键值或附带的数据中，不用再读取记录
+   * @param[out] key 完整的键值(字段 + RID)，在下一次调用之前有效
+   * @param[out] include 附带在RID之后的数据，没有时是 nullptr，在下一次调用之前有效
+   */
+  RC next_entry(RID &rid, const char *&key, const char *&include);
+
   /**
    * @brief 关闭当前扫描器
    * @details 可以不调用，在析构函数时会自动执行
@@ -701,10 +1182,39 @@ private:
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
+  /**
+   * @brief 多字段键值只给出了前几个字段时，用最小值或最大值填充剩下的字段
+   * @param want_max 是否用最大值填充
+   */
+  RC fill_user_key(const char *user_key, int key_len, bool want_max, char **fixed_key);
+
+  /**
+   * @brief 把扫描边界转换成与B+树中的键值一样长的数据
+   * @param is_left 是否是左边界
+   * @param[in,out] inclusive 边界是否包含在内，调整之后可能会变成包含
+   * @param[out] fixed_key 调整后的键值，与 user_key 不同时需要调用者释放
+   */
+  RC fix_bound_key(const char *user_key, int key_len, bool is_left, bool &inclusive, char **fixed_key);
+
+  /**
+   * @brief 找到正向扫描的起始位置，也就是左边界上的第一条数据
+   */
+  RC open_forward(const char *left_key, bool left_inclusive);
+
+  /**
+   * @brief 找到反向扫描的起始位置，也就是右边界上的最后一条数据
+   */
+  RC open_backward(const char *right_key, bool right_inclusive);
+
+  /**
+   * @brief 反向扫描时移动到前一条数据，跟 next_entry 一样可能需要移动到前一个叶子节点
+   */
+  RC prev_entry(RID &rid);
+
   void fetch_item(RID &rid);
 
   /**
-   * @brief 判断是否到了扫描的结束位置
+   * @brief 判断是否到了扫描的结束位置，正向扫描时是右边界，反向扫描时是左边界
    */
   bool touch_end();
 
@@ -717,7 +1227,10 @@ private:
   /// 起始位置和终止位置都是有效的数据
   Frame *current_frame_ = nullptr;
 
-  common::MemPoolItem::item_unique_ptr right_key_;
+  common::MemPoolItem::item_unique_ptr end_key_;                ///< 扫描的结束位置，没有时是 nullptr
+  bool                                 end_inclusive_  = false;
+  bool                                 reverse_        = false;  ///< 是否反向扫描
   int                                  iter_index_    = -1;
   bool                                 first_emitted_ = false;
+  vector<char>                         current_key_;  ///< 压缩的键值还原出来之后放在这里
 };
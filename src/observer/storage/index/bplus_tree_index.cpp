@@ -14,12 +14,14 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/index/bplus_tree_index.h"
 #include "common/log/log.h"
+#include "storage/index/index_entry_sorter.h"
 #include "storage/table/table.h"
 #include "storage/db/db.h"
 
 BplusTreeIndex::~BplusTreeIndex() noexcept { close(); }
 
-RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::create(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
@@ -27,10 +29,22 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  RC rc = Index::init(index_meta, field_metas);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  vector<AttrType> attr_types;
+  vector<int>      attr_lengths;
+  for (const FieldMeta &field_meta : field_metas_) {
+    attr_types.push_back(field_meta.type());
+    attr_lengths.push_back(field_meta.len());
+  }
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
-  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, field_meta.type(), field_meta.len());
+  rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, attr_types, attr_lengths,
+      -1 /*internal_max_size*/, -1 /*leaf_max_size*/, true /*key_compression*/, true /*separate_leaf_values*/,
+      include_length_, index_meta.unique());
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name, index_meta.name(), index_meta.field(), strrc(rc));
@@ -44,7 +58,8 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &
   return RC::SUCCESS;
 }
 
-RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::open(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
@@ -52,16 +67,27 @@ RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &in
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  RC rc = Index::init(index_meta, field_metas);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
-  RC rc = index_handler_.open(table->db()->log_handler(), bpm, file_name);
+  rc = index_handler_.open(table->db()->log_handler(), bpm, file_name);
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to open index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name, index_meta.name(), index_meta.field(), strrc(rc));
     return rc;
   }
 
+  const IndexFileHeader &file_header = index_handler_.file_header();
+  if (file_header.include_length != include_length_ || (file_header.unique_keys != 0) != index_meta.unique()) {
+    LOG_ERROR("index file does not match index meta. file_name:%s, index:%s, file=%s",
+        file_name, index_meta.name(), file_header.to_string().c_str());
+    index_handler_.close();
+    return RC::INTERNAL;
+  }
+
   inited_ = true;
   table_  = table;
   LOG_INFO("Successfully open index, file_name:%s, index:%s, field:%s",
@@ -82,19 +108,60 @@ RC BplusTreeIndex::close()
 
 RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
 {
-  return index_handler_.insert_entry(record + field_meta_.offset(), rid);
+  vector<char> include(include_length_);
+  make_include(record, include.data());
+
+  if (field_metas_.size() == 1) {
+    return index_handler_.insert_entry(record + field_metas_[0].offset(), rid, include.data());
+  }
+
+  vector<char> key(key_length_);
+  make_key(record, key.data());
+  return index_handler_.insert_entry(key.data(), rid, include.data());
 }
 
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
-  return index_handler_.delete_entry(record + field_meta_.offset(), rid);
+  if (field_metas_.size() == 1) {
+    return index_handler_.delete_entry(record + field_metas_[0].offset(), rid);
+  }
+
+  vector<char> key(key_length_);
+  make_key(record, key.data());
+  return index_handler_.delete_entry(key.data(), rid);
+}
+
+RC BplusTreeIndex::insert_sorted_entries(IndexEntrySorter &sorter, const IndexBuildOptions &options)
+{
+  if (!index_handler_.is_empty()) {
+    return Index::insert_sorted_entries(sorter, options);
+  }
+
+  BplusTreeBulkBuilder builder(index_handler_, options.fill_factor);
+
+  const char *key     = nullptr;
+  const char *include = nullptr;
+  RID         rid;
+  RC          rc = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(key, rid, include))) {
+    rc = builder.append(key, rid, include);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to append entry into bplus tree builder. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read sorted index entries. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+  return builder.finish();
 }
 
-IndexScanner *BplusTreeIndex::create_scanner(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+IndexScanner *BplusTreeIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive, bool reverse /* = false */)
 {
   BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_);
-  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
     delete index_scanner;
@@ -110,14 +177,19 @@ BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler) : t
 
 BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept { tree_scanner_.close(); }
 
-RC BplusTreeIndexScanner::open(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, bool reverse /* = false */)
 {
-  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
 }
 
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, const char *&key, const char *&include)
+{
+  return tree_scanner_.next_entry(*rid, key, include);
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
@@ -27,18 +27,30 @@ public:
   BplusTreeIndex() = default;
   virtual ~BplusTreeIndex() noexcept;
 
-  RC create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta) override;
-  RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta) override;
+  RC create(
+      Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas) override;
+  RC open(
+      Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas) override;
   RC close();
 
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 索引为空时自底向上地构建B+树，否则逐条插入
+   */
+  RC insert_sorted_entries(IndexEntrySorter &sorter, const IndexBuildOptions &options) override;
+
   /**
    * 扫描指定范围的数据
    */
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) override;
+      int right_len, bool right_inclusive, bool reverse = false) override;
+
+  /**
+   * @brief 之前创建的B+树中叶子节点没有记录前一个兄弟节点，不能反向扫描
+   */
+  bool support_reverse_scan() const override { return index_handler_.file_header().prev_leaf_links != 0; }
 
   RC sync() override;
 
@@ -59,10 +71,11 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, const char *&key, const char *&include) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, bool reverse = false);
 
 private:
   BplusTreeScanner tree_scanner_;
@@ -67,6 +67,11 @@ RC BplusTreeLogger::leaf_set_next_page(IndexNodeHandler &node_handler, PageNum p
   return append_log_entry(make_unique<LeafSetNextPageLogEntryHandler>(node_handler.frame(), page_num, old_page_num));
 }
 
+RC BplusTreeLogger::leaf_set_prev_page(IndexNodeHandler &node_handler, PageNum page_num, PageNum old_page_num)
+{
+  return append_log_entry(make_unique<LeafSetPrevPageLogEntryHandler>(node_handler.frame(), page_num, old_page_num));
+}
+
 RC BplusTreeLogger::internal_init_empty(IndexNodeHandler &node_handler)
 {
   return append_log_entry(make_unique<InternalInitEmptyLogEntryHandler>(node_handler.frame()));
@@ -34,6 +34,7 @@ string LogOperation::to_string() const
     case Type::INTERNAL_UPDATE_KEY: ss << "INTERNAL_UPDATE_KEY"; break;
     case Type::NODE_INSERT: ss << "NODE_INSERT"; break;
     case Type::NODE_REMOVE: ss << "NODE_REMOVE"; break;
+    case Type::LEAF_SET_PREV_PAGE: ss << "LEAF_SET_PREV_PAGE"; break;
     default: ss << "INVALID"; break;
   }
   return ss.str();
@@ -155,6 +156,10 @@ RC LogEntryHandler::from_buffer(
       rc = LeafSetNextPageLogEntryHandler::deserialize(frame, buffer, handler);
     } break;
 
+    case LogOperation::Type::LEAF_SET_PREV_PAGE: {
+      rc = LeafSetPrevPageLogEntryHandler::deserialize(frame, buffer, handler);
+    } break;
+
     case LogOperation::Type::INTERNAL_INIT_EMPTY: {
       rc = InternalInitEmptyLogEntryHandler::deserialize(frame, buffer, handler);
     } break;
@@ -424,6 +429,57 @@ RC LeafSetNextPageLogEntryHandler::redo(BplusTreeMiniTransaction &mtr, BplusTree
   return RC::SUCCESS;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// LeafSetPrevPageLogEntryHandler
+LeafSetPrevPageLogEntryHandler::LeafSetPrevPageLogEntryHandler(Frame *frame, PageNum new_page_num, PageNum old_page_num)
+    : NodeLogEntryHandler(LogOperation::Type::LEAF_SET_PREV_PAGE, frame),
+      new_page_num_(new_page_num),
+      old_page_num_(old_page_num)
+{}
+
+RC LeafSetPrevPageLogEntryHandler::serialize_body(Serializer &buffer) const
+{
+  buffer.write_int32(new_page_num_);
+  return RC::SUCCESS;
+}
+
+string LeafSetPrevPageLogEntryHandler::to_string() const
+{
+  stringstream ss;
+  ss << LogEntryHandler::to_string() << ", new_page_num=" << new_page_num_;
+  return ss.str();
+}
+
+RC LeafSetPrevPageLogEntryHandler::deserialize(Frame *frame, Deserializer &buffer, unique_ptr<LogEntryHandler> &handler)
+{
+  int     ret      = 0;
+  int32_t page_num = -1;
+  if ((ret = buffer.read_int32(page_num)) < 0) {
+    return RC::INTERNAL;
+  }
+
+  handler = make_unique<LeafSetPrevPageLogEntryHandler>(frame, page_num, -1 /*old_page_num*/);
+  return RC::SUCCESS;
+}
+
+RC LeafSetPrevPageLogEntryHandler::rollback(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler)
+{
+  if (nullptr == frame()) {
+    return RC::INTERNAL;
+  }
+  LeafIndexNodeHandler leaf_handler(mtr, tree_handler.file_header(), frame());
+  leaf_handler.set_prev_page(old_page_num_);
+  return RC::SUCCESS;
+}
+
+RC LeafSetPrevPageLogEntryHandler::redo(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler)
+{
+  LeafIndexNodeHandler leaf_handler(mtr, tree_handler.file_header(), frame());
+
+  leaf_handler.set_prev_page(new_page_num_);
+  return RC::SUCCESS;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // InternalInitEmptyLogEntryHandler
 InternalInitEmptyLogEntryHandler::InternalInitEmptyLogEntryHandler(Frame *frame)
@@ -50,6 +50,7 @@ public:
     INTERNAL_UPDATE_KEY,       /// 更新内部节点的key
     NODE_INSERT,               /// 在节点中间(也可能是末尾)插入一些元素
     NODE_REMOVE,               /// 在节点中间(也可能是末尾)删除一些元素
+    LEAF_SET_PREV_PAGE,        /// 设置叶子节点的前一个兄弟节点
 
     MAX_TYPE,
   };
@@ -300,6 +301,31 @@ private:
   PageNum old_page_num_ = -1;
 };
 
+/**
+ * @brief 设置叶子节点的前一个兄弟节点日志处理类
+ * @ingroup CLog
+ */
+class LeafSetPrevPageLogEntryHandler : public NodeLogEntryHandler
+{
+public:
+  LeafSetPrevPageLogEntryHandler(Frame *frame, PageNum new_page_num, PageNum old_page_num);
+  virtual ~LeafSetPrevPageLogEntryHandler() = default;
+
+  RC serialize_body(common::Serializer &buffer) const override;
+  RC rollback(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler) override;
+  RC redo(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler) override;
+
+  string to_string() const override;
+
+  static RC deserialize(Frame *frame, common::Deserializer &buffer, unique_ptr<LogEntryHandler> &handler);
+
+  PageNum new_page_num() const { return new_page_num_; }
+
+private:
+  PageNum new_page_num_ = -1;
+  PageNum old_page_num_ = -1;
+};
+
 /**
  * @brief 初始化内部节点日志处理类
  * @ingroup CLog
@@ -0,0 +1,196 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/hash_index.h"
+#include "common/log/log.h"
+#include "common/lang/algorithm.h"
+#include "storage/table/table.h"
+#include "storage/db/db.h"
+
+HashIndex::~HashIndex() noexcept { close(); }
+
+RC HashIndex::create(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  RC rc = Index::init(index_meta, field_metas);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (!include_field_metas_.empty()) {
+    LOG_WARN("hash index does not support include fields. index:%s", index_meta.name());
+    return RC::UNSUPPORTED;
+  }
+
+  vector<AttrType> attr_types;
+  vector<int>      attr_lengths;
+  for (const FieldMeta &field_meta : field_metas_) {
+    if (!LinearHashHandler::support_attr_type(field_meta.type())) {
+      LOG_WARN("hash index does not support field type. index:%s, field:%s, type:%s",
+          index_meta.name(), field_meta.name(), attr_type_to_string(field_meta.type()));
+      return RC::UNSUPPORTED;
+    }
+    attr_types.push_back(field_meta.type());
+    attr_lengths.push_back(field_meta.len());
+  }
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  rc = index_handler_.create(
+      table->db()->log_handler(), bpm, file_name, attr_types, attr_lengths, index_meta.unique());
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully create hash index, file_name:%s, index:%s, field:%s",
+    file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::open(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  RC rc = Index::init(index_meta, field_metas);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  rc = index_handler_.open(table->db()->log_handler(), bpm, file_name);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to open index_handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  const LinearHashFileHeader &file_header = index_handler_.file_header();
+  if (file_header.attr_length != key_length_ || (file_header.unique_keys != 0) != index_meta.unique()) {
+    LOG_ERROR("index file does not match index meta. file_name:%s, index:%s, file=%s",
+        file_name, index_meta.name(), file_header.to_string().c_str());
+    index_handler_.close();
+    return RC::INTERNAL;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open hash index, file_name:%s, index:%s, field:%s",
+    file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close index, index:%s, field:%s", index_meta_.name(), index_meta_.field());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid)
+{
+  if (field_metas_.size() == 1) {
+    return index_handler_.insert_entry(record + field_metas_[0].offset(), *rid);
+  }
+
+  vector<char> key(key_length_);
+  make_key(record, key.data());
+  return index_handler_.insert_entry(key.data(), *rid);
+}
+
+RC HashIndex::delete_entry(const char *record, const RID *rid)
+{
+  if (field_metas_.size() == 1) {
+    return index_handler_.delete_entry(record + field_metas_[0].offset(), *rid);
+  }
+
+  vector<char> key(key_length_);
+  make_key(record, key.data());
+  return index_handler_.delete_entry(key.data(), *rid);
+}
+
+IndexScanner *HashIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive, bool reverse /* = false */)
+{
+  if (left_key == nullptr || right_key == nullptr || !left_inclusive || !right_inclusive || reverse ||
+      left_len != right_len || 0 != memcmp(left_key, right_key, left_len)) {
+    LOG_WARN("hash index only supports equality lookup. index:%s", index_meta_.name());
+    return nullptr;
+  }
+
+  // 多个字段的键值必须是完整的。单个字段时字符串的长度可能与字段不同，按照字段长度补齐或截断
+  if (field_metas_.size() > 1 && left_len != key_length_) {
+    LOG_WARN("hash index needs a full key. index:%s, key length=%d, expected=%d",
+        index_meta_.name(), left_len, key_length_);
+    return nullptr;
+  }
+
+  vector<char> key(key_length_, 0);
+  memcpy(key.data(), left_key, min(left_len, key_length_));
+
+  HashIndexScanner *index_scanner = new HashIndexScanner();
+  RC                rc            = index_scanner->open(index_handler_, std::move(key));
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC HashIndex::sync() { return index_handler_.sync(); }
+
+////////////////////////////////////////////////////////////////////////////////
+RC HashIndexScanner::open(LinearHashHandler &handler, vector<char> &&key)
+{
+  key_      = std::move(key);
+  position_ = 0;
+  rids_.clear();
+  return handler.get_entries(key_.data(), rids_);
+}
+
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  if (position_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  *rid = rids_[position_++];
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::next_entry(RID *rid, const char *&key, const char *&include)
+{
+  RC rc = next_entry(rid);
+  if (OB_SUCC(rc)) {
+    key     = key_.data();
+    include = nullptr;
+  }
+  return rc;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,72 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "storage/index/index.h"
+#include "storage/index/linear_hash.h"
+
+/**
+ * @brief 哈希索引
+ * @ingroup Index
+ * @details 使用线性哈希存放数据，只能做所有键值字段都是等值条件的查找，不支持包含字段
+ */
+class HashIndex : public Index
+{
+public:
+  HashIndex() = default;
+  virtual ~HashIndex() noexcept;
+
+  RC create(
+      Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas) override;
+  RC open(
+      Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas) override;
+  RC close();
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  /**
+   * @brief 只能扫描一个键值，左右边界必须相同并且都包含边界
+   */
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive, bool reverse = false) override;
+
+  bool support_range_scan() const override { return false; }
+
+  RC sync() override;
+
+private:
+  bool              inited_ = false;
+  LinearHashHandler index_handler_;
+};
+
+/**
+ * @brief 哈希索引扫描器
+ * @ingroup Index
+ * @details 打开时就把所有匹配的RID都读出来，之后不再访问哈希表
+ */
+class HashIndexScanner : public IndexScanner
+{
+public:
+  HashIndexScanner() = default;
+  ~HashIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, const char *&key, const char *&include) override;
+  RC destroy() override;
+
+  RC open(LinearHashHandler &handler, vector<char> &&key);
+
+private:
+  vector<char> key_;
+  vector<RID>  rids_;
+  size_t       position_ = 0;
+};
@@ -13,10 +13,93 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/index.h"
+#include "common/lang/algorithm.h"
+#include "storage/index/index_entry_sorter.h"
 
-RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC Index::init(const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
 {
+  const size_t key_field_num = static_cast<size_t>(index_meta.field_num());
+  if (field_metas.size() != key_field_num + index_meta.include_fields().size()) {
+    LOG_WARN("field metas do not match index meta. index=%s, field num=%d, expected=%d",
+             index_meta.name(), static_cast<int>(field_metas.size()),
+             static_cast<int>(key_field_num + index_meta.include_fields().size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
   index_meta_ = index_meta;
-  field_meta_ = field_meta;
+  field_metas_.assign(field_metas.begin(), field_metas.begin() + key_field_num);
+  include_field_metas_.assign(field_metas.begin() + key_field_num, field_metas.end());
+  key_length_ = 0;
+  for (const FieldMeta &field_meta : field_metas_) {
+    key_length_ += field_meta.len();
+  }
+  include_length_ = 0;
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    include_length_ += field_meta.len();
+  }
   return RC::SUCCESS;
 }
+
+void Index::make_key(const char *record, char *key) const
+{
+  for (const FieldMeta &field_meta : field_metas_) {
+    memcpy(key, record + field_meta.offset(), field_meta.len());
+    key += field_meta.len();
+  }
+}
+
+void Index::make_include(const char *record, char *include) const
+{
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    memcpy(include, record + field_meta.offset(), field_meta.len());
+    include += field_meta.len();
+  }
+}
+
+bool Index::covers(span<const int> field_ids) const
+{
+  auto contains = [field_ids](const vector<FieldMeta> &field_metas, int field_id) {
+    return any_of(field_metas.begin(), field_metas.end(), [field_id](const FieldMeta &field_meta) {
+      return field_meta.field_id() == field_id;
+    });
+  };
+  return all_of(field_ids.begin(), field_ids.end(), [&](int field_id) {
+    return contains(field_metas_, field_id) || contains(include_field_metas_, field_id);
+  });
+}
+
+RC Index::insert_sorted_entries(IndexEntrySorter &sorter, const IndexBuildOptions &options)
+{
+  // insert_entry 只会读取记录中当前索引字段的数据，把键值和包含字段的数据拆开放回这些字段的位置
+  int record_size = 0;
+  for (const FieldMeta &field_meta : field_metas_) {
+    record_size = max(record_size, field_meta.offset() + field_meta.len());
+  }
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    record_size = max(record_size, field_meta.offset() + field_meta.len());
+  }
+
+  vector<char> record(record_size, 0);
+  const char  *key     = nullptr;
+  const char  *include = nullptr;
+  RID          rid;
+  RC           rc = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(key, rid, include))) {
+    for (const FieldMeta &field_meta : field_metas_) {
+      memcpy(record.data() + field_meta.offset(), key, field_meta.len());
+      key += field_meta.len();
+    }
+    for (const FieldMeta &field_meta : include_field_metas_) {
+      memcpy(record.data() + field_meta.offset(), include, field_meta.len());
+      include += field_meta.len();
+    }
+
+    rc = insert_entry(record.data(), &rid);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert index entry. index=%s, rid=%s, rc=%s",
+               index_meta_.name(), rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
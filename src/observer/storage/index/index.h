@@ -15,14 +15,28 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <stddef.h>
-#include <vector>
 
 #include "common/rc.h"
+#include "common/lang/span.h"
+#include "common/lang/vector.h"
 #include "storage/field/field_meta.h"
 #include "storage/index/index_meta.h"
 #include "storage/record/record_manager.h"
 
 class IndexScanner;
+class IndexEntrySorter;
+
+/**
+ * @brief 批量构建索引时的参数
+ * @ingroup Index
+ */
+struct IndexBuildOptions
+{
+  static constexpr int64_t DEFAULT_SORT_MEMORY = 64 * 1024 * 1024;
+
+  float   fill_factor = 0.9;                  ///< 自底向上构建时每个节点填充的比例，给之后的插入留一些空间
+  int64_t sort_memory = DEFAULT_SORT_MEMORY;  ///< 排序可以使用的内存，超过时使用外部排序，参考 IndexEntrySorter
+};
 
 /**
  * @brief 索引
@@ -40,18 +54,56 @@ public:
   Index()          = default;
   virtual ~Index() = default;
 
-  virtual RC create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+  /**
+   * @brief 创建索引
+   * @param field_metas 先是键值字段，按照键值中的顺序排列，共 index_meta.field_num() 个；
+   * 之后是包含字段，参考 IndexMeta::include_fields
+   */
+  virtual RC create(
+      Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
   {
     return RC::UNSUPPORTED;
   }
-  virtual RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+  virtual RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const vector<FieldMeta> &field_metas)
   {
     return RC::UNSUPPORTED;
   }
 
   virtual bool is_vector_index() { return false; }
 
-  const IndexMeta &index_meta() const { return index_meta_; }
+  const IndexMeta         &index_meta() const { return index_meta_; }
+  const vector<FieldMeta> &field_metas() const { return field_metas_; }
+  const vector<FieldMeta> &include_field_metas() const { return include_field_metas_; }
+
+  /**
+   * @brief 键值的长度，是所有字段长度的和
+   */
+  int key_length() const { return key_length_; }
+
+  /**
+   * @brief 从记录中取出索引字段的数据，依次拼接成键值
+   * @param record 记录的数据
+   * @param key    键值的缓存，长度是 key_length()
+   */
+  void make_key(const char *record, char *key) const;
+
+  /**
+   * @brief 包含字段数据的长度，是所有包含字段长度的和
+   */
+  int include_length() const { return include_length_; }
+
+  /**
+   * @brief 从记录中取出包含字段的数据，依次拼接起来
+   * @param record  记录的数据
+   * @param include 数据的缓存，长度是 include_length()
+   */
+  void make_include(const char *record, char *include) const;
+
+  /**
+   * @brief 索引中是否存放了这些字段的数据，都存放时可以只扫描索引而不读取记录
+   * @param field_ids 字段在表中的编号，参考 FieldMeta::field_id
+   */
+  bool covers(span<const int> field_ids) const;
 
   /**
    * @brief 插入一条数据
@@ -69,6 +121,14 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 按照键值顺序批量插入数据
+   * @details 批量导入数据和在已有数据的表上创建索引时使用，默认逐条调用 insert_entry。
+   * @param sorter 已经排好序的数据，键值的长度是 key_length()，参考 make_key；
+   * 附带的数据是包含字段，长度是 include_length()，参考 make_include
+   */
+  virtual RC insert_sorted_entries(IndexEntrySorter &sorter, const IndexBuildOptions &options);
+
   /**
    * @brief 创建一个索引数据的扫描器
    *
@@ -78,9 +138,22 @@ public:
    * @param right_key 要扫描的右边界
    * @param right_len 右边界的长度
    * @param right_inclusive 是否包含右边界
+   * @param reverse 是否从右边界向左边界反向扫描，需要 support_reverse_scan
    */
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) = 0;
+      int right_len, bool right_inclusive, bool reverse = false) = 0;
+
+  /**
+   * @brief 是否可以按照键值从大到小扫描
+   * @details 计划生成时用来处理 MAX 这样需要从最大的键值开始查找的查询
+   */
+  virtual bool support_reverse_scan() const { return false; }
+
+  /**
+   * @brief 是否可以按照范围扫描
+   * @details 不支持时只能在所有键值字段都是等值条件时使用，左右边界相同，参考 HashIndex
+   */
+  virtual bool support_range_scan() const { return true; }
 
   /**
    * @brief 同步索引数据到磁盘
@@ -89,11 +162,14 @@ public:
   virtual RC sync() = 0;
 
 protected:
-  RC init(const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC init(const IndexMeta &index_meta, const vector<FieldMeta> &field_metas);
 
 protected:
-  IndexMeta index_meta_;  ///< 索引的元数据
-  FieldMeta field_meta_;  ///< 当前实现仅考虑一个字段的索引
+  IndexMeta         index_meta_;              ///< 索引的元数据
+  vector<FieldMeta> field_metas_;             ///< 索引的键值字段，按照键值中的顺序排列
+  vector<FieldMeta> include_field_metas_;     ///< 索引的包含字段，和RID一起存放在叶子节点中
+  int               key_length_     = 0;      ///< 所有键值字段长度的和
+  int               include_length_ = 0;      ///< 所有包含字段长度的和
 };
 
 /**
@@ -112,4 +188,12 @@ public:
    */
   virtual RC next_entry(RID *rid) = 0;
   virtual RC destroy()            = 0;
+
+  /**
+   * @brief 遍历元素数据，同时返回索引中存放的键值和包含字段的数据
+   * @details 用于只扫描索引而不读取记录的查询，参考 Index::covers。返回的数据在下一次调用之前有效
+   * @param[out] key     键值，长度是 Index::key_length()
+   * @param[out] include 包含字段的数据，长度是 Index::include_length()，没有包含字段时是 nullptr
+   */
+  virtual RC next_entry(RID *rid, const char *&key, const char *&include) { return RC::UNSUPPORTED; }
 };
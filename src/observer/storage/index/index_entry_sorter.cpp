@@ -0,0 +1,224 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/index_entry_sorter.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+IndexEntrySorter::IndexEntrySorter(const vector<FieldMeta> &field_metas, int64_t memory_limit,
+    const string &tmp_file_prefix, int include_length /* = 0 */)
+    : include_length_(include_length), memory_limit_(memory_limit), tmp_file_prefix_(tmp_file_prefix)
+{
+  vector<AttrType> attr_types;
+  vector<int>      attr_lengths;
+  for (const FieldMeta &field : field_metas) {
+    attr_types.push_back(field.type());
+    attr_lengths.push_back(field.len());
+    key_length_ += field.len();
+  }
+  comparator_.init(attr_types, attr_lengths);
+  entry_size_ = key_length_ + sizeof(RID) + include_length_;
+}
+
+IndexEntrySorter::~IndexEntrySorter()
+{
+  for (unique_ptr<Run> &run : runs_) {
+    run->file.close();
+    ::remove(run->file_name.c_str());
+  }
+}
+
+RC IndexEntrySorter::add(const char *key, const RID &rid, const char *include /* = nullptr */)
+{
+  ASSERT(!sorted_, "cannot add entries after sorted");
+
+  // 排序时每条数据还需要一个指针
+  const int64_t memory_used = static_cast<int64_t>(buffer_.size()) + (entry_count_in_buffer() + 1) * sizeof(char *);
+  if (!buffer_.empty() && memory_used + entry_size_ > memory_limit_) {
+    RC rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + entry_size_);
+  memcpy(buffer_.data() + offset, key, key_length_);
+  memcpy(buffer_.data() + offset + key_length_, &rid, sizeof(RID));
+  if (include_length_ > 0) {
+    ASSERT(include != nullptr, "include data should not be empty");
+    memcpy(buffer_.data() + offset + key_length_ + sizeof(RID), include, include_length_);
+  }
+  entry_count_++;
+  return RC::SUCCESS;
+}
+
+void IndexEntrySorter::sort_in_memory()
+{
+  const size_t entry_num = entry_count_in_buffer();
+  sorted_entries_.resize(entry_num);
+  for (size_t i = 0; i < entry_num; i++) {
+    sorted_entries_[i] = buffer_.data() + i * entry_size_;
+  }
+  comparator_.visit([this](const auto &comparator) {
+    std::sort(sorted_entries_.begin(), sorted_entries_.end(), [&comparator](const char *left, const char *right) {
+      return comparator(left, right) < 0;
+    });
+  });
+}
+
+RC IndexEntrySorter::spill()
+{
+  sort_in_memory();
+
+  auto run       = make_unique<Run>();
+  run->file_name = tmp_file_prefix_ + "." + std::to_string(runs_.size());
+
+  ofstream file(run->file_name, ios_base::out | ios_base::binary | ios_base::trunc);
+  if (!file.is_open()) {
+    LOG_WARN("failed to open index sort file. file=%s, errmsg=%s", run->file_name.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  // 先记下来，失败时析构函数也会删除这个文件
+  runs_.push_back(std::move(run));
+
+  for (const char *entry : sorted_entries_) {
+    file.write(entry, entry_size_);
+  }
+  file.close();
+  if (file.fail()) {
+    LOG_WARN("failed to write index sort file. file=%s, errmsg=%s", runs_.back()->file_name.c_str(), strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+
+  LOG_INFO("spilled sorted index entries. file=%s, entry num=%d",
+           runs_.back()->file_name.c_str(), static_cast<int>(sorted_entries_.size()));
+
+  sorted_entries_.clear();
+  buffer_.clear();
+  return RC::SUCCESS;
+}
+
+RC IndexEntrySorter::sort()
+{
+  ASSERT(!sorted_, "cannot sort twice");
+  sorted_ = true;
+
+  if (runs_.empty()) {
+    sort_in_memory();
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (!buffer_.empty()) {
+    rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  sorted_entries_.shrink_to_fit();
+
+  const int64_t block_entries = max(int64_t(1), memory_limit_ / static_cast<int64_t>(runs_.size()) / entry_size_);
+  for (int i = 0; i < static_cast<int>(runs_.size()); i++) {
+    Run &run = *runs_[i];
+    run.file.open(run.file_name, ios_base::in | ios_base::binary);
+    if (!run.file.is_open()) {
+      LOG_WARN("failed to open index sort file. file=%s, errmsg=%s", run.file_name.c_str(), strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+    run.block.resize(block_entries * entry_size_);
+
+    rc = advance(run);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (run.pos < run.end) {
+      heap_.push_back(i);
+    }
+  }
+
+  std::make_heap(heap_.begin(), heap_.end(), [this](int left, int right) { return run_greater(left, right); });
+  return RC::SUCCESS;
+}
+
+RC IndexEntrySorter::advance(Run &run)
+{
+  if (run.end > 0) {
+    run.pos += entry_size_;
+  }
+  if (run.pos < run.end) {
+    return RC::SUCCESS;
+  }
+
+  run.file.read(run.block.data(), run.block.size());
+  if (run.file.bad()) {
+    LOG_WARN("failed to read index sort file. file=%s, errmsg=%s", run.file_name.c_str(), strerror(errno));
+    return RC::IOERR_READ;
+  }
+  run.pos = 0;
+  run.end = static_cast<size_t>(run.file.gcount());
+  if (run.end % entry_size_ != 0) {
+    LOG_WARN("index sort file is truncated. file=%s", run.file_name.c_str());
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+RC IndexEntrySorter::next(const char *&key, RID &rid)
+{
+  const char *include = nullptr;
+  return next(key, rid, include);
+}
+
+RC IndexEntrySorter::next(const char *&key, RID &rid, const char *&include)
+{
+  ASSERT(sorted_, "should sort before reading entries");
+
+  const char *entry = nullptr;
+  if (runs_.empty()) {
+    if (next_index_ >= sorted_entries_.size()) {
+      return RC::RECORD_EOF;
+    }
+    entry = sorted_entries_[next_index_++];
+  } else {
+    auto heap_comparator = [this](int left, int right) { return run_greater(left, right); };
+
+    // 上次返回的数据到这次调用时才不再使用，这时才能让它所在的run前进
+    if (last_run_ >= 0) {
+      Run &run = *runs_[last_run_];
+      RC   rc  = advance(run);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      if (run.pos < run.end) {
+        heap_.push_back(last_run_);
+        std::push_heap(heap_.begin(), heap_.end(), heap_comparator);
+      }
+      last_run_ = -1;
+    }
+
+    if (heap_.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), heap_comparator);
+    last_run_ = heap_.back();
+    heap_.pop_back();
+    entry = run_entry(last_run_);
+  }
+
+  key     = entry;
+  include = entry + key_length_ + sizeof(RID);
+  memcpy(&rid, entry + key_length_, sizeof(RID));
+  return RC::SUCCESS;
+}
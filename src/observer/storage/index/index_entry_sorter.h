@@ -0,0 +1,111 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/fstream.h"
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 对索引数据(键值和RID，以及附带的包含字段数据)排序，用于批量构建索引
+ * @ingroup Index
+ * @details 先把数据放在内存中，超过内存限制时排好序写到一个临时文件里(一个run)。
+ * 全部数据加入之后，如果没有写过临时文件，直接在内存中排序；否则把剩下的数据也写成一个run，
+ * 再多路归并所有的run，按照 键值+RID 的顺序逐条返回。附带的数据不参与比较。
+ * 归并时每个run使用一块读缓存，大小是内存限制平分给所有run之后的大小，只归并一趟。
+ * 临时文件在析构时删除。
+ */
+class IndexEntrySorter
+{
+public:
+  /**
+   * @param field_metas 索引包含的字段，键值是这些字段依次拼接起来的
+   * @param memory_limit 排序可以使用的内存大小
+   * @param tmp_file_prefix 临时文件名字的前缀，文件名后面会加上run的编号
+   * @param include_length 每条数据附带的数据长度，参考 Index::make_include
+   */
+  IndexEntrySorter(const vector<FieldMeta> &field_metas, int64_t memory_limit, const string &tmp_file_prefix,
+      int include_length = 0);
+  ~IndexEntrySorter();
+
+  /**
+   * @brief 加入一条数据
+   * @param key 键值，长度是所有字段长度的和，参考 Index::make_key
+   * @param include 附带的数据，长度是 include_length，没有时可以是 nullptr
+   */
+  RC add(const char *key, const RID &rid, const char *include = nullptr);
+
+  /**
+   * @brief 数据已经全部加入，开始排序。调用之后就不能再加入数据了
+   */
+  RC sort();
+
+  /**
+   * @brief 按照顺序返回下一条数据
+   * @param[out] key 键值，在下一次调用之前有效
+   * @return RC::RECORD_EOF 表示没有数据了
+   */
+  RC next(const char *&key, RID &rid);
+  /// @param[out] include 附带的数据，在下一次调用之前有效
+  RC next(const char *&key, RID &rid, const char *&include);
+
+  int64_t entry_count() const { return entry_count_; }
+  /// @brief 写到临时文件中的run的个数，是0表示只在内存中排序
+  int run_count() const { return static_cast<int>(runs_.size()); }
+
+private:
+  /**
+   * @brief 一个排好序的临时文件
+   */
+  struct Run
+  {
+    string       file_name;
+    ifstream     file;
+    vector<char> block;     ///< 读缓存，大小是数据长度的整数倍
+    size_t       pos = 0;   ///< 当前数据在缓存中的位置
+    size_t       end = 0;   ///< 缓存中有效数据的长度
+  };
+
+  /// @brief 对内存中的数据排序，结果放在 sorted_entries_ 中
+  void sort_in_memory();
+  /// @brief 把内存中的数据排好序写到一个新的临时文件中
+  RC spill();
+  /// @brief 让run指向下一条数据，没有数据时 pos == end
+  RC advance(Run &run);
+
+  size_t      entry_count_in_buffer() const { return buffer_.size() / entry_size_; }
+  const char *run_entry(int run_index) const { return runs_[run_index]->block.data() + runs_[run_index]->pos; }
+  /// @brief 小顶堆使用的比较函数
+  bool        run_greater(int left, int right) const { return comparator_(run_entry(left), run_entry(right)) > 0; }
+
+private:
+  KeyComparator comparator_;  ///< 比较 键值+RID
+  int           key_length_     = 0;
+  int           include_length_ = 0;
+  int           entry_size_     = 0;  ///< 键值+RID+附带的数据
+  int64_t       memory_limit_   = 0;
+  string        tmp_file_prefix_;
+
+  int64_t              entry_count_ = 0;
+  bool                 sorted_      = false;
+  vector<char>         buffer_;          ///< 还没有写到临时文件的数据
+  vector<const char *> sorted_entries_;  ///< 内存中排好序的数据
+  size_t               next_index_ = 0;  ///< 只在内存中排序时，下一条数据在 sorted_entries_ 中的位置
+
+  vector<unique_ptr<Run>> runs_;
+  vector<int>             heap_;          ///< 归并时的小顶堆，元素是run的编号
+  int                     last_run_ = -1; ///< 上一次返回的数据所在的run，下次调用 next 时再前进
+};
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/index_meta.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "storage/field/field_meta.h"
@@ -21,23 +22,101 @@ See the Mulan PSL v2 for more details. */
 
 const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
+const static Json::StaticString FIELD_FIELD_NAMES("field_names");
+const static Json::StaticString FIELD_INCLUDE_FIELD_NAMES("include_field_names");
+const static Json::StaticString FIELD_UNIQUE("unique");
+const static Json::StaticString FIELD_TYPE("type");
+
+static const char *INDEX_TYPE_NAMES[] = {"btree", "hash"};
+
+const char *index_type_to_string(IndexType type)
+{
+  const int index = static_cast<int>(type);
+  if (index >= 0 && index < static_cast<int>(sizeof(INDEX_TYPE_NAMES) / sizeof(INDEX_TYPE_NAMES[0]))) {
+    return INDEX_TYPE_NAMES[index];
+  }
+  return "unknown";
+}
+
+RC index_type_from_string(const char *name, IndexType &type)
+{
+  for (size_t i = 0; i < sizeof(INDEX_TYPE_NAMES) / sizeof(INDEX_TYPE_NAMES[0]); i++) {
+    if (0 == strcasecmp(name, INDEX_TYPE_NAMES[i])) {
+      type = static_cast<IndexType>(i);
+      return RC::SUCCESS;
+    }
+  }
+  return RC::INVALID_ARGUMENT;
+}
 
 RC IndexMeta::init(const char *name, const FieldMeta &field)
+{
+  const FieldMeta *fields[] = {&field};
+  return init(name, fields);
+}
+
+RC IndexMeta::init(const char *name, span<const FieldMeta *const> fields)
+{
+  return init(name, fields, span<const FieldMeta *const>());
+}
+
+RC IndexMeta::init(const char *name, span<const FieldMeta *const> fields, span<const FieldMeta *const> include_fields,
+    bool unique /* = false */, IndexType type /* = IndexType::BPLUS_TREE */)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
     return RC::INVALID_ARGUMENT;
   }
 
-  name_  = name;
-  field_ = field.name();
+  if (fields.empty()) {
+    LOG_ERROR("Failed to init index, no fields. name=%s", name);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  name_ = name;
+  fields_.clear();
+  for (const FieldMeta *field : fields) {
+    fields_.emplace_back(field->name());
+  }
+
+  include_fields_.clear();
+  for (const FieldMeta *field : include_fields) {
+    if (find(fields_.begin(), fields_.end(), field->name()) != fields_.end() ||
+        find(include_fields_.begin(), include_fields_.end(), field->name()) != include_fields_.end()) {
+      LOG_ERROR("Failed to init index, duplicate include field. name=%s, field=%s", name, field->name());
+      return RC::INVALID_ARGUMENT;
+    }
+    include_fields_.emplace_back(field->name());
+  }
+  unique_ = unique;
+  type_   = type;
   return RC::SUCCESS;
 }
 
 void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[FIELD_NAME]       = name_;
-  json_value[FIELD_FIELD_NAME] = field_;
+  json_value[FIELD_FIELD_NAME] = fields_[0];
+
+  Json::Value field_names(Json::arrayValue);
+  for (const string &field : fields_) {
+    field_names.append(field);
+  }
+  json_value[FIELD_FIELD_NAMES] = std::move(field_names);
+
+  if (!include_fields_.empty()) {
+    Json::Value include_field_names(Json::arrayValue);
+    for (const string &field : include_fields_) {
+      include_field_names.append(field);
+    }
+    json_value[FIELD_INCLUDE_FIELD_NAMES] = std::move(include_field_names);
+  }
+  if (unique_) {
+    json_value[FIELD_UNIQUE] = true;
+  }
+  if (type_ != IndexType::BPLUS_TREE) {
+    json_value[FIELD_TYPE] = index_type_to_string(type_);
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index)
@@ -49,23 +128,87 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     return RC::INTERNAL;
   }
 
-  if (!field_value.isString()) {
+  // 只支持单字段索引时的元数据只有 field_name
+  vector<const char *> field_names;
+  const Json::Value   &field_names_value = json_value[FIELD_FIELD_NAMES];
+  if (field_names_value.isArray()) {
+    for (const Json::Value &value : field_names_value) {
+      if (!value.isString()) {
+        LOG_ERROR("Field name of index [%s] is not a string. json value=%s",
+            name_value.asCString(), value.toStyledString().c_str());
+        return RC::INTERNAL;
+      }
+      field_names.push_back(value.asCString());
+    }
+  } else if (field_value.isString()) {
+    field_names.push_back(field_value.asCString());
+  } else {
     LOG_ERROR("Field name of index [%s] is not a string. json value=%s",
         name_value.asCString(), field_value.toStyledString().c_str());
     return RC::INTERNAL;
   }
 
-  const FieldMeta *field = table.field(field_value.asCString());
-  if (nullptr == field) {
-    LOG_ERROR("Deserialize index [%s]: no such field: %s", name_value.asCString(), field_value.asCString());
-    return RC::SCHEMA_FIELD_MISSING;
+  vector<const FieldMeta *> fields;
+  for (const char *field_name : field_names) {
+    const FieldMeta *field = table.field(field_name);
+    if (nullptr == field) {
+      LOG_ERROR("Deserialize index [%s]: no such field: %s", name_value.asCString(), field_name);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    fields.push_back(field);
+  }
+
+  vector<const FieldMeta *> include_fields;
+  const Json::Value        &include_names_value = json_value[FIELD_INCLUDE_FIELD_NAMES];
+  if (include_names_value.isArray()) {
+    for (const Json::Value &value : include_names_value) {
+      const FieldMeta *field = value.isString() ? table.field(value.asCString()) : nullptr;
+      if (nullptr == field) {
+        LOG_ERROR("Deserialize index [%s]: invalid include field: %s",
+            name_value.asCString(), value.toStyledString().c_str());
+        return RC::SCHEMA_FIELD_MISSING;
+      }
+      include_fields.push_back(field);
+    }
   }
 
-  return index.init(name_value.asCString(), *field);
+  // 没有记录类型的是之前创建的B+树索引
+  IndexType          type       = IndexType::BPLUS_TREE;
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  if (!type_value.isNull() && (!type_value.isString() || OB_FAIL(index_type_from_string(type_value.asCString(), type)))) {
+    LOG_ERROR("Deserialize index [%s]: invalid index type: %s", name_value.asCString(), type_value.toStyledString().c_str());
+    return RC::INTERNAL;
+  }
+
+  const Json::Value &unique_value = json_value[FIELD_UNIQUE];
+  return index.init(
+      name_value.asCString(), fields, include_fields, unique_value.isBool() && unique_value.asBool(), type);
 }
 
 const char *IndexMeta::name() const { return name_.c_str(); }
 
-const char *IndexMeta::field() const { return field_.c_str(); }
+const char *IndexMeta::field() const { return fields_.empty() ? "" : fields_[0].c_str(); }
 
-void IndexMeta::desc(ostream &os) const { os << "index name=" << name_ << ", field=" << field_; }
\ No newline at end of file
+void IndexMeta::desc(ostream &os) const
+{
+  os << "index name=" << name_ << (unique_ ? ", unique" : "");
+  if (type_ != IndexType::BPLUS_TREE) {
+    os << ", type=" << index_type_to_string(type_);
+  }
+  os << ", field=";
+  for (size_t i = 0; i < fields_.size(); i++) {
+    if (i > 0) {
+      os << ",";
+    }
+    os << fields_[i];
+  }
+  if (!include_fields_.empty()) {
+    os << ", include=";
+    for (size_t i = 0; i < include_fields_.size(); i++) {
+      if (i > 0) {
+        os << ",";
+      }
+      os << include_fields_[i];
+    }
+  }
+}
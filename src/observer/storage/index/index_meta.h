@@ -15,7 +15,9 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/lang/span.h"
 #include "common/lang/string.h"
+#include "common/lang/vector.h"
 
 class TableMeta;
 class FieldMeta;
@@ -24,6 +26,24 @@ namespace Json {
 class Value;
 }  // namespace Json
 
+/**
+ * @brief 索引的类型
+ * @ingroup Index
+ */
+enum class IndexType
+{
+  BPLUS_TREE,  ///< B+树，默认的索引类型，参考 BplusTreeIndex
+  HASH,        ///< 线性哈希，只支持等值查找，参考 HashIndex
+};
+
+const char *index_type_to_string(IndexType type);
+
+/**
+ * @brief 根据名字(不区分大小写)查找索引类型
+ * @return 没有找到时返回 RC::INVALID_ARGUMENT
+ */
+RC index_type_from_string(const char *name, IndexType &type);
+
 /**
  * @brief 描述一个索引
  * @ingroup Index
@@ -37,9 +57,35 @@ public:
 
   RC init(const char *name, const FieldMeta &field);
 
+  /**
+   * @brief 初始化一个多字段的索引
+   * @param fields 索引包含的字段，按照键值中的顺序排列
+   */
+  RC init(const char *name, span<const FieldMeta *const> fields);
+
+  /**
+   * @brief 初始化一个带有包含字段(INCLUDE)的索引
+   * @details 包含字段不参与键值的比较，只是和RID一起存放在叶子节点中，
+   * 查询只用到键值字段和包含字段时可以不读取记录
+   * @param include_fields 包含字段，不能和键值字段重复
+   * @param unique 是否是唯一索引，键值字段的值不能重复
+   * @param type 索引的类型
+   */
+  RC init(const char *name, span<const FieldMeta *const> fields, span<const FieldMeta *const> include_fields,
+      bool unique = false, IndexType type = IndexType::BPLUS_TREE);
+
 public:
   const char *name() const;
-  const char *field() const;
+  const char *field() const;  ///< 第一个字段的名字
+
+  const vector<string> &fields() const { return fields_; }
+  int                   field_num() const { return static_cast<int>(fields_.size()); }
+
+  const vector<string> &include_fields() const { return include_fields_; }
+
+  bool unique() const { return unique_; }
+
+  IndexType type() const { return type_; }
 
   void desc(ostream &os) const;
 
@@ -48,6 +94,9 @@ public:
   static RC from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index);
 
 protected:
-  string name_;   // index's name
-  string field_;  // field's name
+  string         name_;    // index's name
+  vector<string> fields_;          // fields' name
+  vector<string> include_fields_;  ///< 包含字段的名字，按照叶子节点中存放的顺序排列
+  bool           unique_ = false;  ///< 是否是唯一索引
+  IndexType      type_   = IndexType::BPLUS_TREE;  ///< 索引的类型
 };
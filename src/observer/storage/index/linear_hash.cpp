@@ -0,0 +1,565 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/linear_hash.h"
+#include "common/log/log.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/sstream.h"
+#include "storage/index/latch_memo.h"
+#include "storage/index/linear_hash_log.h"
+
+using namespace common;
+
+string LinearHashFileHeader::to_string() const
+{
+  stringstream ss;
+  ss << "attr_length:" << attr_length << ","
+     << "attr_num:" << attr_num << ","
+     << "entry_size:" << entry_size << ","
+     << "unique_keys:" << unique_keys << ","
+     << "level:" << level << ","
+     << "next_split:" << next_split << ","
+     << "bucket_num:" << bucket_num;
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashBucketHandler
+LinearHashBucketHandler::LinearHashBucketHandler(Frame *frame, int entry_size, LinearHashLogger *logger)
+    : frame_(frame), bucket_(reinterpret_cast<LinearHashBucket *>(frame->data())), entry_size_(entry_size),
+      logger_(logger)
+{}
+
+RC LinearHashBucketHandler::init_empty()
+{
+  bucket_->next_page = BP_INVALID_PAGE_NUM;
+  bucket_->size      = 0;
+  frame_->mark_dirty();
+  return logger_ == nullptr ? RC::SUCCESS : logger_->bucket_init_empty(frame_);
+}
+
+RC LinearHashBucketHandler::append(const char *entry)
+{
+  if (full()) {
+    LOG_WARN("bucket page is full. page_num=%d, size=%d", frame_->page_num(), bucket_->size);
+    return RC::INTERNAL;
+  }
+
+  memcpy(bucket_->entries + bucket_->size * entry_size_, entry, entry_size_);
+  bucket_->size++;
+  frame_->mark_dirty();
+  return logger_ == nullptr ? RC::SUCCESS : logger_->bucket_append(frame_, span<const char>(entry, entry_size_));
+}
+
+RC LinearHashBucketHandler::remove(int index)
+{
+  if (index < 0 || index >= bucket_->size) {
+    LOG_WARN("invalid entry index. page_num=%d, index=%d, size=%d", frame_->page_num(), index, bucket_->size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int last = bucket_->size - 1;
+  if (index != last) {
+    memcpy(bucket_->entries + index * entry_size_, bucket_->entries + last * entry_size_, entry_size_);
+  }
+  bucket_->size--;
+  frame_->mark_dirty();
+  return logger_ == nullptr ? RC::SUCCESS : logger_->bucket_remove(frame_, entry_size_, index);
+}
+
+RC LinearHashBucketHandler::set_next_page(PageNum page_num)
+{
+  bucket_->next_page = page_num;
+  frame_->mark_dirty();
+  return logger_ == nullptr ? RC::SUCCESS : logger_->bucket_set_next_page(frame_, page_num);
+}
+
+RC LinearHashBucketHandler::reset(const char *entries, int num)
+{
+  if (num < 0 || num > capacity(entry_size_)) {
+    LOG_WARN("too many entries for a bucket page. page_num=%d, num=%d", frame_->page_num(), num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (num > 0) {
+    memcpy(bucket_->entries, entries, num * entry_size_);
+  }
+  bucket_->size = num;
+  frame_->mark_dirty();
+  return logger_ == nullptr ? RC::SUCCESS
+                            : logger_->bucket_reset(frame_, entry_size_, span<const char>(entries, num * entry_size_), num);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashHandler
+LinearHashHandler::~LinearHashHandler() { close(); }
+
+bool LinearHashHandler::support_attr_type(AttrType attr_type)
+{
+  switch (attr_type) {
+    case AttrType::INTS:
+    case AttrType::CHARS:
+    case AttrType::BOOLEANS: return true;
+    default: return false;
+  }
+}
+
+RC LinearHashHandler::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    span<const AttrType> attr_types, span<const int> attr_lengths, bool unique_keys /* = false */)
+{
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  DiskBufferPool *bp = nullptr;
+
+  rc = bpm.open_file(log_handler, file_name, bp);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  rc = this->create(log_handler, *bp, attr_types, attr_lengths, unique_keys);
+  if (OB_FAIL(rc)) {
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  LOG_INFO("Successfully create linear hash file %s.", file_name);
+  return rc;
+}
+
+RC LinearHashHandler::create(LogHandler &log_handler, DiskBufferPool &buffer_pool, span<const AttrType> attr_types,
+    span<const int> attr_lengths, bool unique_keys /* = false */)
+{
+  if (attr_types.empty() || attr_types.size() != attr_lengths.size() ||
+      attr_types.size() > static_cast<size_t>(LinearHashFileHeader::MAX_ATTR_NUM)) {
+    LOG_WARN("invalid attributes of linear hash. attr num=%d", static_cast<int>(attr_types.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  int attr_length = 0;
+  for (size_t i = 0; i < attr_types.size(); i++) {
+    if (!support_attr_type(attr_types[i])) {
+      LOG_WARN("unsupported attr type of linear hash. type=%s", attr_type_to_string(attr_types[i]));
+      return RC::INVALID_ARGUMENT;
+    }
+    attr_length += attr_lengths[i];
+  }
+
+  const int entry_size = LinearHashBucket::HASH_SIZE + attr_length + static_cast<int>(sizeof(RID));
+  if (LinearHashBucketHandler::capacity(entry_size) < 1) {
+    LOG_WARN("key is too long for linear hash. attr length=%d", attr_length);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  LatchMemo latch_memo(&buffer_pool);
+
+  Frame *header_frame = nullptr;
+
+  RC rc = latch_memo.allocate_page(header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate header page for linear hash. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (header_frame->page_num() != LinearHashFileHeader::PAGE_NUM) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file",
+             LinearHashFileHeader::PAGE_NUM, header_frame->page_num());
+    return RC::INTERNAL;
+  }
+
+  LinearHashFileHeader header{};
+  header.attr_length = attr_length;
+  header.attr_num    = static_cast<int32_t>(attr_types.size());
+  for (size_t i = 0; i < attr_types.size(); i++) {
+    header.attr_types[i]   = attr_types[i];
+    header.attr_lengths[i] = attr_lengths[i];
+  }
+  header.entry_size  = entry_size;
+  header.unique_keys = unique_keys ? 1 : 0;
+  header.level       = 0;
+  header.next_split  = 0;
+  header.bucket_num  = LinearHashFileHeader::INITIAL_BUCKET_NUM;
+
+  PageNum *bucket_pages = LinearHashFileHeader::bucket_pages(header_frame->data());
+  for (int i = 0; i < header.bucket_num; i++) {
+    Frame *frame = nullptr;
+    rc           = latch_memo.allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate bucket page for linear hash. rc=%s", strrc(rc));
+      return rc;
+    }
+    LinearHashBucketHandler(frame, entry_size).init_empty();
+    bucket_pages[i] = frame->page_num();
+  }
+
+  memcpy(header_frame->data(), &header, sizeof(header));
+  header_frame->mark_dirty();
+
+  log_handler_      = &log_handler;
+  disk_buffer_pool_ = &buffer_pool;
+  file_header_      = header;
+  bucket_pages_.assign(bucket_pages, bucket_pages + header.bucket_num);
+  attr_comparator_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
+
+  // 与B+树一样，创建时的页面不记录日志，直接刷到磁盘。重做时总是可以读到正确的头页面和初始的桶
+  rc = buffer_pool.flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush linear hash pages. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("Successfully create linear hash. header=%s", file_header_.to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("%s has been opened before index.open.", file_name);
+    return RC::RECORD_OPENNED;
+  }
+
+  DiskBufferPool *disk_buffer_pool = nullptr;
+
+  RC rc = bpm.open_file(log_handler, file_name, disk_buffer_pool);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  rc = this->open(log_handler, *disk_buffer_pool);
+  if (OB_SUCC(rc)) {
+    LOG_INFO("open linear hash success. filename=%s", file_name);
+  }
+  return rc;
+}
+
+RC LinearHashHandler::open(LogHandler &log_handler, DiskBufferPool &buffer_pool)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("linear hash has been opened before index.open.");
+    return RC::RECORD_OPENNED;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool.get_this_page(LinearHashFileHeader::PAGE_NUM, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to get header page, rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  memcpy(&file_header_, frame->data(), sizeof(file_header_));
+  const PageNum *bucket_pages = LinearHashFileHeader::bucket_pages(frame->data());
+  bucket_pages_.assign(bucket_pages, bucket_pages + file_header_.bucket_num);
+  buffer_pool.unpin_page(frame);
+
+  log_handler_      = &log_handler;
+  disk_buffer_pool_ = &buffer_pool;
+  attr_comparator_.init(file_header_.attr_type_list(), file_header_.attr_length_list());
+  LOG_INFO("Successfully open linear hash. header=%s", file_header_.to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::close()
+{
+  if (disk_buffer_pool_ != nullptr) {
+    disk_buffer_pool_->close_file();
+  }
+
+  disk_buffer_pool_ = nullptr;
+  bucket_pages_.clear();
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::sync() { return disk_buffer_pool_->flush_all_pages(); }
+
+uint32_t LinearHashHandler::hash(const char *user_key) const
+{
+  // FNV-1a，最后再用 murmur3 的 fmix64 打散一下，因为分桶只使用了哈希值的低位
+  uint64_t value = 14695981039346656037ULL;
+  for (int i = 0; i < attr_comparator_.attr_num(); i++) {
+    const char *data   = user_key + attr_comparator_.attr_offset(i);
+    size_t      length = attr_comparator_.attr_length(i);
+    if (attr_comparator_.attr_type(i) == AttrType::CHARS) {
+      // 字符串比较到 '\0' 为止，后面的字节不应该影响哈希值
+      length = strnlen(data, length);
+    }
+    for (size_t j = 0; j < length; j++) {
+      value ^= static_cast<unsigned char>(data[j]);
+      value *= 1099511628211ULL;
+    }
+    value ^= 0xff;  // 字段之间的分隔，避免 ("ab", "c") 与 ("a", "bc") 总是相同
+    value *= 1099511628211ULL;
+  }
+
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return static_cast<uint32_t>(value);
+}
+
+int LinearHashHandler::bucket_of(uint32_t hash_value) const
+{
+  const uint32_t round_num = file_header_.round_bucket_num();
+  uint32_t       bucket    = hash_value & (round_num - 1);
+  if (bucket < static_cast<uint32_t>(file_header_.next_split)) {
+    bucket = hash_value & (round_num * 2 - 1);
+  }
+  return static_cast<int>(bucket);
+}
+
+RC LinearHashHandler::get_bucket_pages(LatchMemo &latch_memo, int bucket, vector<Frame *> &frames)
+{
+  frames.clear();
+  PageNum page_num = bucket_pages_[bucket];
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC     rc    = latch_memo.get_page(page_num, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get bucket page. bucket=%d, page_num=%d, rc=%s", bucket, page_num, strrc(rc));
+      return rc;
+    }
+    frames.push_back(frame);
+    page_num = LinearHashBucketHandler(frame, file_header_.entry_size).next_page();
+  }
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::get_entries(const char *user_key, vector<RID> &rids)
+{
+  LatchMemo latch_memo(disk_buffer_pool_);
+  latch_memo.slatch(&lock_);
+
+  const uint32_t  hash_value = hash(user_key);
+  vector<Frame *> frames;
+  RC              rc = get_bucket_pages(latch_memo, bucket_of(hash_value), frames);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int rid_offset = LinearHashBucket::HASH_SIZE + file_header_.attr_length;
+  for (Frame *frame : frames) {
+    LinearHashBucketHandler bucket(frame, file_header_.entry_size);
+    for (int i = 0; i < bucket.size(); i++) {
+      const char *entry = bucket.entry_at(i);
+      if (bucket.hash_at(i) == hash_value && attr_comparator_(entry + LinearHashBucket::HASH_SIZE, user_key) == 0) {
+        rids.push_back(*reinterpret_cast<const RID *>(entry + rid_offset));
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::insert_entry(const char *user_key, const RID &rid)
+{
+  const uint32_t hash_value = hash(user_key);
+  const int      entry_size = file_header_.entry_size;
+  const int      rid_offset = LinearHashBucket::HASH_SIZE + file_header_.attr_length;
+  vector<char>   entry(entry_size);
+  memcpy(entry.data(), &hash_value, LinearHashBucket::HASH_SIZE);
+  memcpy(entry.data() + LinearHashBucket::HASH_SIZE, user_key, file_header_.attr_length);
+  memcpy(entry.data() + rid_offset, &rid, sizeof(rid));
+
+  // logger 在 latch_memo 之前析构，保证日志先于释放页面写入
+  LatchMemo        latch_memo(disk_buffer_pool_);
+  LinearHashLogger logger(*log_handler_, disk_buffer_pool_->id());
+  latch_memo.xlatch(&lock_);
+
+  bool            split_tried = false;
+  vector<Frame *> frames;
+  while (true) {
+    RC rc = get_bucket_pages(latch_memo, bucket_of(hash_value), frames);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    Frame *free_frame = nullptr;
+    for (Frame *frame : frames) {
+      LinearHashBucketHandler bucket(frame, entry_size);
+      for (int i = 0; i < bucket.size(); i++) {
+        const char *item = bucket.entry_at(i);
+        if (bucket.hash_at(i) != hash_value || attr_comparator_(item + LinearHashBucket::HASH_SIZE, user_key) != 0) {
+          continue;
+        }
+        if (file_header_.unique_keys != 0 || *reinterpret_cast<const RID *>(item + rid_offset) == rid) {
+          return RC::RECORD_DUPLICATE_KEY;
+        }
+      }
+      if (free_frame == nullptr && !bucket.full()) {
+        free_frame = frame;
+      }
+    }
+
+    if (free_frame != nullptr) {
+      rc = LinearHashBucketHandler(free_frame, entry_size, &logger).append(entry.data());
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      return logger.commit();
+    }
+
+    // 桶满了，先分裂一个桶。分裂的不一定是当前的桶，所以分裂之后当前的桶可能还是满的
+    if (!split_tried && file_header_.bucket_num < LinearHashFileHeader::max_bucket_num()) {
+      split_tried = true;
+      rc          = split(latch_memo, logger);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to split bucket. rc=%s", strrc(rc));
+        return rc;
+      }
+      continue;
+    }
+
+    Frame *overflow_frame = nullptr;
+    rc                    = latch_memo.allocate_page(overflow_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate overflow page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    LinearHashBucketHandler overflow_bucket(overflow_frame, entry_size, &logger);
+    overflow_bucket.init_empty();
+    overflow_bucket.append(entry.data());
+    LinearHashBucketHandler(frames.back(), entry_size, &logger).set_next_page(overflow_frame->page_num());
+    return logger.commit();
+  }
+}
+
+RC LinearHashHandler::delete_entry(const char *user_key, const RID &rid)
+{
+  const uint32_t hash_value = hash(user_key);
+  const int      rid_offset = LinearHashBucket::HASH_SIZE + file_header_.attr_length;
+
+  LatchMemo        latch_memo(disk_buffer_pool_);
+  LinearHashLogger logger(*log_handler_, disk_buffer_pool_->id());
+  latch_memo.xlatch(&lock_);
+
+  vector<Frame *> frames;
+  RC              rc = get_bucket_pages(latch_memo, bucket_of(hash_value), frames);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 删除后的空溢出页面留在链表中，后面的插入还可以使用
+  for (Frame *frame : frames) {
+    LinearHashBucketHandler bucket(frame, file_header_.entry_size, &logger);
+    for (int i = 0; i < bucket.size(); i++) {
+      const char *item = bucket.entry_at(i);
+      if (bucket.hash_at(i) == hash_value && attr_comparator_(item + LinearHashBucket::HASH_SIZE, user_key) == 0 &&
+          *reinterpret_cast<const RID *>(item + rid_offset) == rid) {
+        rc = bucket.remove(i);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        return logger.commit();
+      }
+    }
+  }
+  return RC::RECORD_NOT_EXIST;
+}
+
+RC LinearHashHandler::split(LatchMemo &latch_memo, LinearHashLogger &logger)
+{
+  const int entry_size = file_header_.entry_size;
+  const int capacity   = LinearHashBucketHandler::capacity(entry_size);
+  const int old_bucket = file_header_.next_split;
+  const int new_bucket = file_header_.bucket_num;
+  const uint32_t mask  = static_cast<uint32_t>(file_header_.round_bucket_num()) * 2 - 1;
+
+  vector<Frame *> old_frames;
+  RC              rc = get_bucket_pages(latch_memo, old_bucket, old_frames);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  vector<char> stay_entries;
+  vector<char> move_entries;
+  for (Frame *frame : old_frames) {
+    LinearHashBucketHandler bucket(frame, entry_size);
+    for (int i = 0; i < bucket.size(); i++) {
+      const char   *entry   = bucket.entry_at(i);
+      vector<char> &entries = (bucket.hash_at(i) & mask) == static_cast<uint32_t>(old_bucket) ? stay_entries : move_entries;
+      entries.insert(entries.end(), entry, entry + entry_size);
+    }
+  }
+
+  const int stay_num   = static_cast<int>(stay_entries.size() / entry_size);
+  const int move_num   = static_cast<int>(move_entries.size() / entry_size);
+  const int stay_pages = max(1, (stay_num + capacity - 1) / capacity);
+  const int move_pages = max(1, (move_num + capacity - 1) / capacity);
+
+  // 修改页面之前把需要的页面都准备好
+  Frame *header_frame = nullptr;
+  rc                  = latch_memo.get_page(LinearHashFileHeader::PAGE_NUM, header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  vector<Frame *> new_frames;
+  for (int i = 0; i < move_pages; i++) {
+    Frame *frame = nullptr;
+    rc           = latch_memo.allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate page for new bucket. rc=%s", strrc(rc));
+      for (Frame *new_frame : new_frames) {
+        latch_memo.dispose_page(new_frame->page_num());
+      }
+      return rc;
+    }
+    new_frames.push_back(frame);
+  }
+
+  // 原来的桶保留前面几个页面，多余的页面释放掉
+  for (int i = 0; i < static_cast<int>(old_frames.size()); i++) {
+    if (i >= stay_pages) {
+      latch_memo.dispose_page(old_frames[i]->page_num());
+      continue;
+    }
+
+    LinearHashBucketHandler bucket(old_frames[i], entry_size, &logger);
+    const int               num = min(capacity, stay_num - i * capacity);
+    bucket.reset(stay_entries.data() + static_cast<size_t>(i) * capacity * entry_size, max(0, num));
+    if (i == stay_pages - 1 && bucket.next_page() != BP_INVALID_PAGE_NUM) {
+      bucket.set_next_page(BP_INVALID_PAGE_NUM);
+    }
+  }
+
+  for (int i = 0; i < move_pages; i++) {
+    LinearHashBucketHandler bucket(new_frames[i], entry_size, &logger);
+    const int               num = min(capacity, move_num - i * capacity);
+    bucket.init_empty();
+    bucket.reset(move_entries.data() + static_cast<size_t>(i) * capacity * entry_size, max(0, num));
+    if (i + 1 < move_pages) {
+      bucket.set_next_page(new_frames[i + 1]->page_num());
+    }
+  }
+
+  file_header_.bucket_num++;
+  file_header_.next_split++;
+  if (file_header_.next_split == file_header_.round_bucket_num()) {
+    file_header_.level++;
+    file_header_.next_split = 0;
+  }
+  bucket_pages_.push_back(new_frames[0]->page_num());
+
+  memcpy(header_frame->data(), &file_header_, sizeof(file_header_));
+  LinearHashFileHeader::bucket_pages(header_frame->data())[new_bucket] = new_frames[0]->page_num();
+  header_frame->mark_dirty();
+  logger.update_header(header_frame, file_header_, new_bucket, new_frames[0]->page_num());
+
+  LOG_DEBUG("split linear hash bucket %d into %d. stay=%d, move=%d", old_bucket, new_bucket, stay_num, move_num);
+  return RC::SUCCESS;
+}
@@ -0,0 +1,209 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/mutex.h"
+#include "common/lang/span.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+
+class LatchMemo;
+class LinearHashLogger;
+
+/**
+ * @brief 线性哈希
+ * @defgroup LinearHash
+ * @details 磁盘上的线性哈希表，只支持等值查找。每个桶是一个页面，放满之后再链接溢出页面。
+ * 插入时需要新的溢出页面，就分裂 next_split 指向的桶：把这个桶中的数据按照下一轮的桶个数重新分配到
+ * 它自己和新的桶中，然后 next_split 向后移动一个。next_split 走完一轮之后，桶的个数翻倍，进入下一轮。
+ * 所以桶的个数是逐个增长的，不需要像可扩展哈希那样一次把目录翻倍。
+ */
+
+/**
+ * @brief 线性哈希文件的头页面
+ * @ingroup LinearHash
+ * @details 页面中这个结构之后是每个桶第一个页面的页号，桶的个数受页面大小限制，参考 max_bucket_num。
+ * 桶的个数到达上限之后不再分裂，只会增加溢出页面。
+ */
+struct LinearHashFileHeader
+{
+  static constexpr int MAX_ATTR_NUM       = IndexFileHeader::MAX_ATTR_NUM;  ///< 键值最多包含的字段数
+  static constexpr int INITIAL_BUCKET_NUM = 4;                              ///< 第0轮的桶个数，需要是2的幂
+  static constexpr PageNum PAGE_NUM       = 1;                              ///< 头页面的页号
+
+  int32_t  attr_length;                 ///< 键值的长度，所有字段长度的和
+  int32_t  attr_num;                    ///< 键值包含的字段数
+  AttrType attr_types[MAX_ATTR_NUM];    ///< 每个字段的类型
+  int32_t  attr_lengths[MAX_ATTR_NUM];  ///< 每个字段的长度
+  int32_t  entry_size;                  ///< 桶中每个元素的长度，哈希值 + 键值 + RID
+  int32_t  unique_keys;                 ///< 是否不允许插入相同的键值
+  int32_t  level;                       ///< 当前的轮次，这一轮开始时有 INITIAL_BUCKET_NUM * 2^level 个桶
+  int32_t  next_split;                  ///< 下一个要分裂的桶
+  int32_t  bucket_num;                  ///< 当前桶的个数
+
+  span<const AttrType> attr_type_list() const { return span<const AttrType>(attr_types, attr_num); }
+  span<const int>      attr_length_list() const { return span<const int>(attr_lengths, attr_num); }
+
+  /// @brief 这一轮开始时桶的个数
+  int32_t round_bucket_num() const { return INITIAL_BUCKET_NUM << level; }
+
+  /// @brief 头页面中最多可以记录多少个桶
+  static int max_bucket_num()
+  {
+    return static_cast<int>((BP_PAGE_DATA_SIZE - sizeof(LinearHashFileHeader)) / sizeof(PageNum));
+  }
+
+  /// @brief 头页面中记录每个桶第一个页面页号的数组
+  static PageNum *bucket_pages(char *page_data)
+  {
+    return reinterpret_cast<PageNum *>(page_data + sizeof(LinearHashFileHeader));
+  }
+
+  string to_string() const;
+};
+
+/**
+ * @brief 桶页面
+ * @ingroup LinearHash
+ * @details 元素没有顺序，插入时追加到最后，删除时把最后一个元素移动到删除的位置。
+ * 每个元素前面存放键值的哈希值，查找时先比较哈希值，大部分元素不需要调用键值的比较函数，
+ * 分裂时也不需要重新计算哈希值
+ */
+struct LinearHashBucket
+{
+  static constexpr int HEADER_SIZE = 8;
+  static constexpr int HASH_SIZE   = sizeof(uint32_t);  ///< 元素中哈希值的长度，之后是键值和RID
+
+  PageNum next_page;   ///< 溢出页面，没有时是 BP_INVALID_PAGE_NUM
+  int32_t size;        ///< 当前元素个数
+  char    entries[0];  ///< 元素，每个是 哈希值 + 键值 + RID
+};
+
+/**
+ * @brief 操作一个桶页面
+ * @ingroup LinearHash
+ * @details 修改页面的同时记录日志，重做日志时 logger 是空的
+ */
+class LinearHashBucketHandler
+{
+public:
+  LinearHashBucketHandler(Frame *frame, int entry_size, LinearHashLogger *logger = nullptr);
+
+  /// @brief 一个页面可以放多少个元素
+  static int capacity(int entry_size) { return (BP_PAGE_DATA_SIZE - LinearHashBucket::HEADER_SIZE) / entry_size; }
+
+  int         size() const { return bucket_->size; }
+  bool        full() const { return bucket_->size >= capacity(entry_size_); }
+  PageNum     next_page() const { return bucket_->next_page; }
+  const char *entry_at(int index) const { return bucket_->entries + index * entry_size_; }
+  uint32_t    hash_at(int index) const { return *reinterpret_cast<const uint32_t *>(entry_at(index)); }
+
+  RC init_empty();
+  RC append(const char *entry);
+  RC remove(int index);
+  RC set_next_page(PageNum page_num);
+
+  /**
+   * @brief 用 entries 替换页面中所有的元素，分裂时使用
+   */
+  RC reset(const char *entries, int num);
+
+private:
+  Frame            *frame_      = nullptr;
+  LinearHashBucket *bucket_     = nullptr;
+  int               entry_size_ = 0;
+  LinearHashLogger *logger_     = nullptr;
+};
+
+/**
+ * @brief 线性哈希的操作入口
+ * @ingroup LinearHash
+ * @details 目前整个哈希表使用一把读写锁，查找时加读锁，修改时加写锁。
+ * 一次修改涉及的所有页面都记录在同一条日志中，参考 LinearHashLogger。
+ * 键值的比较与B+树一样使用 AttrComparator，哈希值只能对字节完全相同的键值保证相同，
+ * 所以不支持浮点数这种比较时有误差范围的类型，参考 support_attr_type。
+ */
+class LinearHashHandler
+{
+public:
+  LinearHashHandler() = default;
+  ~LinearHashHandler();
+
+  /**
+   * @brief 创建一个线性哈希表
+   * @param unique_keys 是否不允许插入相同的键值
+   */
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, span<const AttrType> attr_types,
+      span<const int> attr_lengths, bool unique_keys = false);
+  RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, span<const AttrType> attr_types,
+      span<const int> attr_lengths, bool unique_keys = false);
+
+  RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name);
+  RC open(LogHandler &log_handler, DiskBufferPool &buffer_pool);
+  RC close();
+
+  /**
+   * @brief 插入一条数据
+   * @details 唯一索引中已经有相同的键值时返回 RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID &rid);
+
+  /**
+   * @brief 删除一条数据，没有找到时返回 RECORD_NOT_EXIST
+   */
+  RC delete_entry(const char *user_key, const RID &rid);
+
+  /**
+   * @brief 查找键值对应的所有数据
+   * @param user_key 完整的键值，长度是 attr_length
+   */
+  RC get_entries(const char *user_key, vector<RID> &rids);
+
+  RC sync();
+
+  const LinearHashFileHeader &file_header() const { return file_header_; }
+
+  /// @brief 是否可以用这种类型的字段做键值
+  static bool support_attr_type(AttrType attr_type);
+
+private:
+  /**
+   * @brief 键值的哈希值
+   * @details 哈希值决定了数据放在哪个桶中，会持久化到文件里，所以不能使用 std::hash 这种
+   * 在不同的实现中可能不同的函数
+   */
+  uint32_t hash(const char *user_key) const;
+
+  int bucket_of(uint32_t hash_value) const;
+
+  /**
+   * @brief 分裂 next_split 指向的桶
+   * @details 需要的页面都先分配好，再修改页面，中途不会失败
+   */
+  RC split(LatchMemo &latch_memo, LinearHashLogger &logger);
+
+  /**
+   * @brief 读取一个桶中所有的页面
+   * @details 页面的并发访问由整个哈希表的锁保护，这里只 pin 住页面
+   */
+  RC get_bucket_pages(LatchMemo &latch_memo, int bucket, vector<Frame *> &frames);
+
+private:
+  LogHandler          *log_handler_      = nullptr;
+  DiskBufferPool      *disk_buffer_pool_ = nullptr;
+  LinearHashFileHeader file_header_{};
+  vector<PageNum>      bucket_pages_;  ///< 头页面中每个桶第一个页面的页号
+  AttrComparator       attr_comparator_;
+  common::SharedMutex  lock_;
+};
@@ -0,0 +1,303 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/linear_hash_log.h"
+#include "common/log/log.h"
+#include "common/lang/sstream.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/log_entry.h"
+#include "storage/clog/log_handler.h"
+#include "storage/index/linear_hash.h"
+
+using namespace common;
+
+namespace {
+
+const char *operation_name(LinearHashOperation type)
+{
+  switch (type) {
+    case LinearHashOperation::INIT_BUCKET: return "INIT_BUCKET";
+    case LinearHashOperation::APPEND: return "APPEND";
+    case LinearHashOperation::REMOVE: return "REMOVE";
+    case LinearHashOperation::SET_NEXT_PAGE: return "SET_NEXT_PAGE";
+    case LinearHashOperation::RESET_BUCKET: return "RESET_BUCKET";
+    case LinearHashOperation::UPDATE_HEADER: return "UPDATE_HEADER";
+    default: return "UNKNOWN";
+  }
+}
+
+/**
+ * @brief 读取一个操作的参数，frame 不为空时把操作应用到页面上
+ * @details 重做和打印日志时都需要按照同样的格式解析日志，所以放在一起
+ */
+RC parse_operation(Deserializer &buffer, LinearHashOperation type, Frame *frame, ostream &os)
+{
+  int32_t entry_size = 0;
+  switch (type) {
+    case LinearHashOperation::INIT_BUCKET: {
+      if (frame != nullptr) {
+        return LinearHashBucketHandler(frame, 1).init_empty();
+      }
+    } break;
+
+    case LinearHashOperation::APPEND: {
+      if (buffer.read_int32(entry_size) != 0 || entry_size <= 0) {
+        return RC::IOERR_READ;
+      }
+      vector<char> entry(entry_size);
+      if (buffer.read(entry.data(), entry_size) != 0) {
+        return RC::IOERR_READ;
+      }
+      os << ",entry_size:" << entry_size;
+      if (frame != nullptr) {
+        return LinearHashBucketHandler(frame, entry_size).append(entry.data());
+      }
+    } break;
+
+    case LinearHashOperation::REMOVE: {
+      int32_t index = -1;
+      if (buffer.read_int32(entry_size) != 0 || entry_size <= 0 || buffer.read_int32(index) != 0) {
+        return RC::IOERR_READ;
+      }
+      os << ",entry_size:" << entry_size << ",index:" << index;
+      if (frame != nullptr) {
+        return LinearHashBucketHandler(frame, entry_size).remove(index);
+      }
+    } break;
+
+    case LinearHashOperation::SET_NEXT_PAGE: {
+      int32_t page_num = BP_INVALID_PAGE_NUM;
+      if (buffer.read_int32(page_num) != 0) {
+        return RC::IOERR_READ;
+      }
+      os << ",next_page:" << page_num;
+      if (frame != nullptr) {
+        return LinearHashBucketHandler(frame, 1).set_next_page(page_num);
+      }
+    } break;
+
+    case LinearHashOperation::RESET_BUCKET: {
+      int32_t entry_num = 0;
+      if (buffer.read_int32(entry_size) != 0 || entry_size <= 0 || buffer.read_int32(entry_num) != 0 ||
+          entry_num < 0) {
+        return RC::IOERR_READ;
+      }
+      vector<char> entries(static_cast<size_t>(entry_size) * entry_num);
+      if (entry_num > 0 && buffer.read(entries.data(), static_cast<int>(entries.size())) != 0) {
+        return RC::IOERR_READ;
+      }
+      os << ",entry_size:" << entry_size << ",entry_num:" << entry_num;
+      if (frame != nullptr) {
+        return LinearHashBucketHandler(frame, entry_size).reset(entries.data(), entry_num);
+      }
+    } break;
+
+    case LinearHashOperation::UPDATE_HEADER: {
+      LinearHashFileHeader header;
+      int32_t              bucket      = -1;
+      int32_t              bucket_page = BP_INVALID_PAGE_NUM;
+      if (buffer.read(reinterpret_cast<char *>(&header), sizeof(header)) != 0 || buffer.read_int32(bucket) != 0 ||
+          buffer.read_int32(bucket_page) != 0) {
+        return RC::IOERR_READ;
+      }
+      if (bucket >= LinearHashFileHeader::max_bucket_num()) {
+        return RC::IOERR_READ;
+      }
+      os << ",header:" << header.to_string() << ",bucket:" << bucket << ",bucket_page:" << bucket_page;
+      if (frame != nullptr) {
+        memcpy(frame->data(), &header, sizeof(header));
+        if (bucket >= 0) {
+          LinearHashFileHeader::bucket_pages(frame->data())[bucket] = bucket_page;
+        }
+        frame->mark_dirty();
+      }
+    } break;
+
+    default: {
+      LOG_WARN("unknown linear hash operation. type=%d", static_cast<int>(type));
+      return RC::IOERR_READ;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashLogger
+LinearHashLogger::LinearHashLogger(LogHandler &log_handler, int32_t buffer_pool_id)
+    : log_handler_(log_handler), buffer_pool_id_(buffer_pool_id)
+{}
+
+LinearHashLogger::~LinearHashLogger() { commit(); }
+
+Serializer &LinearHashLogger::append_operation(Frame *frame, LinearHashOperation type)
+{
+  if (frames_.empty()) {
+    buffer_.write_int32(buffer_pool_id_);
+  }
+  frames_.push_back(frame);
+  buffer_.write_int32(static_cast<int32_t>(type));
+  buffer_.write_int32(frame->page_num());
+  return buffer_;
+}
+
+RC LinearHashLogger::bucket_init_empty(Frame *frame)
+{
+  append_operation(frame, LinearHashOperation::INIT_BUCKET);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::bucket_append(Frame *frame, span<const char> entry)
+{
+  Serializer &buffer = append_operation(frame, LinearHashOperation::APPEND);
+  buffer.write_int32(static_cast<int32_t>(entry.size()));
+  buffer.write(entry);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::bucket_remove(Frame *frame, int entry_size, int index)
+{
+  Serializer &buffer = append_operation(frame, LinearHashOperation::REMOVE);
+  buffer.write_int32(entry_size);
+  buffer.write_int32(index);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::bucket_set_next_page(Frame *frame, PageNum page_num)
+{
+  Serializer &buffer = append_operation(frame, LinearHashOperation::SET_NEXT_PAGE);
+  buffer.write_int32(page_num);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::bucket_reset(Frame *frame, int entry_size, span<const char> entries, int entry_num)
+{
+  Serializer &buffer = append_operation(frame, LinearHashOperation::RESET_BUCKET);
+  buffer.write_int32(entry_size);
+  buffer.write_int32(entry_num);
+  buffer.write(entries);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::update_header(Frame *frame, const LinearHashFileHeader &header, int bucket, PageNum bucket_page)
+{
+  Serializer &buffer = append_operation(frame, LinearHashOperation::UPDATE_HEADER);
+  buffer.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  buffer.write_int32(bucket);
+  buffer.write_int32(bucket_page);
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::commit()
+{
+  if (frames_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  LSN lsn = 0;
+  RC  rc  = log_handler_.append(lsn, LogModule::Id::LINEAR_HASH, std::move(buffer_.data()));
+  buffer_.data().clear();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to append log entry. rc=%s", strrc(rc));
+    frames_.clear();
+    return rc;
+  }
+
+  for (Frame *frame : frames_) {
+    frame->set_lsn(lsn);
+  }
+  frames_.clear();
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::redo(BufferPoolManager &bpm, const LogEntry &entry)
+{
+  ASSERT(entry.module().id() == LogModule::Id::LINEAR_HASH, "invalid log entry: %s", entry.to_string().c_str());
+
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  if (buffer.read_int32(buffer_pool_id) != 0) {
+    LOG_ERROR("failed to read buffer pool id");
+    return RC::IOERR_READ;
+  }
+
+  DiskBufferPool *buffer_pool = nullptr;
+  RC              rc          = bpm.get_buffer_pool(buffer_pool_id, buffer_pool);
+  if (OB_FAIL(rc) || buffer_pool == nullptr) {
+    LOG_WARN("failed to get buffer pool. rc=%s, buffer_pool_id=%d", strrc(rc), buffer_pool_id);
+    return rc;
+  }
+
+  // 同一个页面可能在一条日志中修改多次，所以所有操作都重做完之后再设置页面的LSN
+  vector<Frame *> frames;
+  stringstream    ignored;
+  while (OB_SUCC(rc) && buffer.remain() > 0) {
+    int32_t type     = -1;
+    int32_t page_num = BP_INVALID_PAGE_NUM;
+    if (buffer.read_int32(type) != 0 || buffer.read_int32(page_num) != 0) {
+      rc = RC::IOERR_READ;
+      break;
+    }
+
+    Frame *frame = nullptr;
+    rc           = buffer_pool->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page. buffer_pool_id=%d, page_num=%d, rc=%s", buffer_pool_id, page_num, strrc(rc));
+      break;
+    }
+    frames.push_back(frame);
+
+    Frame *redo_frame = frame->lsn() >= entry.lsn() ? nullptr : frame;
+    rc = parse_operation(buffer, static_cast<LinearHashOperation>(type), redo_frame, ignored);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to redo linear hash operation. lsn=%ld, type=%s, page_num=%d, rc=%s",
+               entry.lsn(), operation_name(static_cast<LinearHashOperation>(type)), page_num, strrc(rc));
+    }
+  }
+
+  for (Frame *frame : frames) {
+    if (OB_SUCC(rc) && frame->lsn() < entry.lsn()) {
+      frame->set_lsn(entry.lsn());
+    }
+    buffer_pool->unpin_page(frame);
+  }
+  return rc;
+}
+
+string LinearHashLogger::log_entry_to_string(const LogEntry &entry)
+{
+  stringstream ss;
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  if (buffer.read_int32(buffer_pool_id) != 0) {
+    return ss.str();
+  }
+
+  ss << "buffer_pool_id:" << buffer_pool_id;
+  while (buffer.remain() > 0) {
+    int32_t type     = -1;
+    int32_t page_num = BP_INVALID_PAGE_NUM;
+    if (buffer.read_int32(type) != 0 || buffer.read_int32(page_num) != 0) {
+      break;
+    }
+    ss << ";op:" << operation_name(static_cast<LinearHashOperation>(type)) << ",page_num:" << page_num;
+    if (OB_FAIL(parse_operation(buffer, static_cast<LinearHashOperation>(type), nullptr, ss))) {
+      break;
+    }
+  }
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashLogReplayer
+LinearHashLogReplayer::LinearHashLogReplayer(BufferPoolManager &bpm) : buffer_pool_manager_(bpm) {}
+
+RC LinearHashLogReplayer::replay(const LogEntry &entry) { return LinearHashLogger::redo(buffer_pool_manager_, entry); }
@@ -0,0 +1,99 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "common/lang/span.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/lang/serializer.h"
+#include "storage/clog/log_replayer.h"
+
+struct LinearHashFileHeader;
+class LogEntry;
+class LogHandler;
+class Frame;
+class BufferPoolManager;
+
+/**
+ * @brief 线性哈希日志中的操作类型
+ * @ingroup LinearHash
+ */
+enum class LinearHashOperation : int32_t
+{
+  INIT_BUCKET,    ///< 初始化一个空的桶页面
+  APPEND,         ///< 在桶页面中追加一个元素
+  REMOVE,         ///< 删除桶页面中的一个元素
+  SET_NEXT_PAGE,  ///< 修改桶页面的溢出页面
+  RESET_BUCKET,   ///< 替换桶页面中所有的元素
+  UPDATE_HEADER,  ///< 修改头页面，同时记录新增加的桶
+};
+
+/**
+ * @brief 记录线性哈希的日志
+ * @ingroup LinearHash
+ * @details 与B+树不同，这里记录的是物理日志，每个操作都记录了修改的页面和修改后的内容，
+ * 重做时不需要依赖头页面中的信息。一次插入或删除中所有的操作在 commit 时合并成一条日志，
+ * 这样分裂时修改的多个页面要么都重做，要么都不重做。
+ * 页面在修改之前就准备好了，修改过程不会失败，所以不需要回滚。
+ */
+class LinearHashLogger final
+{
+public:
+  LinearHashLogger(LogHandler &log_handler, int32_t buffer_pool_id);
+  ~LinearHashLogger();
+
+  RC bucket_init_empty(Frame *frame);
+  RC bucket_append(Frame *frame, span<const char> entry);
+  RC bucket_remove(Frame *frame, int entry_size, int index);
+  RC bucket_set_next_page(Frame *frame, PageNum page_num);
+  RC bucket_reset(Frame *frame, int entry_size, span<const char> entries, int entry_num);
+
+  /**
+   * @brief 修改头页面
+   * @param bucket 新增加的桶，没有时是 -1
+   * @param bucket_page 新增加的桶的第一个页面
+   */
+  RC update_header(Frame *frame, const LinearHashFileHeader &header, int bucket, PageNum bucket_page);
+
+  RC commit();
+
+  static RC     redo(BufferPoolManager &bpm, const LogEntry &entry);
+  static string log_entry_to_string(const LogEntry &entry);
+
+private:
+  /// @brief 记录操作的公共部分，返回的 Serializer 用来继续写入操作的参数
+  common::Serializer &append_operation(Frame *frame, LinearHashOperation type);
+
+private:
+  LogHandler        &log_handler_;
+  int32_t            buffer_pool_id_ = -1;
+  common::Serializer buffer_;          ///< 当前记录了的操作
+  vector<Frame *>    frames_;          ///< 当前记录的操作修改了的页面
+};
+
+/**
+ * @brief 线性哈希日志回放器
+ * @ingroup LinearHash
+ */
+class LinearHashLogReplayer final : public LogReplayer
+{
+public:
+  LinearHashLogReplayer(BufferPoolManager &bpm);
+  virtual ~LinearHashLogReplayer() = default;
+
+  /// @copydoc LogReplayer::replay
+  virtual RC replay(const LogEntry &entry) override;
+
+private:
+  BufferPoolManager &buffer_pool_manager_;
+};
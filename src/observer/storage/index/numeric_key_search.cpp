@@ -0,0 +1,186 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <type_traits>
+
+#include "storage/index/numeric_key_search.h"
+#include "common/defs.h"
+#include "common/log/log.h"
+#include "common/math/simd_util.h"
+#include "storage/record/record.h"
+
+namespace {
+
+/**
+ * @brief 节点中的一个数值类型的键值
+ * @details 节点中的元素不一定是对齐的，所以用 memcpy 读出来
+ */
+template <typename T>
+struct NumericKey
+{
+  T       value;
+  PageNum page_num;
+  SlotNum slot_num;
+
+  explicit NumericKey(const char *data)
+  {
+    memcpy(&value, data, sizeof(T));
+    memcpy(&page_num, data + sizeof(T), sizeof(PageNum));
+    memcpy(&slot_num, data + sizeof(T) + sizeof(PageNum), sizeof(SlotNum));
+  }
+
+  // 下面的比较都使用位运算，避免产生分支
+  bool rid_less(const NumericKey &other) const
+  {
+    return (page_num < other.page_num) | ((page_num == other.page_num) & (slot_num < other.slot_num));
+  }
+  bool rid_equal(const NumericKey &other) const
+  {
+    return (page_num == other.page_num) & (slot_num == other.slot_num);
+  }
+
+  bool less(const NumericKey &other) const;
+  bool equal(const NumericKey &other) const;
+};
+
+template <>
+bool NumericKey<int>::less(const NumericKey &other) const
+{
+  return (value < other.value) | ((value == other.value) & rid_less(other));
+}
+
+template <>
+bool NumericKey<int>::equal(const NumericKey &other) const
+{
+  return (value == other.value) & rid_equal(other);
+}
+
+// 与 common::compare_float 一样，差值在 EPSILON 之内就认为相等
+template <>
+bool NumericKey<float>::less(const NumericKey &other) const
+{
+  const float diff = value - other.value;
+  return (diff < -EPSILON) | (!(diff > EPSILON) & !(diff < -EPSILON) & rid_less(other));
+}
+
+template <>
+bool NumericKey<float>::equal(const NumericKey &other) const
+{
+  const float diff = value - other.value;
+  return !(diff > EPSILON) & !(diff < -EPSILON) & rid_equal(other);
+}
+
+#if defined(USE_SIMD)
+/**
+ * @brief 统计从 base 开始的 count 个元素中有多少个比 key 小
+ * @details count 不超过 SIMD_WIDTH。元素不是连续存放的数值，使用 gather 读取，
+ * 超出 count 的部分不会读取内存。
+ */
+int simd_count_less(const char *base, int item_size, int count, const NumericKey<int> &key)
+{
+  const __m256i lanes   = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i offsets = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(item_size));
+  const __m256i mask    = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), lanes);
+  const __m256i zero    = _mm256_setzero_si256();
+
+  const int *values_base = reinterpret_cast<const int *>(base);
+  const int *pages_base  = reinterpret_cast<const int *>(base + sizeof(int));
+  const int *slots_base  = reinterpret_cast<const int *>(base + sizeof(int) + sizeof(PageNum));
+
+  const __m256i values = _mm256_mask_i32gather_epi32(zero, values_base, offsets, mask, 1);
+  const __m256i pages  = _mm256_mask_i32gather_epi32(zero, pages_base, offsets, mask, 1);
+  const __m256i slots  = _mm256_mask_i32gather_epi32(zero, slots_base, offsets, mask, 1);
+
+  const __m256i key_value = _mm256_set1_epi32(key.value);
+  const __m256i key_page  = _mm256_set1_epi32(key.page_num);
+  const __m256i key_slot  = _mm256_set1_epi32(key.slot_num);
+
+  // value < key.value || (value == key.value && rid < key.rid)
+  const __m256i rid_less = _mm256_or_si256(_mm256_cmpgt_epi32(key_page, pages),
+      _mm256_and_si256(_mm256_cmpeq_epi32(pages, key_page), _mm256_cmpgt_epi32(key_slot, slots)));
+  __m256i less = _mm256_or_si256(
+      _mm256_cmpgt_epi32(key_value, values), _mm256_and_si256(_mm256_cmpeq_epi32(values, key_value), rid_less));
+  less = _mm256_and_si256(less, mask);
+  return __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+}
+#endif  // USE_SIMD
+
+/**
+ * @brief 没有分支的二分查找
+ * @details 每次比较之后只是选择保留前一半还是后一半，编译器可以使用条件传送指令，没有分支预测失败的开销。
+ * 剩下不超过 window 个元素时停止，返回剩余部分的起始位置和元素个数，结果一定在 [base, base + count] 中。
+ */
+template <typename T>
+const char *narrow_down(const char *items, int item_size, int &count, const NumericKey<T> &key, int window)
+{
+  const char *base = items;
+  while (count > window) {
+    const int   half = count / 2;
+    const char *mid  = base + half * item_size;
+    base             = NumericKey<T>(mid).less(key) ? mid : base;
+    count -= half;
+  }
+  return base;
+}
+
+template <typename T>
+int lower_bound(const char *items, int item_size, int item_num, const char *key_data, bool *found)
+{
+  const NumericKey<T> key(key_data);
+
+  int index = 0;
+  if (item_num > 0) {
+    int count = item_num;
+#if defined(USE_SIMD)
+    if constexpr (std::is_same_v<T, int>) {
+      const char *base = narrow_down(items, item_size, count, key, SIMD_WIDTH);
+      index            = static_cast<int>((base - items) / item_size) + simd_count_less(base, item_size, count, key);
+    } else
+#endif  // USE_SIMD
+    {
+      const char *base = narrow_down(items, item_size, count, key, 1 /*window*/);
+      index            = static_cast<int>((base - items) / item_size) + (NumericKey<T>(base).less(key) ? 1 : 0);
+    }
+  }
+
+  if (found != nullptr) {
+    *found = index < item_num && NumericKey<T>(items + index * item_size).equal(key);
+  }
+  return index;
+}
+
+}  // namespace
+
+KeySearchMethod key_search_method_of(span<const AttrType> types, span<const int> lengths)
+{
+  if (types.size() != 1 || lengths[0] != 4) {
+    return KeySearchMethod::GENERIC;
+  }
+
+  switch (types[0]) {
+    case AttrType::INTS: return KeySearchMethod::INTS;
+    case AttrType::FLOATS: return KeySearchMethod::FLOATS;
+    default: return KeySearchMethod::GENERIC;
+  }
+}
+
+int numeric_key_lower_bound(
+    KeySearchMethod method, const char *items, int item_size, int item_num, const char *key, bool *found)
+{
+  switch (method) {
+    case KeySearchMethod::INTS: return lower_bound<int>(items, item_size, item_num, key, found);
+    case KeySearchMethod::FLOATS: return lower_bound<float>(items, item_size, item_num, key, found);
+    default: {
+      ASSERT(false, "unsupported key search method: %d", static_cast<int>(method));
+      return -1;
+    }
+  }
+}
@@ -0,0 +1,47 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/span.h"
+#include "common/type/attr_type.h"
+
+/**
+ * @brief 在B+树节点中查找键值的方式
+ * @ingroup BPlusTree
+ * @details 只有一个 INTS 或 FLOATS 字段的索引，键值是 4字节的数值 + RID，可以直接按照数值比较，
+ * 不需要通过 KeyComparator 逐个字段构造 Value 再比较。
+ */
+enum class KeySearchMethod
+{
+  GENERIC,  ///< 使用 KeyComparator 二分查找
+  INTS,
+  FLOATS,
+};
+
+/**
+ * @brief 根据索引字段选择查找方式，在打开或创建索引时调用
+ */
+KeySearchMethod key_search_method_of(span<const AttrType> types, span<const int> lengths);
+
+/**
+ * @brief 在数值类型的键值中查找第一个不小于 key 的元素
+ * @details 使用没有分支的二分查找。编译时开启 USE_SIMD 时，INTS 类型剩下不超过 SIMD_WIDTH 个元素时，
+ * 使用 AVX2 一次比较所有剩下的元素。比较的语义与 KeyComparator 相同，FLOATS 也按照 EPSILON 判断相等。
+ * @param method 不能是 GENERIC
+ * @param items 第一个元素的位置，每个元素开头是键值
+ * @param item_size 元素的长度
+ * @param item_num 元素的个数
+ * @param key 要查找的键值，数值 + RID
+ * @param[out] found 是否找到了相等的键值
+ * @return 找到的元素的下标，所有元素都比 key 小时返回 item_num
+ */
+int numeric_key_lower_bound(
+    KeySearchMethod method, const char *items, int item_size, int item_num, const char *key, bool *found);
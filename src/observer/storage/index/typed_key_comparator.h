@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string.h>
+
+#include "common/defs.h"
+#include "common/value.h"
+#include "common/type/attr_type.h"
+#include "common/type/data_type.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 按照字段类型在编译期生成的字段比较函数
+ * @ingroup BPlusTree
+ * @details 直接比较键值中的数据，与 DataType::compare 的结果一致，但是不需要构造 Value，
+ * 也不需要在运行时判断类型，可以内联到查找和排序的循环中。
+ * CHARS 类型的 LENGTH 是字段长度，是 0 时使用运行时传入的长度。
+ * 没有特化的类型仍然构造 Value 比较。
+ */
+template <AttrType TYPE, int LENGTH = 0>
+struct AttrCompare
+{
+  static int compare(const char *v1, const char *v2, int length)
+  {
+    Value left;
+    left.set_type(TYPE);
+    left.set_data(v1, length);
+    Value right;
+    right.set_type(TYPE);
+    right.set_data(v2, length);
+    return DataType::type_instance(TYPE)->compare(left, right);
+  }
+};
+
+template <>
+struct AttrCompare<AttrType::INTS>
+{
+  static int compare(const char *v1, const char *v2, int /*length*/)
+  {
+    int left, right;
+    memcpy(&left, v1, sizeof(left));
+    memcpy(&right, v2, sizeof(right));
+    return (left > right) - (left < right);
+  }
+};
+
+/// @brief 与 common::compare_float 一样，差值在 EPSILON 之内就认为相等
+template <>
+struct AttrCompare<AttrType::FLOATS>
+{
+  static int compare(const char *v1, const char *v2, int /*length*/)
+  {
+    float left, right;
+    memcpy(&left, v1, sizeof(left));
+    memcpy(&right, v2, sizeof(right));
+    const float diff = left - right;
+    return (diff > EPSILON) - (diff < -EPSILON);
+  }
+};
+
+/**
+ * @brief 字符串最长是字段长度，遇到 '\0' 结束，与 common::compare_string 的结果一致
+ */
+template <int LENGTH>
+struct AttrCompare<AttrType::CHARS, LENGTH>
+{
+  static int compare(const char *v1, const char *v2, int length)
+  {
+    const int max_length = LENGTH > 0 ? LENGTH : length;
+    for (int i = 0; i < max_length; i++) {
+      const unsigned char c1 = static_cast<unsigned char>(v1[i]);
+      const unsigned char c2 = static_cast<unsigned char>(v2[i]);
+      if (c1 != c2) {
+        return c1 < c2 ? -1 : 1;
+      }
+      if (c1 == 0) {
+        return 0;
+      }
+    }
+    return 0;
+  }
+};
+
+/**
+ * @brief 只有一个字段的键值(字段 + RID)的比较器，字段类型在编译期确定
+ * @ingroup BPlusTree
+ * @details KeyComparator 在初始化时根据字段类型选好对应的实例，B+树在节点内查找、排序等需要大量比较的地方
+ * 通过 KeyComparator::visit 分派一次，之后每次比较都是内联的代码。
+ */
+template <AttrType TYPE, int LENGTH = 0>
+class TypedKeyComparator
+{
+public:
+  explicit TypedKeyComparator(int attr_length) : attr_length_(attr_length) {}
+
+  int operator()(const char *v1, const char *v2) const { return compare(v1, v2, attr_length_); }
+
+  static int compare(const char *v1, const char *v2, int attr_length)
+  {
+    const int result = AttrCompare<TYPE, LENGTH>::compare(v1, v2, attr_length);
+    if (result != 0) {
+      return result;
+    }
+
+    const RID *rid1 = reinterpret_cast<const RID *>(v1 + attr_length);
+    const RID *rid2 = reinterpret_cast<const RID *>(v2 + attr_length);
+    return RID::compare(rid1, rid2);
+  }
+
+private:
+  int attr_length_;
+};
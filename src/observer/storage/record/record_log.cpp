@@ -37,6 +37,8 @@ string RecordOperation::to_string() const
     case Type::INSERT: return ret + "INSERT";
     case Type::DELETE: return ret + "DELETE";
     case Type::UPDATE: return ret + "UPDATE";
+    case Type::UPDATE_COLUMN: return ret + "UPDATE_COLUMN";
+    case Type::MOVE: return ret + "MOVE";
     default: return ret + "UNKNOWN";
   }
 }
@@ -58,7 +60,9 @@ string RecordLogHeader::to_string() const
     } break;
     case RecordOperation::Type::INSERT:
     case RecordOperation::Type::DELETE:
-    case RecordOperation::Type::UPDATE: {
+    case RecordOperation::Type::UPDATE:
+    case RecordOperation::Type::UPDATE_COLUMN:
+    case RecordOperation::Type::MOVE: {
       ss << ", slot_num:" << slot_num;
     } break;
     default: {
@@ -149,6 +153,65 @@ RC RecordLogHandler::update_record(Frame *frame, const RID &rid, const char *rec
   return rc;
 }
 
+RC RecordLogHandler::update_column(
+    Frame *frame, PageNum page_num, int32_t col_id, int32_t field_len, span<const pair<SlotNum, const char *>> updates)
+{
+  const int32_t    count            = static_cast<int32_t>(updates.size());
+  const int        log_payload_size = RecordLogHeader::SIZE + 3 * sizeof(int32_t) + count * (sizeof(SlotNum) + field_len);
+  vector<char>     log_payload(log_payload_size);
+  RecordLogHeader *header = reinterpret_cast<RecordLogHeader *>(log_payload.data());
+  header->buffer_pool_id  = buffer_pool_id_;
+  header->operation_type  = RecordOperation(RecordOperation::Type::UPDATE_COLUMN).type_id();
+  header->page_num        = page_num;
+  header->slot_num        = -1;
+  header->storage_format  = static_cast<int>(storage_format_);
+
+  int32_t *meta = reinterpret_cast<int32_t *>(log_payload.data() + RecordLogHeader::SIZE);
+  meta[0]       = col_id;
+  meta[1]       = field_len;
+  meta[2]       = count;
+
+  SlotNum *slots  = reinterpret_cast<SlotNum *>(meta + 3);
+  char    *values = reinterpret_cast<char *>(slots + count);
+  for (int32_t i = 0; i < count; i++) {
+    slots[i] = updates[i].first;
+    memcpy(values + i * field_len, updates[i].second, field_len);
+  }
+
+  LSN lsn = 0;
+  RC  rc  = log_handler_->append(lsn, LogModule::Id::RECORD_MANAGER, std::move(log_payload));
+  if (OB_SUCC(rc) && lsn > 0) {
+    frame->set_lsn(lsn);
+  }
+  return rc;
+}
+
+RC RecordLogHandler::move_record(
+    Frame *src_frame, Frame *dest_frame, const RID &src_rid, const RID &dest_rid, const char *record)
+{
+  const int        log_payload_size = RecordLogHeader::SIZE + sizeof(PageNum) + sizeof(SlotNum) + record_size_;
+  vector<char>     log_payload(log_payload_size);
+  RecordLogHeader *header = reinterpret_cast<RecordLogHeader *>(log_payload.data());
+  header->buffer_pool_id  = buffer_pool_id_;
+  header->operation_type  = RecordOperation(RecordOperation::Type::MOVE).type_id();
+  header->page_num        = src_rid.page_num;
+  header->slot_num        = src_rid.slot_num;
+  header->storage_format  = static_cast<int>(storage_format_);
+
+  char *data = log_payload.data() + RecordLogHeader::SIZE;
+  memcpy(data, &dest_rid.page_num, sizeof(PageNum));
+  memcpy(data + sizeof(PageNum), &dest_rid.slot_num, sizeof(SlotNum));
+  memcpy(data + sizeof(PageNum) + sizeof(SlotNum), record, record_size_);
+
+  LSN lsn = 0;
+  RC  rc  = log_handler_->append(lsn, LogModule::Id::RECORD_MANAGER, std::move(log_payload));
+  if (OB_SUCC(rc) && lsn > 0) {
+    src_frame->set_lsn(lsn);
+    dest_frame->set_lsn(lsn);
+  }
+  return rc;
+}
+
 RC RecordLogHandler::delete_record(Frame *frame, const RID &rid)
 {
   RecordLogHeader header;
@@ -197,6 +260,11 @@ RC RecordLogReplayer::replay(const LogEntry &entry)
     return rc;
   }
 
+  // 移动记录的日志涉及两个页面，需要分别判断是否需要重放
+  if (RecordOperation(log_header->operation_type).type() == RecordOperation::Type::MOVE) {
+    return replay_move(*buffer_pool, entry);
+  }
+
   rc = buffer_pool->get_this_page(log_header->page_num, &frame);
   if (OB_FAIL(rc)) {
     LOG_WARN("fail to get this page. page num=%d, rc=%s", log_header->page_num, strrc(rc));
@@ -226,6 +294,9 @@ RC RecordLogReplayer::replay(const LogEntry &entry)
     case RecordOperation::Type::UPDATE: {
       rc = replay_update(*buffer_pool, *log_header);
     } break;
+    case RecordOperation::Type::UPDATE_COLUMN: {
+      rc = replay_update_column(*buffer_pool, *log_header);
+    } break;
     default: {
       LOG_WARN("unknown record operation type: %d", log_header->operation_type);
       return RC::INVALID_ARGUMENT;
@@ -328,4 +399,96 @@ RC RecordLogReplayer::replay_update(DiskBufferPool &buffer_pool, const RecordLog
   }
 
   return rc;
-}
\ No newline at end of file
+}
+
+RC RecordLogReplayer::replay_update_column(DiskBufferPool &buffer_pool, const RecordLogHeader &header)
+{
+  VacuousLogHandler             vacuous_log_handler;
+  unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(StorageFormat(header.storage_format)));
+
+  RC rc = record_page_handler->init(buffer_pool, vacuous_log_handler, header.page_num, ReadWriteMode::READ_WRITE);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to init record page handler. page num=%d, rc=%s", header.page_num, strrc(rc));
+    return rc;
+  }
+
+  const int32_t *meta      = reinterpret_cast<const int32_t *>(header.data);
+  const int32_t  col_id    = meta[0];
+  const int32_t  field_len = meta[1];
+  const int32_t  count     = meta[2];
+  const SlotNum *slots     = reinterpret_cast<const SlotNum *>(meta + 3);
+  const char    *values    = reinterpret_cast<const char *>(slots + count);
+
+  vector<pair<SlotNum, const char *>> updates;
+  updates.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    updates.emplace_back(slots[i], values + i * field_len);
+  }
+
+  rc = record_page_handler->update_column(col_id, updates);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to recover update column. page num=%d, col_id=%d, rc=%s", header.page_num, col_id, strrc(rc));
+    return rc;
+  }
+
+  return rc;
+}
+
+RC RecordLogReplayer::replay_move(DiskBufferPool &buffer_pool, const LogEntry &entry)
+{
+  auto        header = reinterpret_cast<const RecordLogHeader *>(entry.data());
+  const char *data   = header->data;
+
+  RID src_rid(header->page_num, header->slot_num);
+  RID dest_rid;
+  memcpy(&dest_rid.page_num, data, sizeof(PageNum));
+  memcpy(&dest_rid.slot_num, data + sizeof(PageNum), sizeof(SlotNum));
+  const char *record = data + sizeof(PageNum) + sizeof(SlotNum);
+
+  // 两个页面各自根据LSN判断是否已经包含了这次修改
+  auto replay_page = [&buffer_pool, &entry, header](PageNum page_num, function<RC(RecordPageHandler &)> redo) -> RC {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool.get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("fail to get this page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    DEFER(buffer_pool.unpin_page(frame));
+
+    if (frame->lsn() >= entry.lsn()) {
+      return RC::SUCCESS;
+    }
+
+    VacuousLogHandler             vacuous_log_handler;
+    unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(StorageFormat(header->storage_format)));
+
+    rc = record_page_handler->init(buffer_pool, vacuous_log_handler, page_num, ReadWriteMode::READ_WRITE);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("fail to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    rc = redo(*record_page_handler);
+    if (OB_SUCC(rc)) {
+      frame->set_lsn(entry.lsn());
+    }
+    return rc;
+  };
+
+  RC rc = replay_page(dest_rid.page_num, [record, &dest_rid](RecordPageHandler &handler) {
+    return handler.recover_insert_record(record, dest_rid);
+  });
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to recover move record. dest rid=%s, rc=%s", dest_rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = replay_page(src_rid.page_num, [&src_rid](RecordPageHandler &handler) { return handler.delete_record(&src_rid); });
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to recover move record. src rid=%s, rc=%s", src_rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  return RC::SUCCESS;
+}
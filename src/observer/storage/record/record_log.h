@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "common/lang/span.h"
 #include "common/lang/string.h"
+#include "common/lang/utility.h"
 #include "storage/clog/log_replayer.h"
 #include "sql/parser/parse_defs.h"
 
@@ -38,10 +39,12 @@ class RecordOperation
 public:
   enum class Type : int32_t
   {
-    INIT_PAGE,  /// 初始化空页面
-    INSERT,     /// 插入一条记录
-    DELETE,     /// 删除一条记录
-    UPDATE      /// 更新一条记录
+    INIT_PAGE,     /// 初始化空页面
+    INSERT,        /// 插入一条记录
+    DELETE,        /// 删除一条记录
+    UPDATE,        /// 更新一条记录
+    UPDATE_COLUMN, /// 批量更新页面上某一列的数据
+    MOVE           /// 将一条记录从一个页面移动到另一个页面
   };
 
 public:
@@ -125,6 +128,32 @@ public:
    */
   RC update_record(Frame *frame, const RID &rid, const char *record);
 
+  /**
+   * @brief 批量更新页面上某一列的数据
+   * @param frame 页帧
+   * @param page_num 页面编号
+   * @param col_id 更新的列
+   * @param field_len 列的长度
+   * @param updates 更新的槽位以及新的列值
+   * @details 日志数据的格式为 | col_id | field_len | count | slot_num * count | value * count |，
+   * 只记录更新的列，避免像 update_record 一样记录整条记录。
+   */
+  RC update_column(
+      Frame *frame, PageNum page_num, int32_t col_id, int32_t field_len, span<const pair<SlotNum, const char *>> updates);
+
+  /**
+   * @brief 将一条记录从一个页面移动到另一个页面
+   * @details 页面整理时使用。插入新位置和删除旧位置记录在同一条日志中，重放时分别根据两个页面的LSN
+   * 判断是否需要重做，这样不会因为中途宕机导致记录重复或丢失。
+   * 日志头中的page_num/slot_num是记录原来的位置，日志数据的格式为 | dest page_num | dest slot_num | record |。
+   * @param src_frame 记录原来所在的页帧
+   * @param dest_frame 记录移动到的页帧
+   * @param src_rid 记录原来的位置
+   * @param dest_rid 记录新的位置
+   * @param record 记录的内容
+   */
+  RC move_record(Frame *src_frame, Frame *dest_frame, const RID &src_rid, const RID &dest_rid, const char *record);
+
 private:
   LogHandler   *log_handler_    = nullptr;
   int32_t       buffer_pool_id_ = -1;
@@ -149,6 +178,8 @@ private:
   RC replay_insert(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_delete(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_update(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
+  RC replay_update_column(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
+  RC replay_move(DiskBufferPool &buffer_pool, const LogEntry &entry);
 
 private:
   BufferPoolManager &bpm_;
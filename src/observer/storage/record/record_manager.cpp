@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Meiyi & Longda on 2021/4/13.
 //
 #include "storage/record/record_manager.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "storage/common/condition_filter.h"
 #include "storage/trx/trx.h"
@@ -404,6 +405,11 @@ RC RowRecordPageHandler::get_record(const RID &rid, Record &record)
   return RC::SUCCESS;
 }
 
+void RowRecordPageHandler::write_record(SlotNum slot_num, const char *data)
+{
+  memcpy(get_record_data(slot_num), data, page_header_->record_real_size);
+}
+
 PageNum RecordPageHandler::get_page_num() const
 {
   if (nullptr == page_header_) {
@@ -414,10 +420,130 @@ PageNum RecordPageHandler::get_page_num() const
 
 bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
 
+RC RecordPageHandler::move_record(SlotNum slot_num, RecordPageHandler &dest, RID *rid)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY && dest.rw_mode_ != ReadWriteMode::READ_ONLY,
+         "cannot move record while the page is readonly");
+  ASSERT(storage_format_ == dest.storage_format_, "cannot move record between different storage format");
+
+  if (dest.is_full()) {
+    LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), dest.get_page_num());
+    return RC::RECORD_NOMEM;
+  }
+
+  RID    src_rid(get_page_num(), slot_num);
+  Record record;
+  RC     rc = get_record(src_rid, record);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get record to move. rid=%s, rc=%s", src_rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  Bitmap dest_bitmap(dest.bitmap_, dest.page_header_->record_capacity);
+  int    index = dest_bitmap.next_unsetted_bit(0);
+  dest_bitmap.set_bit(index);
+  dest.page_header_->record_num++;
+  dest.write_record(index, record.data());
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  bitmap.clear_bit(slot_num);
+  page_header_->record_num--;
+
+  RID dest_rid(dest.get_page_num(), index);
+  rc = log_handler_.move_record(frame_, dest.frame_, src_rid, dest_rid, record.data());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to move record. rid=%s, dest rid=%s, rc=%s",
+              src_rid.to_string().c_str(), dest_rid.to_string().c_str(), strrc(rc));
+    // return rc; // ignore errors
+  }
+
+  frame_->mark_dirty();
+  dest.frame_->mark_dirty();
+
+  if (rid) {
+    *rid = dest_rid;
+  }
+  return RC::SUCCESS;
+}
+
+RC RecordPageHandler::append_record(const char *data, RID *rid)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, "cannot append record into page while the page is readonly");
+
+  if (is_full()) {
+    LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
+    return RC::RECORD_NOMEM;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  int    index = bitmap.next_unsetted_bit(0);
+  bitmap.set_bit(index);
+  page_header_->record_num++;
+  write_record(index, data);
+
+  frame_->mark_dirty();
+
+  if (rid) {
+    rid->page_num = get_page_num();
+    rid->slot_num = index;
+  }
+  return RC::SUCCESS;
+}
+
 RC PaxRecordPageHandler::insert_record(const char *data, RID *rid)
 {
-  // your code here
-  exit(-1);
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, 
+         "cannot insert record into page while the page is readonly");
+
+  if (page_header_->record_num == page_header_->record_capacity) {
+    LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
+    return RC::RECORD_NOMEM;
+  }
+
+  // 找到空闲位置
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  int    index = bitmap.next_unsetted_bit(0);
+  bitmap.set_bit(index);
+  page_header_->record_num++;
+
+  RC rc = log_handler_.insert_record(frame_, RID(get_page_num(), index), data);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to insert record. page_num %d:%d. rc=%s", disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
+    // return rc; // ignore errors
+  }
+
+  write_record(index, data);
+
+  frame_->mark_dirty();
+
+  if (rid) {
+    rid->page_num = get_page_num();
+    rid->slot_num = index;
+  }
+
+  return RC::SUCCESS;
+}
+
+RC PaxRecordPageHandler::recover_insert_record(const char *data, const RID &rid)
+{
+  if (rid.slot_num >= page_header_->record_capacity) {
+    LOG_WARN("slot_num illegal, slot_num(%d) > record_capacity(%d).", rid.slot_num, page_header_->record_capacity);
+    return RC::RECORD_INVALID_RID;
+  }
+
+  // 更新位图
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!bitmap.get_bit(rid.slot_num)) {
+    bitmap.set_bit(rid.slot_num);
+    page_header_->record_num++;
+  }
+
+  // 恢复数据
+  write_record(rid.slot_num, data);
+
+  frame_->mark_dirty();
+
+  return RC::SUCCESS;
 }
 
 RC PaxRecordPageHandler::delete_record(const RID *rid)
@@ -444,17 +570,157 @@ RC PaxRecordPageHandler::delete_record(const RID *rid)
   }
 }
 
+RC PaxRecordPageHandler::update_record(const RID &rid, const char *data)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, "cannot update record in page while the page is readonly");
+
+  if (rid.slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, frame=%s, page_header=%s",
+              rid.slot_num, frame_->to_string().c_str(), page_header_->to_string().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!bitmap.get_bit(rid.slot_num)) {
+    LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  frame_->mark_dirty();
+  write_record(rid.slot_num, data);
+
+  RC rc = log_handler_.update_record(frame_, rid, data);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to update record. page_num %d:%d. rc=%s", 
+              disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
+    // return rc; // ignore errors
+  }
+
+  return RC::SUCCESS;
+}
+
+RC PaxRecordPageHandler::update_column(int col_id, span<const pair<SlotNum, const char *>> updates)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, "cannot update record in page while the page is readonly");
+
+  if (col_id < 0 || col_id >= page_header_->column_num) {
+    LOG_ERROR("Invalid column id %d, column num of page is %d", col_id, page_header_->column_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 先检查所有槽位，保证要么全部更新，要么都不更新
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  for (const auto &[slot_num, value] : updates) {
+    if (slot_num < 0 || slot_num >= page_header_->record_capacity || !bitmap.get_bit(slot_num)) {
+      LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+  }
+
+  if (updates.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const int field_len = get_field_len(col_id);
+  for (const auto &[slot_num, value] : updates) {
+    char *field_data = get_field_data(slot_num, col_id);
+    if (field_data != value) {
+      memcpy(field_data, value, field_len);
+    }
+  }
+  frame_->mark_dirty();
+
+  RC rc = log_handler_.update_column(frame_, get_page_num(), col_id, field_len, updates);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to update column. page_num %d:%d, col_id=%d. rc=%s", 
+              disk_buffer_pool_->file_desc(), frame_->page_num(), col_id, strrc(rc));
+    // return rc; // ignore errors
+  }
+
+  return RC::SUCCESS;
+}
+
 RC PaxRecordPageHandler::get_record(const RID &rid, Record &record)
 {
-  // your code here
-  exit(-1);
+  if (rid.slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, frame=%s, page_header=%s",
+              rid.slot_num, frame_->to_string().c_str(), page_header_->to_string().c_str());
+    return RC::RECORD_INVALID_RID;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!bitmap.get_bit(rid.slot_num)) {
+    LOG_ERROR("Invalid slot_num:%d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  // 列数据在页面中不是连续存放的，需要拼装到一块新的内存中
+  RC rc = record.new_record(page_header_->record_real_size);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (projection_.empty()) {
+    int offset = 0;
+    for (int col_id = 0; col_id < page_header_->column_num; col_id++) {
+      const int field_len = get_field_len(col_id);
+      memcpy(record.data() + offset, get_field_data(rid.slot_num, col_id), field_len);
+      offset += field_len;
+    }
+  } else {
+    // 只拼装需要的列。列区域按照列的顺序依次存放，所以某列在记录中的偏移可以由 column index 直接算出
+    const int *col_idx = reinterpret_cast<const int *>(frame_->data() + page_header_->col_idx_offset);
+    for (int col_id : projection_) {
+      const int offset = (col_id == 0) ? 0 : col_idx[col_id - 1] / page_header_->record_capacity;
+      memcpy(record.data() + offset, get_field_data(rid.slot_num, col_id), get_field_len(col_id));
+    }
+  }
+
+  record.set_rid(rid);
+  return RC::SUCCESS;
 }
 
 // TODO: specify the column_ids that chunk needed. currenly we get all columns
 RC PaxRecordPageHandler::get_chunk(Chunk &chunk)
 {
-  // your code here
-  exit(-1);
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  for (int i = 0; i < chunk.column_num(); i++) {
+    Column   &column    = chunk.column(i);
+    const int col_id    = chunk.column_ids(i);
+    const int field_len = get_field_len(col_id);
+    if (column.attr_len() != field_len) {
+      LOG_WARN("column length mismatch. col_id=%d, column attr len=%d, field len=%d", col_id, column.attr_len(), field_len);
+      return RC::INVALID_ARGUMENT;
+    }
+
+    // 连续的有效槽位在列区域中也是连续的，可以一次性复制
+    SlotNum start = bitmap.next_setted_bit(0);
+    while (start != -1) {
+      SlotNum end = bitmap.next_unsetted_bit(start);
+      if (end == -1) {
+        end = page_header_->record_capacity;
+      }
+
+      RC rc = column.append(get_field_data(start, col_id), end - start);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to append data to column. col_id=%d, rc=%s", col_id, strrc(rc));
+        return rc;
+      }
+
+      start = (end < page_header_->record_capacity) ? bitmap.next_setted_bit(end) : -1;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void PaxRecordPageHandler::write_record(SlotNum slot_num, const char *data)
+{
+  int offset = 0;
+  for (int col_id = 0; col_id < page_header_->column_num; col_id++) {
+    const int field_len = get_field_len(col_id);
+    memcpy(get_field_data(slot_num, col_id), data + offset, field_len);
+    offset += field_len;
+  }
 }
 
 char *PaxRecordPageHandler::get_field_data(SlotNum slot_num, int col_id)
@@ -572,39 +838,75 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 
   // 找不到就分配一个新的页面
   if (!page_found) {
-    Frame *frame = nullptr;
-    if ((ret = disk_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
-      LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
+    ret = init_new_page(*record_page_handler, record_size);
+    if (OB_FAIL(ret)) {
       return ret;
     }
+  }
 
-    current_page_num = frame->page_num();
+  // 找到空闲位置
+  return record_page_handler->insert_record(data, rid);
+}
 
-    ret = record_page_handler->init_empty_page(
-        *disk_buffer_pool_, *log_handler_, current_page_num, record_size, table_meta_);
-    if (OB_FAIL(ret)) {
-      frame->unpin();
-      LOG_ERROR("Failed to init empty page. ret:%d", ret);
-      // this is for allocate_page
-      return ret;
-    }
+RC RecordFileHandler::insert_record(const char *data, int record_size, span<const PageNum> pages, RID *rid)
+{
+  if (pages.empty()) {
+    return insert_record(data, record_size, rid);
+  }
 
-    // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
-    frame->unpin();
+  unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
+  for (PageNum page_num : pages) {
+    RC rc = record_page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_WRITE);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
 
-    // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁
-    // 上面的逻辑是先加lock锁，然后加页面写锁，这里是先加上
-    // 了页面写锁，然后加lock的锁，但是不会引起死锁。
-    // 为什么？
-    lock_.lock();
-    free_pages_.insert(current_page_num);
-    lock_.unlock();
+    if (!record_page_handler->is_full()) {
+      return record_page_handler->insert_record(data, rid);
+    }
+    record_page_handler->cleanup();
   }
 
-  // 找到空闲位置
+  RC rc = init_new_page(*record_page_handler, record_size);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
   return record_page_handler->insert_record(data, rid);
 }
 
+RC RecordFileHandler::init_new_page(RecordPageHandler &record_page_handler, int record_size)
+{
+  Frame *frame = nullptr;
+  RC     ret   = disk_buffer_pool_->allocate_page(&frame);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
+    return ret;
+  }
+
+  const PageNum page_num = frame->page_num();
+
+  ret = record_page_handler.init_empty_page(*disk_buffer_pool_, *log_handler_, page_num, record_size, table_meta_);
+  if (OB_FAIL(ret)) {
+    frame->unpin();
+    LOG_ERROR("Failed to init empty page. ret:%d", ret);
+    // this is for allocate_page
+    return ret;
+  }
+
+  // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+  frame->unpin();
+
+  // 这里的加锁顺序看起来与 insert_record 中是相反的，但是不会出现死锁
+  // insert_record 中是先加lock锁，然后加页面写锁，这里是先加上
+  // 了页面写锁，然后加lock的锁，但是不会引起死锁。
+  // 为什么？
+  lock_.lock();
+  free_pages_.insert(page_num);
+  lock_.unlock();
+  return RC::SUCCESS;
+}
+
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
 {
   RC ret = RC::SUCCESS;
@@ -700,12 +1002,244 @@ RC RecordFileHandler::visit_record(const RID &rid, function<bool(Record &)> upda
   return rc;
 }
 
+RC RecordFileHandler::update_column(PageNum page_num, int col_id, span<const pair<SlotNum, const char *>> updates)
+{
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_WRITE);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init record page handler.page number=%d", page_num);
+    return rc;
+  }
+
+  return page_handler->update_column(col_id, updates);
+}
+
+RC RecordFileHandler::sparse_pages(float fill_factor, int max_pages, vector<RecordPageStat> &pages, bool &reach_end)
+{
+  lock_.lock();
+  vector<PageNum> page_nums(free_pages_.begin(), free_pages_.end());
+  lock_.unlock();
+
+  sort(page_nums.begin(), page_nums.end());
+  auto begin = upper_bound(page_nums.begin(), page_nums.end(), compact_cursor_);
+  page_nums.erase(page_nums.begin(), begin);
+
+  reach_end = static_cast<int>(page_nums.size()) <= max_pages;
+  if (reach_end) {
+    compact_cursor_ = 0;
+  } else {
+    page_nums.resize(max_pages);
+    compact_cursor_ = page_nums.back();
+  }
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+  for (PageNum page_num : page_nums) {
+    RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    RecordPageStat stat{page_num, page_handler->record_num(), page_handler->record_capacity()};
+    page_handler->cleanup();
+    if (stat.record_num < stat.record_capacity * fill_factor) {
+      pages.push_back(stat);
+    }
+  }
+
+  sort(pages.begin(), pages.end(), [](const RecordPageStat &left, const RecordPageStat &right) {
+    return left.record_num < right.record_num;
+  });
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::page_rids(PageNum page_num, vector<RID> &rids)
+{
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler.get());
+  Record record;
+  while (iterator.has_next()) {
+    rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    rids.push_back(record.rid());
+  }
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::move_record(const RID &rid, PageNum dest_page_num, RID &new_rid)
+{
+  if (rid.page_num == dest_page_num) {
+    LOG_WARN("cannot move record to the page where it is. rid=%s", rid.to_string().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  unique_ptr<RecordPageHandler> src_handler(RecordPageHandler::create(storage_format_));
+  unique_ptr<RecordPageHandler> dest_handler(RecordPageHandler::create(storage_format_));
+
+  // 按照页面编号的顺序加锁
+  RecordPageHandler *first  = rid.page_num < dest_page_num ? src_handler.get() : dest_handler.get();
+  RecordPageHandler *second = rid.page_num < dest_page_num ? dest_handler.get() : src_handler.get();
+  PageNum first_page_num    = std::min(rid.page_num, dest_page_num);
+  PageNum second_page_num   = std::max(rid.page_num, dest_page_num);
+
+  RC rc = first->init(*disk_buffer_pool_, *log_handler_, first_page_num, ReadWriteMode::READ_WRITE);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", first_page_num, strrc(rc));
+    return rc;
+  }
+
+  rc = second->init(*disk_buffer_pool_, *log_handler_, second_page_num, ReadWriteMode::READ_WRITE);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", second_page_num, strrc(rc));
+    return rc;
+  }
+
+  return src_handler->move_record(rid.slot_num, *dest_handler, &new_rid);
+}
+
+RC RecordFileHandler::dispose_empty_page(PageNum page_num)
+{
+  // 先从free_pages_中删除，就不会再有插入操作选中这个页面
+  lock_.lock();
+  free_pages_.erase(page_num);
+  lock_.unlock();
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  const int record_num = page_handler->record_num();
+  page_handler->cleanup();
+  if (record_num != 0) {
+    LOG_WARN("cannot dispose a page with records. page num=%d, record num=%d", page_num, record_num);
+    lock_.lock();
+    free_pages_.insert(page_num);
+    lock_.unlock();
+    return RC::INVALID_ARGUMENT;
+  }
+
+  rc = disk_buffer_pool_->dispose_page(page_num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to dispose page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  LOG_TRACE("dispose empty record page %d", page_num);
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::is_empty(bool &empty)
+{
+  empty = true;
+
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(*disk_buffer_pool_, 1);
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+  while (empty && bp_iterator.has_next()) {
+    PageNum page_num = bp_iterator.next();
+
+    RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    empty = page_handler->record_num() == 0;
+    page_handler->cleanup();
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RecordFileBulkWriter::~RecordFileBulkWriter() { close_page(); }
+
+RC RecordFileBulkWriter::insert_record(const char *data, int record_size, RID *rid)
+{
+  if (page_handler_ != nullptr && page_handler_->is_full()) {
+    close_page();
+  }
+
+  if (page_handler_ == nullptr) {
+    DiskBufferPool *buffer_pool = file_handler_.disk_buffer_pool_;
+
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool->allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to allocate page while bulk loading records. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    page_handler_.reset(RecordPageHandler::create(file_handler_.storage_format_));
+    rc = page_handler_->init_empty_page(
+        *buffer_pool, *file_handler_.log_handler_, frame->page_num(), record_size, file_handler_.table_meta_);
+    // allocate_page 时有一个pin，init_empty_page 又会增加一个
+    frame->unpin();
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to init empty page while bulk loading records. rc=%s", strrc(rc));
+      page_handler_.reset();
+      return rc;
+    }
+    page_count_++;
+  }
+
+  return page_handler_->append_record(data, rid);
+}
+
+void RecordFileBulkWriter::close_page()
+{
+  if (page_handler_ == nullptr) {
+    return;
+  }
+
+  PageNum page_num = page_handler_->get_page_num();
+  bool    is_full  = page_handler_->is_full();
+  page_handler_->cleanup();
+  page_handler_.reset();
+
+  if (!is_full) {
+    file_handler_.lock_.lock();
+    file_handler_.free_pages_.insert(page_num);
+    file_handler_.lock_.unlock();
+  }
+}
+
+RC RecordFileBulkWriter::finish()
+{
+  close_page();
+
+  RC rc = file_handler_.disk_buffer_pool_->flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to flush pages after bulk loading. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("bulk load records done. page count=%d", page_count_);
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
 RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler,
-    ReadWriteMode mode, ConditionFilter *condition_filter)
+    ReadWriteMode mode, ConditionFilter *condition_filter, span<const int> projection)
 {
   close_scan();
 
@@ -727,6 +1261,18 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
     record_page_handler_ = new PaxRecordPageHandler();
   }
 
+  if (!projection.empty()) {
+    // 事务需要通过系统字段判断记录的可见性，所以这些列总是需要读取的
+    vector<int> col_ids(projection.begin(), projection.end());
+    const int   sys_field_num = (table == nullptr) ? 0 : table->table_meta().sys_field_num();
+    for (int i = 0; i < sys_field_num; i++) {
+      col_ids.push_back(i);
+    }
+    sort(col_ids.begin(), col_ids.end());
+    col_ids.erase(unique(col_ids.begin(), col_ids.end()), col_ids.end());
+    record_page_handler_->set_projection(col_ids);
+  }
+
   return rc;
 }
 
@@ -871,11 +1417,12 @@ RC ChunkFileScanner::close_scan()
 }
 
 RC ChunkFileScanner::open_scan_chunk(
-    Table *table, DiskBufferPool &buffer_pool, LogHandler &log_handler, ReadWriteMode mode)
+    Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode)
 {
   close_scan();
 
   table_            = table;
+  trx_              = trx;
   disk_buffer_pool_ = &buffer_pool;
   log_handler_      = &log_handler;
   rw_mode_          = mode;
@@ -891,9 +1438,62 @@ RC ChunkFileScanner::open_scan_chunk(
     record_page_handler_ = new PaxRecordPageHandler();
   }
 
+  // 没有系统字段时(比如 VacuousTrx)所有记录都是可见的，不需要判断
+  trx_columns_.reset();
+  const int sys_field_num = (table == nullptr) ? 0 : table->table_meta().sys_field_num();
+  if (trx_ == nullptr || sys_field_num == 0) {
+    trx_ = nullptr;
+  } else {
+    for (int i = 0; i < sys_field_num; i++) {
+      const FieldMeta *field_meta = table->table_meta().field(i);
+      trx_columns_.add_column(make_unique<Column>(*field_meta), field_meta->field_id());
+    }
+  }
+
   return rc;
 }
 
+RC ChunkFileScanner::filter_invisible(Chunk &chunk)
+{
+  trx_columns_.reset_data();
+  RC rc = record_page_handler_->get_chunk(trx_columns_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get trx columns from page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const int rows = trx_columns_.rows();
+  select_.assign(rows, 1);
+  rc = trx_->visit_chunk(table_, trx_columns_, select_, rw_mode_);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to visit chunk. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (find(select_.begin(), select_.end(), 0) == select_.end()) {
+    return RC::SUCCESS;
+  }
+
+  // 把可见的记录挪到前面
+  for (int col_idx = 0; col_idx < chunk.column_num(); col_idx++) {
+    Column   &column   = chunk.column(col_idx);
+    const int attr_len = column.attr_len();
+    char     *data     = column.data();
+    int       count    = 0;
+    for (int i = 0; i < rows; i++) {
+      if (select_[i] == 0) {
+        continue;
+      }
+      if (count != i) {
+        memcpy(data + count * attr_len, data + i * attr_len, attr_len);
+      }
+      count++;
+    }
+    column.set_count(count);
+  }
+  return RC::SUCCESS;
+}
+
 RC ChunkFileScanner::next_chunk(Chunk &chunk)
 {
   RC rc = RC::SUCCESS;
@@ -908,6 +1508,9 @@ RC ChunkFileScanner::next_chunk(Chunk &chunk)
     }
     rc = record_page_handler_->get_chunk(chunk);
     if (rc == RC::SUCCESS) {
+      if (trx_ != nullptr) {
+        rc = filter_invisible(chunk);
+      }
       return rc;
     } else if (rc == RC::RECORD_EOF) {
       break;
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/bitmap.h"
 #include "common/lang/sstream.h"
+#include "common/lang/span.h"
+#include "common/lang/utility.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/chunk.h"
 #include "storage/record/record.h"
@@ -197,11 +199,22 @@ public:
   virtual RC delete_record(const RID *rid) { return RC::UNIMPLEMENTED; }
 
   /**
-   * @brief
+   * @brief 原地更新指定的记录
    *
+   * @param rid  要更新的记录标识
+   * @param data 更新后的完整记录数据
    */
   virtual RC update_record(const RID &rid, const char *data) { return RC::UNIMPLEMENTED; }
 
+  /**
+   * @brief 批量原地更新当前页面上某一列的数据
+   * @details 每个元素是一个 (slot, 新值) 对，新值的长度与该列的长度一致。整批更新只记录一条日志。
+   * 只需由 PaxRecordPageHandler 实现。
+   * @param col_id  要更新的列
+   * @param updates 要更新的槽位及对应的新值
+   */
+  virtual RC update_column(int col_id, span<const pair<SlotNum, const char *>> updates) { return RC::UNIMPLEMENTED; }
+
   /**
    * @brief 获取指定位置的记录数据
    *
@@ -218,6 +231,33 @@ public:
    */
   virtual RC get_chunk(Chunk &chunk) { return RC::UNIMPLEMENTED; }
 
+  /**
+   * @brief 将当前页面上的一条记录移动到另一个页面
+   * @details 页面整理时使用。两个页面都需要以读写模式打开，插入和删除只记录一条 MOVE 日志，
+   * 重放时不会出现记录重复或丢失的情况。
+   * @param slot_num 要移动的记录槽位
+   * @param dest     目标页面，存储格式需要与当前页面一致
+   * @param rid      返回记录在目标页面上的位置
+   */
+  RC move_record(SlotNum slot_num, RecordPageHandler &dest, RID *rid);
+
+  /**
+   * @brief 批量导入时在下一个空闲槽位写入记录，不记录日志
+   * @details 只能用于批量导入时新分配的页面，这些页面不会被其它人访问，
+   * 导入结束后直接把页面刷到磁盘上来保证持久化，参考 RecordFileBulkWriter。
+   * @param data 记录的内容
+   * @param rid  返回记录的位置
+   */
+  RC append_record(const char *data, RID *rid);
+
+  /**
+   * @brief 设置 get_record 时需要读取的列，为空时读取所有列
+   * @details 行存格式直接引用页面中的数据，不需要关心这个设置。PAX 格式只会拼装这些列的数据，
+   * 记录中其它列的内容是未定义的。
+   * @param col_ids 需要的列，按照 field id 指定
+   */
+  void set_projection(span<const int> col_ids) { projection_.assign(col_ids.begin(), col_ids.end()); }
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -228,7 +268,18 @@ public:
    */
   bool is_full() const;
 
+  /// @brief 页面上当前的记录数
+  int record_num() const { return page_header_->record_num; }
+
+  /// @brief 页面最多能容纳的记录数
+  int record_capacity() const { return page_header_->record_capacity; }
+
 protected:
+  /**
+   * @brief 将完整的记录数据写入指定的槽位，不记录日志
+   */
+  virtual void write_record(SlotNum slot_num, const char *data) = 0;
+
   /**
    * @details
    * 前面在计算record_capacity时并没有考虑对齐，但第一个record需要8字节对齐
@@ -262,6 +313,7 @@ protected:
   PageHeader   *page_header_ = nullptr;                    ///< 当前页面上页面头
   char         *bitmap_      = nullptr;  ///< 当前页面上record分配状态信息bitmap内存起始位置
   StorageFormat storage_format_;
+  vector<int>   projection_;  ///< get_record 时需要读取的列，为空表示所有列
 
 protected:
   friend class RecordPageIterator;
@@ -297,6 +349,9 @@ public:
    * @param record 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护
    */
   virtual RC get_record(const RID &rid, Record &record) override;
+
+protected:
+  virtual void write_record(SlotNum slot_num, const char *data) override;
 };
 
 /**
@@ -324,8 +379,22 @@ public:
    */
   virtual RC insert_record(const char *data, RID *rid) override;
 
+  virtual RC recover_insert_record(const char *data, const RID &rid) override;
+
   virtual RC delete_record(const RID *rid) override;
 
+  /**
+   * @brief 更新一条记录
+   * @details 列都是定长的，所以直接将每一列的数据写回到该槽位在各列区域中的位置
+   */
+  virtual RC update_record(const RID &rid, const char *data) override;
+
+  /**
+   * @brief 批量更新某一列的数据
+   * @details 只改写该列所在的区域，并且只记录一条 UPDATE_COLUMN 日志
+   */
+  virtual RC update_column(int col_id, span<const pair<SlotNum, const char *>> updates) override;
+
   /**
    * @brief 获取指定位置的记录数据
    *
@@ -342,6 +411,10 @@ public:
    */
   virtual RC get_chunk(Chunk &chunk) override;
 
+protected:
+  // write the record `data` into the column regions of `slot_num`
+  virtual void write_record(SlotNum slot_num, const char *data) override;
+
 private:
   // get the field data by `slot_num` and `column id`
   char *get_field_data(SlotNum slot_num, int col_id);
@@ -349,6 +422,17 @@ private:
   // get the field length by `column id`, all columns are fixed length.
   int get_field_len(int col_id);
 };
+/**
+ * @brief 页面整理时使用的页面填充信息
+ * @ingroup RecordManager
+ */
+struct RecordPageStat
+{
+  PageNum page_num;         ///< 页面编号
+  int     record_num;       ///< 页面上的记录数
+  int     record_capacity;  ///< 页面最多能容纳的记录数
+};
+
 /**
  * @brief 管理整个文件中记录的增删改查
  * @ingroup RecordManager
@@ -388,6 +472,14 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 插入一个新的记录，优先放在给定的页面中
+   * @details 聚簇表用来把记录放在聚簇键相邻的记录旁边。给定的页面都满了时分配一个新的页面，
+   * 而不是放到其它没有填满的页面中，参考 Table::insert_record
+   * @param pages 依次尝试的页面，为空时与不指定页面的 insert_record 相同
+   */
+  RC insert_record(const char *data, int record_size, span<const PageNum> pages, RID *rid);
+
   /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    *
@@ -401,21 +493,114 @@ public:
 
   RC visit_record(const RID &rid, function<bool(Record &)> updater);
 
+  /**
+   * @brief 批量更新某个页面上一列的数据
+   *
+   * @param page_num 要更新的页面
+   * @param col_id   要更新的列
+   * @param updates  (槽位, 新值) 列表
+   */
+  RC update_column(PageNum page_num, int col_id, span<const pair<SlotNum, const char *>> updates);
+
+  /**
+   * @brief 找出记录填充率低于 fill_factor 的页面，用于页面整理
+   * @details 只检查没有填满的页面。按照页面编号的顺序，从上次检查结束的位置继续检查，
+   * 多次调用可以覆盖所有的页面。
+   * @param fill_factor 填充率阈值
+   * @param max_pages   最多检查多少个页面
+   * @param pages       返回的页面信息，按照记录数从少到多排序
+   * @param reach_end   返回是否已经检查到了最后一个页面，下次会从头开始检查
+   */
+  RC sparse_pages(float fill_factor, int max_pages, vector<RecordPageStat> &pages, bool &reach_end);
+
+  /**
+   * @brief 列出某个页面上所有记录的位置
+   */
+  RC page_rids(PageNum page_num, vector<RID> &rids);
+
+  /**
+   * @brief 将一条记录移动到指定的页面
+   * @details 记录的RID会发生变化，调用者需要负责维护索引等引用了RID的地方
+   * @param rid           记录当前的位置
+   * @param dest_page_num 目标页面
+   * @param new_rid       返回记录新的位置
+   */
+  RC move_record(const RID &rid, PageNum dest_page_num, RID &new_rid);
+
+  /**
+   * @brief 将一个已经没有记录的页面归还给buffer pool
+   * @details 页面不能被其它人使用，比如正在被扫描
+   */
+  RC dispose_empty_page(PageNum page_num);
+
+  /**
+   * @brief 文件中是否没有任何记录
+   */
+  RC is_empty(bool &empty);
+
 private:
   /**
    * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
    */
   RC init_free_pages();
 
+  /**
+   * @brief 分配一个新的页面并初始化，返回时 record_page_handler 持有页面的写锁
+   */
+  RC init_new_page(RecordPageHandler &record_page_handler, int record_size);
+
 private:
+  friend class RecordFileBulkWriter;
+
   DiskBufferPool        *disk_buffer_pool_ = nullptr;
   LogHandler            *log_handler_      = nullptr;  ///< 记录日志的处理器
   unordered_set<PageNum> free_pages_;                  ///< 没有填充满的页面集合
+  PageNum                compact_cursor_ = 0;         ///< 页面整理时下次从哪个页面之后开始检查
   common::Mutex          lock_;  ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
   StorageFormat          storage_format_;
   TableMeta             *table_meta_;
 };
 
+/**
+ * @brief 批量导入记录
+ * @ingroup RecordManager
+ * @details 把记录依次写入新分配的页面，一个页面写满之后再分配下一个页面，所以导入的页面都是填满的。
+ * 页面只记录分配和初始化的日志，不记录每条记录的日志，finish 时把所有页面刷到磁盘上来保证持久化。
+ * 如果在 finish 之前宕机，还没有刷盘的页面恢复之后是空的。
+ */
+class RecordFileBulkWriter
+{
+public:
+  explicit RecordFileBulkWriter(RecordFileHandler &file_handler) : file_handler_(file_handler) {}
+  ~RecordFileBulkWriter();
+
+  /**
+   * @brief 写入一条记录
+   *
+   * @param data        记录内容
+   * @param record_size 记录大小
+   * @param rid         返回该记录的标识符
+   */
+  RC insert_record(const char *data, int record_size, RID *rid);
+
+  /**
+   * @brief 结束导入，把所有页面刷到磁盘
+   * @details 最后一个没有写满的页面会交给 RecordFileHandler，后面的插入可以继续使用
+   */
+  RC finish();
+
+  /// @brief 已经分配的页面数
+  int page_count() const { return page_count_; }
+
+private:
+  void close_page();
+
+private:
+  RecordFileHandler            &file_handler_;
+  unique_ptr<RecordPageHandler> page_handler_;     ///< 当前正在写入的页面
+  int                           page_count_ = 0;
+};
+
 /**
  * @brief 遍历某个文件中所有记录
  * @ingroup RecordManager
@@ -435,9 +620,10 @@ public:
    * @param mode             当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
    * @param condition_filter 做一些初步过滤操作
+   * @param projection       需要读取的列(field id)，为空时读取所有列。事务相关的系统列总是会读取
    */
   RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode,
-      ConditionFilter *condition_filter);
+      ConditionFilter *condition_filter, span<const int> projection = {});
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -491,8 +677,13 @@ public:
   ChunkFileScanner() = default;
   ~ChunkFileScanner();
 
-  // TODO: not support filter and transaction
-  RC open_scan_chunk(Table *table, DiskBufferPool &buffer_pool, LogHandler &log_handler, ReadWriteMode mode);
+  // TODO: not support filter
+  /**
+   * @brief 打开一个文件扫描
+   * @details 每次返回的 Chunk 中只包含调用者在 Chunk 中指定的列，其它列不会从页面中读取。
+   * 如果指定了事务，返回的 Chunk 中只会包含对该事务可见的记录。
+   */
+  RC open_scan_chunk(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode);
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -504,8 +695,15 @@ public:
    */
   RC next_chunk(Chunk &chunk);
 
+private:
+  /**
+   * @brief 使用事务判断当前页面中记录的可见性，并从 chunk 中去掉不可见的记录
+   */
+  RC filter_invisible(Chunk &chunk);
+
 private:
   Table *table_ = nullptr;  ///< 当前遍历的是哪张表。
+  Trx   *trx_   = nullptr;  ///< 当前是哪个事务在遍历
 
   DiskBufferPool *disk_buffer_pool_ = nullptr;  ///< 当前访问的文件
   LogHandler     *log_handler_      = nullptr;
@@ -513,4 +711,6 @@ private:
 
   BufferPoolIterator bp_iterator_;                    ///< 遍历buffer pool的所有页面
   RecordPageHandler *record_page_handler_ = nullptr;  ///< 处理文件某页面的记录
+  Chunk              trx_columns_;                    ///< 事务使用的系统字段，用来判断可见性
+  vector<uint8_t>    select_;                         ///< 可见性选择向量
 };
@@ -26,13 +26,35 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
 #include "storage/index/bplus_tree_index.h"
+#include "storage/index/hash_index.h"
 #include "storage/index/index.h"
+#include "storage/index/index_entry_sorter.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
+#include "storage/table/table_compactor.h"
 #include "storage/trx/trx.h"
 
+/**
+ * @brief 按照索引类型创建还没有打开的索引对象
+ */
+/// 聚簇表中自动创建的聚簇索引的名字
+static const char *CLUSTER_INDEX_NAME = "__cluster";
+
+static Index *new_index(IndexType type)
+{
+  switch (type) {
+    case IndexType::HASH: return new HashIndex();
+    default: return new BplusTreeIndex();
+  }
+}
+
+Table::Table() = default;
+
 Table::~Table()
 {
+  // 先停掉后台任务，它会访问记录和索引
+  compactor_.reset();
+
   if (record_handler_ != nullptr) {
     delete record_handler_;
     record_handler_ = nullptr;
@@ -53,7 +75,7 @@ Table::~Table()
 }
 
 RC Table::create(Db *db, int32_t table_id, const char *path, const char *name, const char *base_dir,
-    span<const AttrInfoSqlNode> attributes, StorageFormat storage_format)
+    span<const AttrInfoSqlNode> attributes, StorageFormat storage_format, span<const string> cluster_fields)
 {
   if (table_id < 0) {
     LOG_WARN("invalid table id. table_id=%d, table_name=%s", table_id, name);
@@ -123,6 +145,27 @@ RC Table::create(Db *db, int32_t table_id, const char *path, const char *name, c
     return rc;
   }
 
+  if (!cluster_fields.empty()) {
+    vector<const FieldMeta *> cluster_field_metas;
+    for (const string &field_name : cluster_fields) {
+      const FieldMeta *field_meta = table_meta_.field(field_name.c_str());
+      if (field_meta == nullptr || !field_meta->visible()) {
+        LOG_WARN("no such field in cluster key. table=%s, field=%s", name, field_name.c_str());
+        return RC::SCHEMA_FIELD_NOT_EXIST;
+      }
+      cluster_field_metas.push_back(field_meta);
+    }
+
+    // 表是空的，不需要事务也可以创建索引。元数据和索引一起写到文件中
+    table_meta_.set_cluster_index(CLUSTER_INDEX_NAME);
+    rc = create_index(nullptr /*trx*/, cluster_field_metas, CLUSTER_INDEX_NAME);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to create cluster index. table=%s, rc=%s", name, strrc(rc));
+      return rc;
+    }
+    cluster_index_ = find_index(CLUSTER_INDEX_NAME);
+  }
+
   LOG_INFO("Successfully create table %s:%s", base_dir, name);
   return rc;
 }
@@ -157,20 +200,26 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
 
   const int index_num = table_meta_.index_num();
   for (int i = 0; i < index_num; i++) {
-    const IndexMeta *index_meta = table_meta_.index(i);
-    const FieldMeta *field_meta = table_meta_.field(index_meta->field());
-    if (field_meta == nullptr) {
-      LOG_ERROR("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
-                name(), index_meta->name(), index_meta->field());
-      // skip cleanup
-      //  do all cleanup action in destructive Table function
-      return RC::INTERNAL;
+    const IndexMeta  *index_meta = table_meta_.index(i);
+    vector<FieldMeta> field_metas;  // 键值字段后面跟着包含字段，参考 Index::create
+    for (const vector<string> *field_names : {&index_meta->fields(), &index_meta->include_fields()}) {
+      for (const string &field_name : *field_names) {
+        const FieldMeta *field_meta = table_meta_.field(field_name.c_str());
+        if (field_meta == nullptr) {
+          LOG_ERROR("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
+                    name(), index_meta->name(), field_name.c_str());
+          // skip cleanup
+          //  do all cleanup action in destructive Table function
+          return RC::INTERNAL;
+        }
+        field_metas.push_back(*field_meta);
+      }
     }
 
-    BplusTreeIndex *index      = new BplusTreeIndex();
-    string          index_file = table_index_file(base_dir, name(), index_meta->name());
+    Index *index      = new_index(index_meta->type());
+    string index_file = table_index_file(base_dir, name(), index_meta->name());
 
-    rc = index->open(this, index_file.c_str(), *index_meta, *field_meta);
+    rc = index->open(this, index_file.c_str(), *index_meta, field_metas);
     if (rc != RC::SUCCESS) {
       delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%s",
@@ -182,26 +231,35 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
     indexes_.push_back(index);
   }
 
+  const IndexMeta *cluster_index_meta = table_meta_.cluster_index();
+  if (cluster_index_meta != nullptr) {
+    cluster_index_ = find_index(cluster_index_meta->name());
+  }
+
   return rc;
 }
 
 RC Table::insert_record(Record &record)
 {
-  RC rc = RC::SUCCESS;
-  rc    = record_handler_->insert_record(record.data(), table_meta_.record_size(), &record.rid());
+  RC              rc = RC::SUCCESS;
+  vector<PageNum> neighbor_pages;
+  if (cluster_index_ != nullptr) {
+    rc = cluster_neighbor_pages(record.data(), neighbor_pages);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to find pages of neighbor records. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = record_handler_->insert_record(record.data(), table_meta_.record_size(), neighbor_pages, &record.rid());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
     return rc;
   }
 
   rc = insert_entry_of_indexes(record.data(), record.rid());
-  if (rc != RC::SUCCESS) {  // 可能出现了键值重复
-    RC rc2 = delete_entry_of_indexes(record.data(), record.rid(), false /*error_on_not_exists*/);
-    if (rc2 != RC::SUCCESS) {
-      LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s",
-                name(), rc2, strrc(rc2));
-    }
-    rc2 = record_handler_->delete_record(&record.rid());
+  if (rc != RC::SUCCESS) {  // 可能出现了键值重复，已经插入的索引数据都删除了
+    RC rc2 = record_handler_->delete_record(&record.rid());
     if (rc2 != RC::SUCCESS) {
       LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
                 name(), rc2, strrc(rc2));
@@ -236,13 +294,8 @@ RC Table::recover_insert_record(Record &record)
   }
 
   rc = insert_entry_of_indexes(record.data(), record.rid());
-  if (rc != RC::SUCCESS) {  // 可能出现了键值重复
-    RC rc2 = delete_entry_of_indexes(record.data(), record.rid(), false /*error_on_not_exists*/);
-    if (rc2 != RC::SUCCESS) {
-      LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s",
-                name(), rc2, strrc(rc2));
-    }
-    rc2 = record_handler_->delete_record(&record.rid());
+  if (rc != RC::SUCCESS) {  // 可能出现了键值重复，已经插入的索引数据都删除了
+    RC rc2 = record_handler_->delete_record(&record.rid());
     if (rc2 != RC::SUCCESS) {
       LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
                 name(), rc2, strrc(rc2));
@@ -332,12 +385,13 @@ RC Table::init_record_handler(const char *base_dir)
     return rc;
   }
 
+  compactor_ = make_unique<TableCompactor>(*this, &db_->background_latch());
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode)
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode, span<const int> projection)
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, db_->log_handler(), mode, nullptr);
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, db_->log_handler(), mode, nullptr, projection);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
@@ -346,7 +400,7 @@ RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode
 
 RC Table::get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode)
 {
-  RC rc = scanner.open_scan_chunk(this, *data_buffer_pool_, db_->log_handler(), mode);
+  RC rc = scanner.open_scan_chunk(this, *data_buffer_pool_, trx, db_->log_handler(), mode);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
@@ -355,58 +409,113 @@ RC Table::get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode m
 
 RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name)
 {
-  if (common::is_blank(index_name) || nullptr == field_meta) {
+  const FieldMeta *field_metas[] = {field_meta};
+  return create_index(trx, field_metas, index_name);
+}
+
+RC Table::create_index(Trx *trx, span<const FieldMeta *const> field_metas, const char *index_name)
+{
+  return create_index(trx, field_metas, index_name, IndexBuildOptions());
+}
+
+RC Table::create_index(
+    Trx *trx, span<const FieldMeta *const> field_metas, const char *index_name, const IndexBuildOptions &options)
+{
+  return create_index(trx, field_metas, span<const FieldMeta *const>(), index_name, false /*unique*/, options);
+}
+
+RC Table::create_index(Trx *trx, span<const FieldMeta *const> field_metas,
+    span<const FieldMeta *const> include_field_metas, const char *index_name, bool unique,
+    const IndexBuildOptions &options, IndexType type /* = IndexType::BPLUS_TREE */)
+{
+  if (common::is_blank(index_name) || field_metas.empty() ||
+      find(field_metas.begin(), field_metas.end(), nullptr) != field_metas.end() ||
+      find(include_field_metas.begin(), include_field_metas.end(), nullptr) != include_field_metas.end()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
     return RC::INVALID_ARGUMENT;
   }
 
+  if (field_metas.size() > static_cast<size_t>(IndexFileHeader::MAX_ATTR_NUM)) {
+    LOG_INFO("Too many fields in index. table=%s, index=%s, field num=%d",
+             name(), index_name, static_cast<int>(field_metas.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
   IndexMeta new_index_meta;
 
-  RC rc = new_index_meta.init(index_name, *field_meta);
+  RC rc = new_index_meta.init(index_name, field_metas, include_field_metas, unique, type);
   if (rc != RC::SUCCESS) {
     LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s, field_name:%s", 
-             name(), index_name, field_meta->name());
+             name(), index_name, field_metas[0]->name());
     return rc;
   }
 
+  vector<FieldMeta> index_field_metas;
+  for (const FieldMeta *field_meta : field_metas) {
+    index_field_metas.push_back(*field_meta);
+  }
+  for (const FieldMeta *field_meta : include_field_metas) {
+    index_field_metas.push_back(*field_meta);
+  }
+
   // 创建索引相关数据
-  BplusTreeIndex *index      = new BplusTreeIndex();
-  string          index_file = table_index_file(base_dir_.c_str(), name(), index_name);
+  Index *index      = new_index(type);
+  string index_file = table_index_file(base_dir_.c_str(), name(), index_name);
 
-  rc = index->create(this, index_file.c_str(), new_index_meta, *field_meta);
+  rc = index->create(this, index_file.c_str(), new_index_meta, index_field_metas);
   if (rc != RC::SUCCESS) {
     delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
+    LOG_ERROR("Failed to create %s index. file name=%s, rc=%d:%s",
+              index_type_to_string(type), index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
+  // 遍历当前的所有数据，取出键值和RID排好序，再批量插入这个索引
+  IndexEntrySorter sorter(index->field_metas(), options.sort_memory, index_file + ".sort", index->include_length());
+
   RecordFileScanner scanner;
   rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", 
              name(), index_name, strrc(rc));
+    delete index;
     return rc;
   }
 
-  Record record;
+  vector<char> key(index->key_length());
+  vector<char> include(index->include_length());
+  Record       record;
   while (OB_SUCC(rc = scanner.next(record))) {
-    rc = index->insert_entry(record.data(), &record.rid());
+    index->make_key(record.data(), key.data());
+    index->make_include(record.data(), include.data());
+    rc = sorter.add(key.data(), record.rid(), include.data());
     if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+      LOG_WARN("failed to collect index entry while creating index. table=%s, index=%s, rc=%s",
                name(), index_name, strrc(rc));
+      delete index;
       return rc;
     }
   }
-  if (RC::RECORD_EOF == rc) {
-    rc = RC::SUCCESS;
-  } else {
-    LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+  scanner.close_scan();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s",
              name(), index_name, strrc(rc));
+    delete index;
     return rc;
   }
-  scanner.close_scan();
-  LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
+
+  rc = sorter.sort();
+  if (OB_SUCC(rc)) {
+    rc = index->insert_sorted_entries(sorter, options);
+  }
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into index while creating index. table=%s, index=%s, rc=%s",
+             name(), index_name, strrc(rc));
+    delete index;
+    return rc;
+  }
+  LOG_INFO("inserted all records into new index. table=%s, index=%s, entry num=%ld, sort runs=%d",
+           name(), index_name, sorter.entry_count(), sorter.run_count());
 
   indexes_.push_back(index);
 
@@ -473,19 +582,194 @@ RC Table::delete_record(const Record &record)
            name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
   rc = record_handler_->delete_record(&record.rid());
+  if (OB_SUCC(rc) && compactor_) {
+    compactor_->record_deleted();
+  }
   return rc;
 }
 
+RC Table::compact(float fill_factor, int io_budget, CompactionStat &stat)
+{
+  // 一半的预算用来查找需要整理的页面
+  const int scan_budget = std::max(1, io_budget / 2);
+  int       budget      = io_budget - scan_budget;
+  stat.io_pages += scan_budget;
+
+  vector<RecordPageStat> pages;
+  bool                   reach_end = false;
+  RC                     rc        = record_handler_->sparse_pages(fill_factor, scan_budget, pages, reach_end);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find sparse pages. table=%s, rc=%s", name(), strrc(rc));
+    return rc;
+  }
+
+  // pages 按照记录数从少到多排序，把前面页面上的记录搬到后面的页面上
+  int  dest         = static_cast<int>(pages.size()) - 1;
+  bool dest_visited = false;
+  for (int src = 0; src < static_cast<int>(pages.size()) && budget > 0; src++) {
+    RecordPageStat &source  = pages[src];
+    bool            drained = (source.record_num == 0);
+    if (!drained && cluster_index_ != nullptr) {
+      continue;  // 聚簇表只释放空页面，搬动记录会打乱聚簇键的顺序
+    }
+    if (!drained) {
+      if (src >= dest) {
+        break;
+      }
+
+      vector<RID> rids;
+      rc = record_handler_->page_rids(source.page_num, rids);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to list records of page. table=%s, page num=%d, rc=%s", name(), source.page_num, strrc(rc));
+        return rc;
+      }
+      budget--;
+      stat.io_pages++;
+
+      drained = true;
+      for (const RID &rid : rids) {
+        while (dest > src && pages[dest].record_num >= pages[dest].record_capacity) {
+          dest--;
+          dest_visited = false;
+        }
+        if (dest <= src) {
+          drained = false;
+          break;
+        }
+
+        if (!dest_visited) {
+          if (budget <= 0) {
+            drained = false;
+            break;
+          }
+          budget--;
+          stat.io_pages++;
+          dest_visited = true;
+        }
+
+        bool moved = false;
+        rc         = relocate_record(rid, pages[dest].page_num, moved);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to relocate record. table=%s, rid=%s, rc=%s", name(), rid.to_string().c_str(), strrc(rc));
+          return rc;
+        }
+
+        if (!moved) {
+          drained = false;
+          continue;
+        }
+
+        pages[dest].record_num++;
+        source.record_num--;
+        stat.moved_records++;
+      }
+    }
+
+    if (!drained || budget <= 0) {
+      continue;
+    }
+
+    rc = record_handler_->dispose_empty_page(source.page_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to dispose empty page. table=%s, page num=%d, rc=%s", name(), source.page_num, strrc(rc));
+      return rc;
+    }
+    budget--;
+    stat.io_pages++;
+    stat.freed_pages++;
+  }
+
+  // 检查完所有页面并且预算还有剩余，就认为本次整理完成了
+  stat.finished = reach_end && budget > 0;
+  return RC::SUCCESS;
+}
+
+RC Table::relocate_record(const RID &rid, PageNum dest_page_num, bool &moved)
+{
+  moved = false;
+
+  Record record;
+  RC     rc = record_handler_->get_record(rid, record);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (db_ != nullptr && !db_->trx_kit().is_relocatable(this, record)) {
+    return RC::SUCCESS;
+  }
+
+  RID new_rid;
+  rc = record_handler_->move_record(rid, dest_page_num, new_rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = delete_entry_of_indexes(record.data(), rid, false /*error_on_not_exists*/);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to delete index entries of moved record. table=%s, rid=%s, rc=%s",
+              name(), rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = insert_entry_of_indexes(record.data(), new_rid);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to insert index entries of moved record. table=%s, rid=%s, rc=%s",
+              name(), new_rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  moved = true;
+  return RC::SUCCESS;
+}
+
+RC Table::cluster_neighbor_pages(const char *record, vector<PageNum> &pages)
+{
+  vector<char> key(cluster_index_->key_length());
+  cluster_index_->make_key(record, key.data());
+  const int key_len = static_cast<int>(key.size());
+
+  // 反向扫描 (-inf, key] 得到前一条记录，正向扫描 [key, +inf) 得到后一条记录
+  for (bool reverse : {true, false}) {
+    IndexScanner *scanner =
+        reverse ? cluster_index_->create_scanner(nullptr, 0, false, key.data(), key_len, true, true /*reverse*/)
+                : cluster_index_->create_scanner(key.data(), key_len, true, nullptr, 0, false);
+    if (scanner == nullptr) {
+      LOG_WARN("failed to create cluster index scanner. table=%s", name());
+      return RC::INTERNAL;
+    }
+
+    RID rid;
+    RC  rc = scanner->next_entry(&rid);
+    scanner->destroy();
+    if (OB_SUCC(rc)) {
+      if (find(pages.begin(), pages.end(), rid.page_num) == pages.end()) {
+        pages.push_back(rid.page_num);
+      }
+    } else if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to scan cluster index. table=%s, rc=%s", name(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
 {
-  RC rc = RC::SUCCESS;
-  for (Index *index : indexes_) {
-    rc = index->insert_entry(record, &rid);
-    if (rc != RC::SUCCESS) {
-      break;
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    RC rc = indexes_[i]->insert_entry(record, &rid);
+    if (OB_FAIL(rc)) {
+      // 只回滚已经插入成功的索引，失败的那个索引中可能是其它记录的数据(比如唯一索引中重复的键值)
+      while (i-- > 0) {
+        RC rc2 = indexes_[i]->delete_entry(record, &rid);
+        if (OB_FAIL(rc2)) {
+          LOG_ERROR("Failed to rollback index data when insert index entries failed. table=%s, index=%s, rc=%s",
+                    name(), indexes_[i]->index_meta().name(), strrc(rc2));
+        }
+      }
+      return rc;
     }
   }
-  return rc;
+  return RC::SUCCESS;
 }
 
 RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists)
@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/types.h"
 #include "common/lang/span.h"
 #include "common/lang/functional.h"
+#include "common/lang/memory.h"
 
 struct RID;
 class Record;
@@ -29,9 +30,22 @@ class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
 class IndexScanner;
+struct IndexBuildOptions;
 class RecordDeleter;
 class Trx;
 class Db;
+class TableCompactor;
+
+/**
+ * @brief 一轮页面整理的结果
+ */
+struct CompactionStat
+{
+  int  io_pages      = 0;     ///< 访问过的页面数
+  int  moved_records = 0;     ///< 移动的记录数
+  int  freed_pages   = 0;     ///< 释放的页面数
+  bool finished      = true;  ///< 在预算内完成了整理，预算用完时为false
+};
 
 /**
  * @brief 表
@@ -40,7 +54,7 @@ class Db;
 class Table
 {
 public:
-  Table() = default;
+  Table();
   ~Table();
 
   /**
@@ -50,9 +64,10 @@ public:
    * @param base_dir 表数据存放的路径
    * @param attribute_count 字段个数
    * @param attributes 字段
+   * @param cluster_fields 聚簇键的字段，不为空时会创建一个聚簇索引，参考 TableMeta::cluster_index
    */
   RC create(Db *db, int32_t table_id, const char *path, const char *name, const char *base_dir,
-      span<const AttrInfoSqlNode> attributes, StorageFormat storage_format);
+      span<const AttrInfoSqlNode> attributes, StorageFormat storage_format, span<const string> cluster_fields = {});
 
   /**
    * 打开一个表
@@ -73,6 +88,7 @@ public:
   /**
    * @brief 在当前的表中插入一条记录
    * @details 在表文件和索引中插入关联数据。这里只管在表中插入数据，不关心事务相关操作。
+   * 聚簇表的记录优先放在聚簇键前后相邻的记录所在的页面，这些页面都满了就放在一个新的页面中。
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
@@ -85,7 +101,36 @@ public:
   // TODO refactor
   RC create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode);
+  /**
+   * @brief 创建一个多字段的索引
+   * @param field_metas 索引包含的字段，按照键值中的顺序排列
+   */
+  RC create_index(Trx *trx, span<const FieldMeta *const> field_metas, const char *index_name);
+
+  /**
+   * @brief 创建索引，表中已有的数据先排序，再批量构建索引
+   * @details 扫描表时只取出每条记录的键值和RID，排好序之后交给 Index::insert_sorted_entries，
+   * B+树会自底向上地构建，不用每条数据都从根节点查找和分裂。
+   * @param options 节点的填充比例和排序可以使用的内存
+   */
+  RC create_index(Trx *trx, span<const FieldMeta *const> field_metas, const char *index_name,
+      const IndexBuildOptions &options);
+
+  /**
+   * @brief 创建一个带有包含字段(INCLUDE)的索引
+   * @param include_field_metas 包含字段，数据和RID一起存放在叶子节点中，参考 IndexMeta::include_fields
+   * @param unique 是否是唯一索引，已有的数据中有重复时返回 RECORD_DUPLICATE_KEY
+   * @param type 索引的类型，哈希索引不支持包含字段
+   */
+  RC create_index(Trx *trx, span<const FieldMeta *const> field_metas,
+      span<const FieldMeta *const> include_field_metas, const char *index_name, bool unique,
+      const IndexBuildOptions &options, IndexType type = IndexType::BPLUS_TREE);
+
+  /**
+   * @brief 获取一个遍历表记录的扫描器
+   * @param projection 需要读取的列(field id)，为空时读取所有列
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode, span<const int> projection = {});
 
   RC get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode);
 
@@ -100,21 +145,55 @@ public:
    */
   RC visit_record(const RID &rid, function<bool(Record &)> visitor);
 
+  /**
+   * @brief 整理填充率低的页面
+   * @details 把记录最少的页面上的记录移动到其它没有填满的页面，同时修改索引中的RID，
+   * 然后把空页面归还给buffer pool。未提交事务引用的记录不会移动。
+   * 调用者需要保证整理期间没有其它人通过RID访问这张表，参考 TableCompactor。
+   * 聚簇表移动记录会打乱记录的顺序，所以只释放空页面。
+   * @param fill_factor 填充率低于这个值的页面才会被整理
+   * @param io_budget   最多访问多少个页面，一半用来查找需要整理的页面
+   * @param stat        整理的结果。没有完成时，再次调用会从上次检查结束的页面继续
+   */
+  RC compact(float fill_factor, int io_budget, CompactionStat &stat);
+
+  /**
+   * @brief 后台页面整理任务
+   * @details 在数据库恢复完成之后，调用 compactor()->start() 开启后台整理
+   */
+  TableCompactor *compactor() const { return compactor_.get(); }
+
 public:
   int32_t     table_id() const { return table_meta_.table_id(); }
   const char *name() const;
 
   Db *db() const { return db_; }
 
+  /// @brief 表数据文件和索引文件所在的目录
+  const string &base_dir() const { return base_dir_; }
+
   const TableMeta &table_meta() const;
 
   RC sync();
 
 private:
+  /// @brief 插入所有索引，有一个失败时会删除已经插入的数据
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
   RC set_value_to_record(char *record_data, const Value &value, const FieldMeta *field);
 
+  /**
+   * @brief 将一条记录移动到指定的页面，并修改索引
+   * @param moved 返回记录是否真的移动了。未提交事务引用的记录不能移动
+   */
+  RC relocate_record(const RID &rid, PageNum dest_page_num, bool &moved);
+
+  /**
+   * @brief 找到聚簇键前后相邻的记录所在的页面
+   * @param pages 先是前一条记录的页面，然后是后一条记录的页面，表中没有记录时为空
+   */
+  RC cluster_neighbor_pages(const char *record, vector<PageNum> &pages);
+
 private:
   RC init_record_handler(const char *base_dir);
 
@@ -122,6 +201,11 @@ public:
   Index *find_index(const char *index_name) const;
   Index *find_index_by_field(const char *field_name) const;
 
+  const vector<Index *> &indexes() const { return indexes_; }
+
+  /// @brief 聚簇索引，不是聚簇表时返回 nullptr
+  Index *cluster_index() const { return cluster_index_; }
+
 private:
   Db                *db_ = nullptr;
   string             base_dir_;
@@ -129,4 +213,7 @@ private:
   DiskBufferPool    *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_   = nullptr;  /// 记录操作
   vector<Index *>    indexes_;
+  Index             *cluster_index_ = nullptr;  /// 聚簇索引，也在 indexes_ 中
+
+  unique_ptr<TableCompactor> compactor_;  /// 后台页面整理任务
 };
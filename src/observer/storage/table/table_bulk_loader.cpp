@@ -0,0 +1,116 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/table/table_bulk_loader.h"
+#include "common/log/log.h"
+#include "storage/common/meta_util.h"
+#include "storage/index/index.h"
+#include "storage/index/index_entry_sorter.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+
+TableBulkLoader::TableBulkLoader(Table &table) : table_(table) {}
+
+TableBulkLoader::~TableBulkLoader() = default;
+
+RC TableBulkLoader::open()
+{
+  // 批量导入按照输入的顺序写页面，不能按照聚簇键放置记录
+  if (table_.cluster_index() != nullptr) {
+    LOG_INFO("cannot bulk load into a clustered table. table=%s", table_.name());
+    return RC::UNSUPPORTED;
+  }
+
+  bool empty = false;
+  RC   rc    = table_.record_handler()->is_empty(empty);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to check whether the table is empty. table=%s, rc=%s", table_.name(), strrc(rc));
+    return rc;
+  }
+  if (!empty) {
+    LOG_INFO("cannot bulk load into a table with records. table=%s", table_.name());
+    return RC::UNSUPPORTED;
+  }
+
+  writer_ = make_unique<RecordFileBulkWriter>(*table_.record_handler());
+  const IndexBuildOptions options;
+  for (Index *index : table_.indexes()) {
+    string tmp_file_prefix = table_index_file(table_.base_dir().c_str(), table_.name(), index->index_meta().name());
+    index_entries_.emplace_back();
+    index_entries_.back().index  = index;
+    index_entries_.back().sorter = make_unique<IndexEntrySorter>(
+        index->field_metas(), options.sort_memory, tmp_file_prefix + ".sort", index->include_length());
+  }
+  return RC::SUCCESS;
+}
+
+RC TableBulkLoader::insert_record(Record &record)
+{
+  RID rid;
+  RC  rc = writer_->insert_record(record.data(), table_.table_meta().record_size(), &rid);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to bulk insert record. table=%s, rc=%s", table_.name(), strrc(rc));
+    return rc;
+  }
+  record.set_rid(rid);
+
+  for (IndexEntries &entries : index_entries_) {
+    key_buffer_.resize(entries.index->key_length());
+    include_buffer_.resize(entries.index->include_length());
+    entries.index->make_key(record.data(), key_buffer_.data());
+    entries.index->make_include(record.data(), include_buffer_.data());
+    rc = entries.sorter->add(key_buffer_.data(), rid, include_buffer_.data());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to collect index entry. table=%s, index=%s, rc=%s",
+               table_.name(), entries.index->index_meta().name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  record_count_++;
+  return RC::SUCCESS;
+}
+
+RC TableBulkLoader::finish()
+{
+  // 先保证数据页面持久化，再构建索引。索引的修改仍然记录日志
+  RC rc = writer_->finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to finish bulk writing records. table=%s, rc=%s", table_.name(), strrc(rc));
+    return rc;
+  }
+
+  for (IndexEntries &entries : index_entries_) {
+    rc = build_index(entries);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build index after bulk load. table=%s, index=%s, rc=%s",
+               table_.name(), entries.index->index_meta().name(), strrc(rc));
+      return rc;
+    }
+  }
+  index_entries_.clear();
+
+  LOG_INFO("bulk load done. table=%s, record count=%d, page count=%d",
+           table_.name(), record_count_, writer_->page_count());
+  return RC::SUCCESS;
+}
+
+RC TableBulkLoader::build_index(IndexEntries &entries)
+{
+  RC rc = entries.sorter->sort();
+  if (OB_SUCC(rc)) {
+    rc = entries.index->insert_sorted_entries(*entries.sorter, IndexBuildOptions());
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build index. index=%s, rc=%s", entries.index->index_meta().name(), strrc(rc));
+  }
+  entries.sorter.reset();
+  return rc;
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/memory.h"
+#include "common/lang/vector.h"
+#include "storage/record/record.h"
+
+class Table;
+class Index;
+class IndexEntrySorter;
+class RecordFileBulkWriter;
+
+/**
+ * @brief 向空表中批量导入数据
+ * @details 逐行插入时每条记录都要找空闲页面、记录一条日志，并且逐个插入索引。批量导入时：
+ * 1. 记录直接写入新分配的页面，页面写满再分配下一个，不记录每条记录的日志，参考 RecordFileBulkWriter；
+ * 2. 导入过程中只收集每个索引的键值和RID，结束时先把数据页面刷盘，再按照键值排序(参考 IndexEntrySorter)，
+ *    从叶子节点开始自底向上地构建B+树，参考 BplusTreeBulkBuilder。
+ * 导入不是原子的，中途宕机时已经刷盘的记录可能没有对应的索引数据，需要重新导入。
+ * 只能用于空表，而且导入期间不能有其它语句修改这张表。
+ */
+class TableBulkLoader
+{
+public:
+  explicit TableBulkLoader(Table &table);
+  ~TableBulkLoader();
+
+  /**
+   * @brief 开始导入
+   * @details 表中已经有数据或者是聚簇表时返回 RC::UNSUPPORTED，调用者应该使用逐行插入
+   */
+  RC open();
+
+  /**
+   * @brief 写入一条记录
+   * @param record[in/out] 记录的数据，成功时返回RID
+   */
+  RC insert_record(Record &record);
+
+  /**
+   * @brief 结束导入，把数据刷盘并构建索引
+   */
+  RC finish();
+
+  int record_count() const { return record_count_; }
+
+private:
+  /**
+   * @brief 导入期间收集的某个索引的数据
+   */
+  struct IndexEntries
+  {
+    Index                       *index = nullptr;
+    unique_ptr<IndexEntrySorter> sorter;  ///< 所有记录的键值和RID，数据太多时使用外部排序
+  };
+
+  RC build_index(IndexEntries &entries);
+
+private:
+  Table                           &table_;
+  unique_ptr<RecordFileBulkWriter> writer_;
+  vector<IndexEntries>             index_entries_;
+  vector<char>                     key_buffer_;      ///< 生成键值的缓存
+  vector<char>                     include_buffer_;  ///< 生成包含字段数据的缓存
+  int                              record_count_ = 0;
+};
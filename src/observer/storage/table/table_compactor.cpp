@@ -0,0 +1,111 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/table/table_compactor.h"
+#include "common/lang/chrono.h"
+#include "common/log/log.h"
+#include "common/thread/thread_util.h"
+#include "storage/table/table.h"
+
+using namespace common;
+
+TableCompactor::TableCompactor(Table &table, shared_mutex *background_latch)
+    : table_(table), background_latch_(background_latch)
+{}
+
+TableCompactor::~TableCompactor() { stop(); }
+
+void TableCompactor::start()
+{
+  lock_guard<mutex> guard(lock_);
+  enabled_ = true;
+}
+
+void TableCompactor::stop()
+{
+  unique_ptr<thread> compact_thread;
+  {
+    lock_guard<mutex> guard(lock_);
+    enabled_ = false;
+    compact_thread.swap(thread_);
+  }
+
+  cond_.notify_all();
+  if (compact_thread) {
+    compact_thread->join();
+  }
+}
+
+void TableCompactor::record_deleted()
+{
+  if (deleted_records_.fetch_add(1) + 1 < options_.delete_threshold) {
+    return;
+  }
+
+  deleted_records_.store(0);
+
+  lock_guard<mutex> guard(lock_);
+  if (!enabled_) {
+    return;
+  }
+
+  pending_ = true;
+  if (!thread_) {
+    thread_ = make_unique<thread>(&TableCompactor::thread_func, this);
+  }
+  cond_.notify_all();
+}
+
+void TableCompactor::thread_func()
+{
+  thread_set_name("TableCompactor");
+  LOG_INFO("table compactor started. table=%s", table_.name());
+
+  int freed_pages = 0;  // 本轮遍历释放的页面数
+
+  unique_lock<mutex> lock(lock_);
+  while (enabled_) {
+    cond_.wait(lock, [this]() { return !enabled_ || pending_; });
+    if (!enabled_) {
+      break;
+    }
+
+    lock.unlock();
+
+    CompactionStat stat;
+    RC             rc = RC::SUCCESS;
+    if (background_latch_ != nullptr) {
+      unique_lock<shared_mutex> background_guard(*background_latch_);
+      rc = table_.compact(options_.fill_factor, options_.io_budget, stat);
+    } else {
+      rc = table_.compact(options_.fill_factor, options_.io_budget, stat);
+    }
+
+    LOG_INFO("table compaction round done. table=%s, io pages=%d, moved records=%d, freed pages=%d, finished=%d, rc=%s",
+             table_.name(), stat.io_pages, stat.moved_records, stat.freed_pages, stat.finished, strrc(rc));
+
+    freed_pages += stat.freed_pages;
+    // 每一轮只能整理扫描到的几个页面，遍历完所有页面后如果还释放了页面，就再遍历一遍
+    const bool done = OB_FAIL(rc) || (stat.finished && freed_pages == 0);
+    if (stat.finished) {
+      freed_pages = 0;
+    }
+
+    lock.lock();
+    if (done) {
+      pending_ = false;
+    } else {
+      // 预算用完了，休息一会儿再继续
+      cond_.wait_for(lock, chrono::milliseconds(options_.interval_ms), [this]() { return !enabled_; });
+    }
+  }
+
+  LOG_INFO("table compactor stopped. table=%s", table_.name());
+}
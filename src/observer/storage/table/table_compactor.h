@@ -0,0 +1,84 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/atomic.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+
+class Table;
+
+/**
+ * @brief 表的后台页面整理任务
+ * @details 行存表删除记录时只会清理页面上的bitmap，大量删除之后文件中会留下很多记录很少的页面，
+ * 扫描时仍然需要读取它们。整理任务把填充率低的页面上的记录移动到其它页面，再把空页面归还给
+ * buffer pool，具体过程参考 Table::compact。
+ * 删除的记录累计到一定数量后唤醒后台线程。每一轮最多访问 io_budget 个页面，两轮之间间隔
+ * interval_ms 毫秒，避免后台任务占用太多IO。每一轮只整理扫描到的页面，遍历完整个文件后如果释放了页面，
+ * 说明还可能有可以合并的页面，会重新遍历一遍，直到某一遍没有释放任何页面。
+ * 整理过程中记录的RID会发生变化，所以每一轮都要持有 background_latch 的排他锁，与前台语句互斥。
+ */
+class TableCompactor
+{
+public:
+  struct Options
+  {
+    float fill_factor      = 0.5;  ///< 填充率低于这个值的页面才会被整理
+    int   io_budget        = 64;   ///< 每一轮整理最多访问多少个页面
+    int   delete_threshold = 1024; ///< 删除多少条记录之后触发整理
+    int   interval_ms      = 100;  ///< 两轮整理之间的间隔
+  };
+
+public:
+  /**
+   * @param table 要整理的表
+   * @param background_latch 与前台语句互斥的锁，可以为空
+   */
+  TableCompactor(Table &table, shared_mutex *background_latch);
+  ~TableCompactor();
+
+  void           set_options(const Options &options) { options_ = options; }
+  const Options &options() const { return options_; }
+
+  /**
+   * @brief 允许后台整理
+   * @details 后台线程在第一次需要整理时才会创建。数据库恢复完成之后再调用
+   */
+  void start();
+
+  /**
+   * @brief 停止后台整理并等待线程结束
+   */
+  void stop();
+
+  /**
+   * @brief 删除了一条记录，由 Table 调用
+   */
+  void record_deleted();
+
+private:
+  void thread_func();
+
+private:
+  Table        &table_;
+  shared_mutex *background_latch_ = nullptr;
+  Options       options_;
+
+  atomic<int> deleted_records_{0};  ///< 上次触发整理之后删除的记录数
+
+  mutex              lock_;
+  condition_variable cond_;
+  bool               enabled_ = false;  ///< 是否允许后台整理
+  bool               pending_ = false;  ///< 是否有需要整理的页面
+  unique_ptr<thread> thread_;
+};
@@ -25,12 +25,14 @@ static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_CLUSTER_INDEX("cluster_index");
 
 TableMeta::TableMeta(const TableMeta &other)
     : table_id_(other.table_id_),
       name_(other.name_),
       fields_(other.fields_),
       indexes_(other.indexes_),
+      cluster_index_(other.cluster_index_),
       storage_format_(other.storage_format_),
       record_size_(other.record_size_)
 {}
@@ -40,6 +42,7 @@ void TableMeta::swap(TableMeta &other) noexcept
   name_.swap(other.name_);
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
+  cluster_index_.swap(other.cluster_index_);
   std::swap(record_size_, other.record_size_);
 }
 
@@ -67,7 +70,7 @@ RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMe
     fields_.resize(attributes.size() + trx_fields->size());
     for (size_t i = 0; i < trx_fields->size(); i++) {
       const FieldMeta &field_meta = (*trx_fields)[i];
-      fields_[i] = FieldMeta(field_meta.name(), field_meta.type(), field_offset, field_meta.len(), false /*visible*/, field_meta.field_id());
+      fields_[i] = FieldMeta(field_meta.name(), field_meta.type(), field_offset, field_meta.len(), false /*visible*/, i);
       field_offset += field_meta.len();
     }
 
@@ -78,9 +81,9 @@ RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMe
 
   for (size_t i = 0; i < attributes.size(); i++) {
     const AttrInfoSqlNode &attr_info = attributes[i];
-    // `i` is the col_id of fields[i]
+    // `i + trx_field_num` is the col_id of fields[i + trx_field_num]
     rc = fields_[i + trx_field_num].init(
-      attr_info.name.c_str(), attr_info.type, field_offset, attr_info.length, true /*visible*/, i);
+      attr_info.name.c_str(), attr_info.type, field_offset, attr_info.length, true /*visible*/, i + trx_field_num);
     if (OB_FAIL(rc)) {
       LOG_ERROR("Failed to init field meta. table name=%s, field name: %s", name, attr_info.name.c_str());
       return rc;
@@ -164,6 +167,11 @@ const IndexMeta *TableMeta::index(int i) const { return &indexes_[i]; }
 
 int TableMeta::index_num() const { return indexes_.size(); }
 
+const IndexMeta *TableMeta::cluster_index() const
+{
+  return cluster_index_.empty() ? nullptr : index(cluster_index_.c_str());
+}
+
 int TableMeta::record_size() const { return record_size_; }
 
 int TableMeta::serialize(std::ostream &ss) const
@@ -189,6 +197,9 @@ int TableMeta::serialize(std::ostream &ss) const
     indexes_value.append(std::move(index_value));
   }
   table_value[FIELD_INDEXES] = std::move(indexes_value);
+  if (!cluster_index_.empty()) {
+    table_value[FIELD_CLUSTER_INDEX] = cluster_index_;
+  }
 
   Json::StreamWriterBuilder builder;
   Json::StreamWriter       *writer = builder.newStreamWriter();
@@ -294,6 +305,15 @@ int TableMeta::deserialize(std::istream &is)
     indexes_.swap(indexes);
   }
 
+  const Json::Value &cluster_index_value = table_value[FIELD_CLUSTER_INDEX];
+  if (!cluster_index_value.isNull()) {
+    if (!cluster_index_value.isString() || index(cluster_index_value.asCString()) == nullptr) {
+      LOG_ERROR("Invalid cluster index. json value=%s", cluster_index_value.toStyledString().c_str());
+      return -1;
+    }
+    cluster_index_ = cluster_index_value.asString();
+  }
+
   return (int)(is.tellg() - old_pos);
 }
 
@@ -315,5 +335,9 @@ void TableMeta::desc(std::ostream &os) const
     index.desc(os);
     os << std::endl;
   }
-  os << ')' << std::endl;
+  os << ')';
+  if (!cluster_index_.empty()) {
+    os << " cluster_index=" << cluster_index_;
+  }
+  os << std::endl;
 }
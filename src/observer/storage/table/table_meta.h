@@ -43,6 +43,13 @@ public:
 
   RC add_index(const IndexMeta &index);
 
+  /**
+   * @brief 设置聚簇索引
+   * @details 聚簇表的记录按照聚簇索引的键值放置在数据页面中，键值相邻的记录尽量放在同一个页面，
+   * 按照聚簇键范围扫描时读取的页面更少，参考 Table::insert_record
+   */
+  void set_cluster_index(const char *index_name) { cluster_index_ = index_name; }
+
 public:
   int32_t             table_id() const { return table_id_; }
   const char         *name() const;
@@ -62,6 +69,11 @@ public:
   const IndexMeta *index(int i) const;
   int              index_num() const;
 
+  /**
+   * @brief 聚簇索引，不是聚簇表时返回 nullptr
+   */
+  const IndexMeta *cluster_index() const;
+
   int record_size() const;
 
 public:
@@ -77,6 +89,7 @@ protected:
   std::vector<FieldMeta> trx_fields_;
   std::vector<FieldMeta> fields_;  // 包含sys_fields
   std::vector<IndexMeta> indexes_;
+  std::string            cluster_index_;  ///< 聚簇索引的名字，为空时不是聚簇表
   StorageFormat          storage_format_;
 
   int record_size_ = 0;
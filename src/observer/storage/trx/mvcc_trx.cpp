@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/field/field.h"
 #include "storage/trx/mvcc_trx_log.h"
 #include "common/lang/algorithm.h"
+#include "common/math/simd_util.h"
 
 MvccTrxKit::~MvccTrxKit()
 {
@@ -111,6 +112,19 @@ LogReplayer *MvccTrxKit::create_log_replayer(Db &db, LogHandler &log_handler)
   return new MvccTrxLogReplayer(db, *this, log_handler);
 }
 
+bool MvccTrxKit::is_relocatable(Table *table, const Record &record) const
+{
+  span<const FieldMeta> trx_fields = table->table_meta().trx_fields();
+  if (trx_fields.size() < 2) {
+    return true;
+  }
+
+  // 未提交的事务号都是负数
+  const int32_t begin_xid = Field(table, &trx_fields[0]).get_int(record);
+  const int32_t end_xid   = Field(table, &trx_fields[1]).get_int(record);
+  return begin_xid > 0 && end_xid > 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler) : trx_kit_(kit), log_handler_(log_handler)
@@ -195,6 +209,73 @@ RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
   int32_t begin_xid = begin_field.get_int(record);
   int32_t end_xid   = end_field.get_int(record);
 
+  return check_visibility(begin_xid, end_xid, mode);
+}
+
+RC MvccTrx::visit_chunk(Table *table, Chunk &chunk, vector<uint8_t> &select, ReadWriteMode mode)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int begin_index = chunk.column_index(begin_field.meta()->field_id());
+  const int end_index   = chunk.column_index(end_field.meta()->field_id());
+  if (begin_index < 0 || end_index < 0) {
+    LOG_WARN("chunk does not contain trx fields. table=%s", table->name());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int32_t *begin_xids = reinterpret_cast<const int32_t *>(chunk.column(begin_index).data());
+  const int32_t *end_xids   = reinterpret_cast<const int32_t *>(chunk.column(end_index).data());
+  const int      rows       = chunk.rows();
+  ASSERT(static_cast<int>(select.size()) >= rows, "select vector is too small. size=%d, rows=%d", select.size(), rows);
+
+  RC  rc = RC::SUCCESS;
+  int i  = 0;
+#ifdef USE_SIMD
+  const __m256i zero   = _mm256_setzero_si256();
+  const __m256i trx_id = _mm256_set1_epi32(trx_id_);
+  for (; i + SIMD_WIDTH <= rows; i += SIMD_WIDTH) {
+    __m256i begin = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin_xids + i));
+    __m256i end   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(end_xids + i));
+
+    // 大部分记录都是已经提交的，begin xid 和 end xid 都大于0，这时只需要判断 begin <= trx_id <= end
+    __m256i committed = _mm256_and_si256(_mm256_cmpgt_epi32(begin, zero), _mm256_cmpgt_epi32(end, zero));
+    if (_mm256_movemask_epi8(committed) != -1) {
+      for (int j = i; j < i + SIMD_WIDTH; j++) {
+        rc = check_visibility(begin_xids[j], end_xids[j], mode);
+        if (rc == RC::RECORD_INVISIBLE) {
+          select[j] = 0;
+        } else if (OB_FAIL(rc)) {
+          return rc;
+        }
+      }
+      continue;
+    }
+
+    __m256i invisible = _mm256_or_si256(_mm256_cmpgt_epi32(begin, trx_id), _mm256_cmpgt_epi32(trx_id, end));
+    int     mask      = _mm256_movemask_ps(_mm256_castsi256_ps(invisible));
+    for (int j = 0; mask != 0; j++, mask >>= 1) {
+      if (mask & 1) {
+        select[i + j] = 0;
+      }
+    }
+  }
+#endif
+
+  for (; i < rows; i++) {
+    rc = check_visibility(begin_xids[i], end_xids[i], mode);
+    if (rc == RC::RECORD_INVISIBLE) {
+      select[i] = 0;
+    } else if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC MvccTrx::check_visibility(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const
+{
   RC rc = RC::SUCCESS;
   if (begin_xid > 0 && end_xid > 0) {
     if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
@@ -44,6 +44,12 @@ public:
 
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 
+  /**
+   * @brief 只有已经提交的版本才可以移动
+   * @details 未提交的事务在操作记录中保存了记录的RID，提交或回滚时会使用
+   */
+  bool is_relocatable(Table *table, const Record &record) const override;
+
 public:
   int32_t next_trx_id();
 
@@ -91,6 +97,13 @@ public:
    */
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
 
+  /**
+   * @brief 批量判断可见性
+   * @details 直接在 begin/end xid 两列上计算。编译时打开 USE_SIMD 时，每次比较8条记录，
+   * 只有一组记录中存在未提交的修改时才逐条判断。
+   */
+  RC visit_chunk(Table *table, Chunk &chunk, vector<uint8_t> &select, ReadWriteMode mode) override;
+
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -100,6 +113,11 @@ public:
   int32_t id() const override { return trx_id_; }
 
 private:
+  /**
+   * @brief 根据记录的 begin/end xid 判断记录对当前事务的可见性，返回值与 visit_record 相同
+   */
+  RC check_visibility(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const;
+
   RC   commit_with_trx_id(int32_t commit_id);
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
@@ -129,6 +129,12 @@ public:
 
   virtual LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) = 0;
 
+  /**
+   * @brief 判断记录能否被移动到其它位置
+   * @details 页面整理会改变记录的RID，如果还有未结束的事务通过RID引用这条记录，就不能移动
+   */
+  virtual bool is_relocatable(Table *table, const Record &record) const = 0;
+
 public:
   static TrxKit *create(const char *name);
 };
@@ -147,6 +153,23 @@ public:
   virtual RC delete_record(Table *table, Record &record)                    = 0;
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
 
+  /**
+   * @brief 批量判断一个 Chunk 中记录的可见性
+   * @details 与 visit_record 的语义相同，只是一次处理一批记录
+   * @param table  要访问的数据属于哪张表
+   * @param chunk  需要包含表上事务使用的系统字段，由 TrxKit::trx_fields 指定
+   * @param select 选择向量，不可见的记录对应的位置会被置为0。调用者需要保证它的长度与 chunk 的行数一致
+   * @param mode   是否只读访问
+   */
+  virtual RC visit_chunk(Table *table, Chunk &chunk, vector<uint8_t> &select, ReadWriteMode mode) = 0;
+
+  /**
+   * @brief 判断记录的可见性时是否需要读取记录本身
+   * @details 不需要时只读访问可以只扫描索引，参考 IndexScanPhysicalOperator::set_covering。
+   * MVCC 把版本信息放在记录中，并且提交时不会修改索引，所以默认都需要
+   */
+  virtual bool need_record_to_visit(Table *table) const { return true; }
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
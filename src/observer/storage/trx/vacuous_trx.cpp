@@ -38,6 +38,8 @@ RC VacuousTrx::delete_record(Table *table, Record &record) { return table->delet
 
 RC VacuousTrx::visit_record(Table *table, Record &record, ReadWriteMode) { return RC::SUCCESS; }
 
+RC VacuousTrx::visit_chunk(Table *table, Chunk &chunk, vector<uint8_t> &select, ReadWriteMode) { return RC::SUCCESS; }
+
 RC VacuousTrx::start_if_need() { return RC::SUCCESS; }
 
 RC VacuousTrx::commit() { return RC::SUCCESS; }
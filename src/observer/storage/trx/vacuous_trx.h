@@ -36,6 +36,8 @@ public:
   void destroy_trx(Trx *trx) override;
 
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
+
+  bool is_relocatable(Table *table, const Record &record) const override { return true; }
 };
 
 class VacuousTrx : public Trx
@@ -47,6 +49,9 @@ public:
   RC insert_record(Table *table, Record &record) override;
   RC delete_record(Table *table, Record &record) override;
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
+  RC visit_chunk(Table *table, Chunk &chunk, vector<uint8_t> &select, ReadWriteMode mode) override;
+  /// 删除记录时会同时删除索引中的数据，索引中的数据都是可见的
+  bool need_record_to_visit(Table *table) const override { return false; }
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
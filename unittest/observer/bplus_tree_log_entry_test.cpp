@@ -160,6 +160,27 @@ TEST(BplusTreeLogEntry, leaf_set_next_page_log_entry)
   ASSERT_EQ(next_page_num, entry2->new_page_num());
 }
 
+TEST(BplusTreeLogEntry, leaf_set_prev_page_log_entry)
+{
+  Frame frame;
+  frame.set_page_num(100);
+  PageNum                        prev_page_num     = 1000;
+  PageNum                        old_prev_page_num = 200;
+  LeafSetPrevPageLogEntryHandler entry(&frame, prev_page_num, old_prev_page_num);
+
+  // test serializer and desirializer
+  Serializer serializer;
+  ASSERT_EQ(RC::SUCCESS, entry.serialize(serializer));
+
+  Deserializer                deserializer(serializer.data());
+  unique_ptr<LogEntryHandler> handler;
+  ASSERT_EQ(RC::SUCCESS, LogEntryHandler::from_buffer(deserializer, handler));
+
+  auto entry2 = dynamic_cast<LeafSetPrevPageLogEntryHandler *>(handler.get());
+  ASSERT_NE(nullptr, entry2);
+  ASSERT_EQ(prev_page_num, entry2->new_page_num());
+}
+
 TEST(BplusTreeLogEntry, internal_init_empty_log_entry)
 {
   Frame frame;
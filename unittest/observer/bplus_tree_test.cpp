@@ -12,13 +12,17 @@ See the Mulan PSL v2 for more details. */
 // Created by longda on 2022
 //
 
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <filesystem>
+#include <random>
+#include <thread>
 
 #include "common/log/log.h"
 #include "common/lang/memory.h"
 #include "common/lang/filesystem.h"
+#include "common/lang/lower_bound.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/index/bplus_tree.h"
@@ -826,6 +830,1079 @@ TEST(test_bplus_tree, test_bplus_tree_insert)
   handler = nullptr;
 }
 
+TEST(test_bplus_tree, test_bulk_build)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "bulk_build.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+  ASSERT_NE(nullptr, buffer_pool);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int), ORDER, ORDER));
+
+  // 每个键值有两条数据，节点很小，会构建出好几层
+  const int key_num = 500;
+  RID       rid;
+  {
+    BplusTreeBulkBuilder builder(handler);
+    for (int i = 0; i < key_num; i++) {
+      for (int j = 0; j < 2; j++) {
+        rid.page_num = i;
+        rid.slot_num = j;
+        ASSERT_EQ(RC::SUCCESS, builder.append((const char *)&i, rid));
+      }
+    }
+
+    // 键值必须是递增的
+    int key = 0;
+    ASSERT_NE(RC::SUCCESS, builder.append((const char *)&key, rid));
+    ASSERT_EQ(RC::SUCCESS, builder.finish());
+  }
+  ASSERT_FALSE(handler.is_empty());
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 已经有数据的树不能再批量构建
+  {
+    BplusTreeBulkBuilder builder(handler);
+    int                  key = key_num;
+    ASSERT_NE(RC::SUCCESS, builder.append((const char *)&key, rid));
+  }
+
+  // scanner 析构时才会释放叶子节点上的锁，所以放在单独的作用域里
+  {
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    int count = 0;
+    RC  rc    = RC::SUCCESS;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      ASSERT_EQ(count / 2, rid.page_num);
+      ASSERT_EQ(count % 2, rid.slot_num);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(key_num * 2, count);
+    scanner.close();
+  }
+
+  // 构建出来的树可以正常地插入和删除
+  for (int i = 0; i < key_num; i++) {
+    rid.page_num = i;
+    rid.slot_num = 2;
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+  for (int i = 0; i < key_num; i += 2) {
+    for (int j = 0; j < 3; j++) {
+      rid.page_num = i;
+      rid.slot_num = j;
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &rid));
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int i = 0; i < key_num; i++) {
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&i, sizeof(i), rids));
+    ASSERT_EQ(i % 2 == 0 ? 0 : 3, static_cast<int>(rids.size()));
+  }
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_composite_key)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "composite_key.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+  ASSERT_NE(nullptr, buffer_pool);
+
+  // 字段类型和长度的个数必须一致
+  const AttrType attr_types[]   = {AttrType::INTS, AttrType::CHARS};
+  const int      attr_lengths[] = {sizeof(int), 4};
+  {
+    BplusTreeHandler bad_handler;
+    ASSERT_NE(RC::SUCCESS,
+        bad_handler.create(log_handler, *buffer_pool, span<const AttrType>(attr_types), span<const int>(attr_lengths, 1)));
+  }
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, *buffer_pool, span<const AttrType>(attr_types), span<const int>(attr_lengths), ORDER, ORDER));
+
+  auto make_key = [](int a, const char *b, char *key) {
+    memset(key, 0, sizeof(int) + 4);
+    memcpy(key, &a, sizeof(a));
+    if (b != nullptr) {
+      memcpy(key + sizeof(int), b, std::min(strlen(b), static_cast<size_t>(4)));
+    }
+  };
+
+  // 第二个字段的取值，倒着插入，验证是按照第一个字段、第二个字段的顺序排列的
+  const char *second_values[] = {"a", "b", "c"};
+  const int   key_num         = 100;
+  char        key[sizeof(int) + 4];
+  RID         rid;
+  for (int i = key_num - 1; i >= 0; i--) {
+    for (int j = 2; j >= 0; j--) {
+      make_key(i, second_values[j], key);
+      rid.page_num = i;
+      rid.slot_num = j;
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  auto scan = [&handler](const char *left, int left_len, bool left_inclusive, const char *right, int right_len,
+                  bool right_inclusive, vector<RID> &rids) {
+    rids.clear();
+    BplusTreeScanner scanner(handler);
+    RC               rc = scanner.open(left, left_len, left_inclusive, right, right_len, right_inclusive);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    RID rid;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      rids.push_back(rid);
+    }
+    scanner.close();
+    return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+  };
+
+  vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, scan(nullptr, 0, true, nullptr, 0, true, rids));
+  ASSERT_EQ(key_num * 3, static_cast<int>(rids.size()));
+  for (int i = 0; i < static_cast<int>(rids.size()); i++) {
+    ASSERT_EQ(i / 3, rids[i].page_num);
+    ASSERT_EQ(i % 3, rids[i].slot_num);
+  }
+
+  // 只给出第一个字段，扫描这个前缀下的所有数据
+  int a = 7;
+  ASSERT_EQ(RC::SUCCESS, scan((const char *)&a, sizeof(a), true, (const char *)&a, sizeof(a), true, rids));
+  ASSERT_EQ(3, static_cast<int>(rids.size()));
+  for (int j = 0; j < 3; j++) {
+    ASSERT_EQ(7, rids[j].page_num);
+    ASSERT_EQ(j, rids[j].slot_num);
+  }
+
+  // 第一个字段上的开区间
+  int left_a  = 10;
+  int right_a = 12;
+  ASSERT_EQ(RC::SUCCESS, scan((const char *)&left_a, sizeof(int), false, (const char *)&right_a, sizeof(int), true, rids));
+  ASSERT_EQ(6, static_cast<int>(rids.size()));
+  ASSERT_EQ(11, rids.front().page_num);
+  ASSERT_EQ(12, rids.back().page_num);
+
+  // 第一个字段等值，第二个字段范围 [b, c)
+  char left_key[sizeof(int) + 4];
+  char right_key[sizeof(int) + 4];
+  make_key(a, "b", left_key);
+  make_key(a, "c", right_key);
+  ASSERT_EQ(RC::SUCCESS, scan(left_key, sizeof(left_key), true, right_key, sizeof(right_key), false, rids));
+  ASSERT_EQ(1, static_cast<int>(rids.size()));
+  ASSERT_EQ(7, rids[0].page_num);
+  ASSERT_EQ(1, rids[0].slot_num);
+
+  // 第一个字段等值，第二个字段只有上界 (, b]
+  ASSERT_EQ(RC::SUCCESS, scan((const char *)&a, sizeof(a), true, left_key, sizeof(left_key), true, rids));
+  ASSERT_EQ(2, static_cast<int>(rids.size()));
+
+  // 完整的键值可以直接查找和删除
+  make_key(a, "c", key);
+  list<RID> found;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entry(key, sizeof(key), found));
+  ASSERT_EQ(1, static_cast<int>(found.size()));
+  rid.page_num = a;
+  rid.slot_num = 2;
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entry(key, &rid));
+  ASSERT_EQ(RC::SUCCESS, scan((const char *)&a, sizeof(a), true, (const char *)&a, sizeof(a), true, rids));
+  ASSERT_EQ(2, static_cast<int>(rids.size()));
+  ASSERT_TRUE(handler.validate_tree());
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_key_compression)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 使用默认的节点大小，同样的数据分别插入压缩和不压缩的B+树
+  const int        key_length = 64;
+  const AttrType   attr_type  = AttrType::CHARS;
+  BplusTreeHandler handlers[2];
+  for (int i = 0; i < 2; i++) {
+    const bool  key_compression = (i == 0);
+    std::string file_name       = (test_directory / (key_compression ? "compressed.btree" : "plain.btree")).string();
+    ASSERT_EQ(RC::SUCCESS,
+        handlers[i].create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+            span<const int>(&key_length, 1), -1, -1, key_compression));
+  }
+  BplusTreeHandler &compressed = handlers[0];
+  BplusTreeHandler &plain      = handlers[1];
+
+  auto make_key = [](int i, char *key) {
+    memset(key, 0, key_length);
+    snprintf(key, key_length, "customer-email-address-%08d@example.com", i);
+  };
+
+  const int   key_num = 20000;
+  vector<int> values(key_num);
+  for (int i = 0; i < key_num; i++) {
+    values[i] = i;
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(values.begin(), values.end(), random_engine);
+
+  char key[key_length];
+  for (int value : values) {
+    make_key(value, key);
+    RID rid(value, value);
+    ASSERT_EQ(RC::SUCCESS, compressed.insert_entry(key, &rid));
+    ASSERT_EQ(RC::SUCCESS, plain.insert_entry(key, &rid));
+  }
+  ASSERT_TRUE(compressed.validate_tree());
+  ASSERT_TRUE(plain.validate_tree());
+
+  BplusTreeStat compressed_stat;
+  BplusTreeStat plain_stat;
+  ASSERT_EQ(RC::SUCCESS, compressed.get_stat(compressed_stat));
+  ASSERT_EQ(RC::SUCCESS, plain.get_stat(plain_stat));
+  ASSERT_EQ(key_num, compressed_stat.entry_num);
+  ASSERT_EQ(key_num, plain_stat.entry_num);
+  ASSERT_LT(compressed_stat.height, plain_stat.height);
+  ASSERT_LT(compressed_stat.leaf_pages, plain_stat.leaf_pages);
+  ASSERT_LT(compressed_stat.internal_pages, plain_stat.internal_pages);
+
+  // 删除三分之二的数据，节点会合并或者重新分配
+  std::shuffle(values.begin(), values.end(), random_engine);
+  for (int i = 0; i < key_num; i++) {
+    if (values[i] % 3 != 0) {
+      make_key(values[i], key);
+      RID rid(values[i], values[i]);
+      ASSERT_EQ(RC::SUCCESS, compressed.delete_entry(key, &rid));
+    }
+  }
+  ASSERT_TRUE(compressed.validate_tree());
+
+  for (int i = 0; i < key_num; i++) {
+    make_key(i, key);
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, compressed.get_entry(key, static_cast<int>(strlen(key)), rids));
+    if (i % 3 == 0) {
+      ASSERT_EQ(1, static_cast<int>(rids.size()));
+      ASSERT_EQ(i, rids.front().page_num);
+    } else {
+      ASSERT_EQ(0, static_cast<int>(rids.size()));
+    }
+  }
+
+  // 范围扫描的结果是有序的
+  char left_key[key_length];
+  char right_key[key_length];
+  make_key(300, left_key);
+  make_key(900, right_key);
+  {
+    BplusTreeScanner scanner(compressed);
+    ASSERT_EQ(RC::SUCCESS,
+        scanner.open(left_key, static_cast<int>(strlen(left_key)), true, right_key, static_cast<int>(strlen(right_key)), false));
+    RID rid;
+    int expected = 300;
+    RC  rc       = RC::SUCCESS;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      ASSERT_EQ(expected, rid.page_num);
+      expected += 3;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(900, expected);
+    scanner.close();
+  }
+
+  // 再插回去
+  for (int i = 0; i < key_num; i++) {
+    if (values[i] % 3 != 0) {
+      make_key(values[i], key);
+      RID rid(values[i], values[i]);
+      ASSERT_EQ(RC::SUCCESS, compressed.insert_entry(key, &rid));
+    }
+  }
+  ASSERT_TRUE(compressed.validate_tree());
+  ASSERT_EQ(RC::SUCCESS, compressed.get_stat(compressed_stat));
+  ASSERT_EQ(key_num, compressed_stat.entry_num);
+
+  compressed.close();
+  plain.close();
+}
+
+TEST(test_bplus_tree, test_separate_leaf_values)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 键值是否压缩、键值和值是否分开存放的各种组合，同样的操作结果都一样
+  const AttrType   attr_type   = AttrType::INTS;
+  const int        attr_length = sizeof(int);
+  BplusTreeHandler handlers[4];
+  for (int i = 0; i < 4; i++) {
+    const bool  key_compression      = (i & 1) != 0;
+    const bool  separate_leaf_values = (i & 2) != 0;
+    std::string file_name            = (test_directory / ("layout_" + std::to_string(i) + ".btree")).string();
+    ASSERT_EQ(RC::SUCCESS,
+        handlers[i].create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1), 16, 16, key_compression, separate_leaf_values));
+  }
+
+  const int   key_num = 5000;
+  vector<int> values(key_num);
+  for (int i = 0; i < key_num; i++) {
+    values[i] = i;
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(values.begin(), values.end(), random_engine);
+
+  for (BplusTreeHandler &handler : handlers) {
+    for (int value : values) {
+      RID rid(value, value);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    // 删除一半的数据，节点会合并或者重新分配
+    for (int i = 0; i < key_num; i += 2) {
+      RID rid(values[i], values[i]);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&values[i]), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+  }
+
+  BplusTreeStat expected_stat;
+  ASSERT_EQ(RC::SUCCESS, handlers[0].get_stat(expected_stat));
+  for (BplusTreeHandler &handler : handlers) {
+    BplusTreeStat stat;
+    ASSERT_EQ(RC::SUCCESS, handler.get_stat(stat));
+    ASSERT_EQ(key_num / 2, stat.entry_num);
+    // 不压缩时节点容量只由创建时指定的大小决定，与存放方式无关
+    if (&handler == &handlers[2]) {
+      ASSERT_EQ(expected_stat.leaf_pages, stat.leaf_pages);
+    }
+
+    for (int i = 0; i < key_num; i++) {
+      list<RID> rids;
+      ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&values[i]), attr_length, rids));
+      if (i % 2 == 0) {
+        ASSERT_EQ(0, static_cast<int>(rids.size()));
+      } else {
+        ASSERT_EQ(1, static_cast<int>(rids.size()));
+        ASSERT_EQ(values[i], rids.front().page_num);
+        ASSERT_EQ(values[i], rids.front().slot_num);
+      }
+    }
+
+    // 全表扫描的结果是有序的，值与键值对应
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, false, nullptr, 0, false));
+    RID rid;
+    int count    = 0;
+    int previous = -1;
+    RC  rc       = RC::SUCCESS;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      ASSERT_LT(previous, rid.page_num);
+      ASSERT_EQ(rid.page_num, rid.slot_num);
+      previous = rid.page_num;
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(key_num / 2, count);
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    handler.close();
+  }
+}
+
+TEST(test_bplus_tree, test_include_data)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 一个逐条插入，一个批量构建，RID后面都附带两个整数
+  const AttrType   attr_type      = AttrType::INTS;
+  const int        attr_length    = sizeof(int);
+  const int        include_length = 2 * sizeof(int);
+  BplusTreeHandler handlers[2];
+  for (int i = 0; i < 2; i++) {
+    std::string file_name = (test_directory / ("include_" + std::to_string(i) + ".btree")).string();
+    ASSERT_EQ(RC::SUCCESS,
+        handlers[i].create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1), 16, 16, true /*key_compression*/, true /*separate_leaf_values*/,
+            include_length));
+  }
+
+  const int key_num = 2000;
+  auto make_include = [](int value, int include[2]) {
+    include[0] = value * 2;
+    include[1] = -value;
+  };
+
+  vector<int> values(key_num);
+  for (int i = 0; i < key_num; i++) {
+    values[i] = i;
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(values.begin(), values.end(), random_engine);
+
+  int include[2];
+  for (int value : values) {
+    RID rid(value, value);
+    make_include(value, include);
+    ASSERT_EQ(RC::SUCCESS, handlers[0].insert_entry(reinterpret_cast<const char *>(&value), &rid,
+                               reinterpret_cast<const char *>(include)));
+  }
+  // 有附带数据时必须提供
+  RID missing_rid(key_num, key_num);
+  ASSERT_NE(RC::SUCCESS, handlers[0].insert_entry(reinterpret_cast<const char *>(&key_num), &missing_rid));
+
+  {
+    BplusTreeBulkBuilder builder(handlers[1]);
+    for (int i = 0; i < key_num; i++) {
+      RID rid(i, i);
+      make_include(i, include);
+      ASSERT_EQ(RC::SUCCESS,
+          builder.append(reinterpret_cast<const char *>(&i), rid, reinterpret_cast<const char *>(include)));
+    }
+    ASSERT_EQ(RC::SUCCESS, builder.finish());
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    // 删除一半的数据，附带的数据随着节点合并和重新分配一起移动
+    for (int i = 0; i < key_num; i += 2) {
+      RID rid(values[i], values[i]);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&values[i]), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, false, nullptr, 0, false));
+    RID         rid;
+    const char *key   = nullptr;
+    const char *data  = nullptr;
+    int         count = 0;
+    RC          rc    = RC::SUCCESS;
+    while (OB_SUCC(rc = scanner.next_entry(rid, key, data))) {
+      int value = *reinterpret_cast<const int *>(key);
+      ASSERT_EQ(value, rid.page_num);
+      ASSERT_NE(nullptr, data);
+      make_include(value, include);
+      ASSERT_EQ(0, memcmp(data, include, include_length));
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(key_num / 2, count);
+    scanner.close();
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    handler.close();
+  }
+}
+
+TEST(test_bplus_tree, test_unique_key)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  const AttrType   attr_type   = AttrType::INTS;
+  const int        attr_length = sizeof(int);
+  BplusTreeHandler handlers[2];
+  for (int i = 0; i < 2; i++) {
+    std::string file_name = (test_directory / ("unique_" + std::to_string(i) + ".btree")).string();
+    ASSERT_EQ(RC::SUCCESS,
+        handlers[i].create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1), 16, 16, true /*key_compression*/, true /*separate_leaf_values*/,
+            0 /*include_length*/, true /*unique_keys*/));
+  }
+
+  const int   key_num = 2000;
+  vector<int> values(key_num);
+  for (int i = 0; i < key_num; i++) {
+    values[i] = i;
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(values.begin(), values.end(), random_engine);
+
+  // 键值相同时，不管RID是否相同都不能插入
+  for (int value : values) {
+    RID rid(value, value);
+    ASSERT_EQ(RC::SUCCESS, handlers[0].insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  for (int value : values) {
+    RID rid(value + 1, value);
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handlers[0].insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+
+  {
+    BplusTreeBulkBuilder builder(handlers[1]);
+    for (int i = 0; i < key_num; i++) {
+      RID rid(i, i);
+      ASSERT_EQ(RC::SUCCESS, builder.append(reinterpret_cast<const char *>(&i), rid));
+    }
+    ASSERT_EQ(RC::SUCCESS, builder.finish());
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    ASSERT_TRUE(handler.validate_tree());
+
+    // RID不同的记录不能删除别人的索引项
+    for (int i = 0; i < key_num; i += 2) {
+      RID other_rid(values[i] + 1, values[i]);
+      ASSERT_NE(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&values[i]), &other_rid));
+      RID rid(values[i], values[i]);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&values[i]), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    // 删除之后可以用新的RID再插入
+    for (int i = 0; i < key_num; i += 4) {
+      RID rid(values[i] + key_num, values[i]);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&values[i]), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    // 键值后面都是同一个RID，边界是否包含要在扫描时判断
+    const int left  = 100;
+    const int right = 200;
+    for (int inclusive = 0; inclusive < 2; inclusive++) {
+      BplusTreeScanner scanner(handler);
+      ASSERT_EQ(RC::SUCCESS,
+          scanner.open(reinterpret_cast<const char *>(&left), sizeof(left), inclusive != 0,
+              reinterpret_cast<const char *>(&right), sizeof(right), inclusive != 0));
+      RID rid;
+      int expected_count = 0;
+      int count          = 0;
+      for (int i = 0; i < key_num; i++) {
+        const int value = values[i];
+        const bool exists = (i % 2 != 0) || (i % 4 == 0);
+        if (exists && (inclusive ? (value >= left && value <= right) : (value > left && value < right))) {
+          expected_count++;
+        }
+      }
+      RC rc = RC::SUCCESS;
+      while (OB_SUCC(rc = scanner.next_entry(rid))) {
+        count++;
+      }
+      ASSERT_EQ(RC::RECORD_EOF, rc);
+      ASSERT_EQ(expected_count, count);
+      scanner.close();
+    }
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    handler.close();
+  }
+
+  // 批量构建时也要检查重复的键值
+  BplusTreeHandler handler;
+  std::string      file_name = (test_directory / "unique_bulk.btree").string();
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+          span<const int>(&attr_length, 1), 16, 16, true, true, 0, true /*unique_keys*/));
+  {
+    BplusTreeBulkBuilder builder(handler);
+    const int            key = 1;
+    RID                  rid1(1, 1);
+    RID                  rid2(1, 2);
+    ASSERT_EQ(RC::SUCCESS, builder.append(reinterpret_cast<const char *>(&key), rid1));
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, builder.append(reinterpret_cast<const char *>(&key), rid2));
+  }
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_reverse_scan)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 一个逐条插入再删除一部分，会有节点分裂和合并；一个批量构建
+  const AttrType   attr_type   = AttrType::INTS;
+  const int        attr_length = sizeof(int);
+  BplusTreeHandler handlers[2];
+  for (int i = 0; i < 2; i++) {
+    std::string file_name = (test_directory / ("reverse_" + std::to_string(i) + ".btree")).string();
+    ASSERT_EQ(RC::SUCCESS,
+        handlers[i].create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1), 16, 16));
+  }
+
+  // 键值就是RID的页面编号，每个键值有两条数据
+  const int   key_num = 1000;
+  vector<RID> rids;
+  for (int i = 1; i <= key_num; i++) {
+    rids.push_back(RID(i, 0));
+    rids.push_back(RID(i, 1));
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(rids.begin(), rids.end(), random_engine);
+  for (const RID &rid : rids) {
+    ASSERT_EQ(RC::SUCCESS, handlers[0].insert_entry(reinterpret_cast<const char *>(&rid.page_num), &rid));
+  }
+  for (size_t i = 0; i < rids.size(); i += 3) {
+    ASSERT_EQ(RC::SUCCESS, handlers[0].delete_entry(reinterpret_cast<const char *>(&rids[i].page_num), &rids[i]));
+  }
+
+  {
+    BplusTreeBulkBuilder builder(handlers[1]);
+    for (int i = 1; i <= key_num; i++) {
+      for (int slot = 0; slot < 2; slot++) {
+        ASSERT_EQ(RC::SUCCESS, builder.append(reinterpret_cast<const char *>(&i), RID(i, slot)));
+      }
+    }
+    ASSERT_EQ(RC::SUCCESS, builder.finish());
+  }
+
+  auto scan = [](BplusTreeHandler &handler, const int *left, bool left_inclusive, const int *right,
+                  bool right_inclusive, bool reverse, vector<RID> &result) {
+    result.clear();
+    BplusTreeScanner scanner(handler);
+    RC rc = scanner.open(reinterpret_cast<const char *>(left), sizeof(int), left_inclusive,
+        reinterpret_cast<const char *>(right), sizeof(int), right_inclusive, reverse);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    RID rid;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      result.push_back(rid);
+    }
+    scanner.close();
+    return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+  };
+
+  const int bounds[] = {0, 1, 2, 15, 16, 500, 501, 999, 1000, 1001};
+  for (BplusTreeHandler &handler : handlers) {
+    ASSERT_TRUE(handler.validate_tree());
+
+    vector<RID> forward;
+    vector<RID> backward;
+    ASSERT_EQ(RC::SUCCESS, scan(handler, nullptr, false, nullptr, false, false, forward));
+    ASSERT_EQ(RC::SUCCESS, scan(handler, nullptr, false, nullptr, false, true, backward));
+    ASSERT_FALSE(forward.empty());
+    std::reverse(backward.begin(), backward.end());
+    ASSERT_EQ(forward, backward);
+
+    // 反向扫描的结果与正向扫描的结果顺序相反
+    for (int left : bounds) {
+      for (int right : bounds) {
+        if (left > right) {
+          continue;
+        }
+        for (int inclusive = 0; inclusive < 4; inclusive++) {
+          const bool left_inclusive  = (inclusive & 1) != 0;
+          const bool right_inclusive = (inclusive & 2) != 0;
+          RC         rc = scan(handler, &left, left_inclusive, &right, right_inclusive, false, forward);
+          if (rc == RC::INVALID_ARGUMENT) {
+            ASSERT_EQ(rc, scan(handler, &left, left_inclusive, &right, right_inclusive, true, backward));
+            continue;
+          }
+          ASSERT_EQ(RC::SUCCESS, rc);
+          ASSERT_EQ(RC::SUCCESS, scan(handler, &left, left_inclusive, &right, right_inclusive, true, backward));
+          std::reverse(backward.begin(), backward.end());
+          ASSERT_EQ(forward, backward) << "left=" << left << ", right=" << right << ", inclusive=" << inclusive;
+          for (const RID &rid : forward) {
+            ASSERT_TRUE(left_inclusive ? rid.page_num >= left : rid.page_num > left);
+            ASSERT_TRUE(right_inclusive ? rid.page_num <= right : rid.page_num < right);
+          }
+        }
+      }
+    }
+
+    // 只有一边的边界
+    for (int bound : bounds) {
+      ASSERT_EQ(RC::SUCCESS, scan(handler, nullptr, false, &bound, true, true, backward));
+      for (size_t i = 0; i < backward.size(); i++) {
+        ASSERT_LE(backward[i].page_num, bound);
+        if (i > 0) {
+          ASSERT_LT(RID::compare(&backward[i], &backward[i - 1]), 0);
+        }
+      }
+      ASSERT_EQ(RC::SUCCESS, scan(handler, &bound, false, nullptr, false, true, backward));
+      for (const RID &rid : backward) {
+        ASSERT_GT(rid.page_num, bound);
+      }
+    }
+  }
+
+  for (BplusTreeHandler &handler : handlers) {
+    handler.close();
+  }
+}
+
+TEST(test_bplus_tree, test_get_entries)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  const AttrType   attr_type   = AttrType::INTS;
+  const int        attr_length = sizeof(int);
+  BplusTreeHandler handler;
+  std::string      file_name = (test_directory / "get_entries.btree").string();
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, bpm, file_name.c_str(), span<const AttrType>(&attr_type, 1),
+          span<const int>(&attr_length, 1), 16, 16));
+
+  auto get_entries = [&handler](const vector<int> &keys, vector<vector<RID>> &rids) {
+    vector<const char *> user_keys;
+    for (const int &key : keys) {
+      user_keys.push_back(reinterpret_cast<const char *>(&key));
+    }
+    return handler.get_entries(user_keys, rids);
+  };
+
+  vector<vector<RID>> rids;
+  ASSERT_EQ(RC::SUCCESS, get_entries({1, 2, 3}, rids));
+  ASSERT_EQ(3, static_cast<int>(rids.size()));
+  for (const vector<RID> &key_rids : rids) {
+    ASSERT_TRUE(key_rids.empty());
+  }
+
+  // 键值 i 有 i % 7 条数据，7的倍数不存在。500 有很多条数据，会跨越多个叶子节点
+  const int   key_num = 1000;
+  vector<RID> entries;
+  for (int i = 1; i <= key_num; i++) {
+    const int count = (i == 500) ? 50 : i % 7;
+    for (int slot = 0; slot < count; slot++) {
+      entries.push_back(RID(i, slot));
+    }
+  }
+  std::mt19937 random_engine(2024);
+  std::shuffle(entries.begin(), entries.end(), random_engine);
+  for (const RID &rid : entries) {
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&rid.page_num), &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 连续的、有重复的、稀疏的、超出范围的键值
+  vector<int> keys = {0, 1, 2, 2, 3, 7, 8, 9, 10, 499, 500, 500, 501, 502, 600, 601, 900, 999, 1000, 1001, 2000};
+  for (int i = 100; i < 200; i++) {
+    keys.push_back(i);
+  }
+  for (int i = 200; i < key_num; i += 37) {
+    keys.push_back(i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  ASSERT_EQ(RC::SUCCESS, get_entries(keys, rids));
+  ASSERT_EQ(keys.size(), rids.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    list<RID> expected;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&keys[i]), sizeof(int), expected));
+    ASSERT_EQ(vector<RID>(expected.begin(), expected.end()), rids[i]) << "key=" << keys[i];
+  }
+  ASSERT_EQ(50, static_cast<int>(rids[std::lower_bound(keys.begin(), keys.end(), 500) - keys.begin()].size()));
+
+  // 键值没有排序
+  ASSERT_EQ(RC::INVALID_ARGUMENT, get_entries({3, 2}, rids));
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_numeric_key_search)
+{
+  // 模拟叶子节点中的元素: 键值(数值 + RID) + RID
+  const int key_size  = 4 + sizeof(RID);
+  const int item_size = key_size + sizeof(RID);
+
+  std::mt19937 generator(2024);
+  for (AttrType attr_type : {AttrType::INTS, AttrType::FLOATS}) {
+    KeyComparator comparator;
+    comparator.init(attr_type, 4);
+    ASSERT_NE(KeySearchMethod::GENERIC, comparator.search_method());
+
+    auto make_key = [attr_type](int value, const RID &rid, char *key) {
+      if (attr_type == AttrType::INTS) {
+        memcpy(key, &value, sizeof(value));
+      } else {
+        // 间隔比 EPSILON 大
+        float float_value = value * 0.5f;
+        memcpy(key, &float_value, sizeof(float_value));
+      }
+      memcpy(key + 4, &rid, sizeof(rid));
+    };
+
+    for (int item_num : {0, 1, 2, 7, 8, 9, 16, 33, 100, 257}) {
+      // 数值有重复，重复的按照RID排序
+      vector<std::pair<int, RID>> entries;
+      for (int i = 0; i < item_num; i++) {
+        entries.emplace_back(static_cast<int>(generator() % 64) - 32, RID(generator() % 4, generator() % 4));
+      }
+      std::sort(entries.begin(), entries.end(), [](const auto &left, const auto &right) {
+        if (left.first != right.first) {
+          return left.first < right.first;
+        }
+        return RID::compare(&left.second, &right.second) < 0;
+      });
+      entries.erase(std::unique(entries.begin(), entries.end(),
+                        [](const auto &left, const auto &right) {
+                          return left.first == right.first && RID::compare(&left.second, &right.second) == 0;
+                        }),
+          entries.end());
+
+      const int    entry_num = static_cast<int>(entries.size());
+      vector<char> items(std::max(1, entry_num) * item_size);
+      for (int i = 0; i < entry_num; i++) {
+        make_key(entries[i].first, entries[i].second, items.data() + i * item_size);
+      }
+
+      char key[key_size];
+      for (int value = -34; value <= 34; value++) {
+        for (const RID &rid : {*RID::min(), RID(1, 2), RID(2, 1), *RID::max()}) {
+          make_key(value, rid, key);
+
+          bool expected_found = false;
+          common::BinaryIterator<char> iter_begin(item_size, items.data());
+          common::BinaryIterator<char> iter_end(item_size, items.data() + entry_num * item_size);
+          const int expected = static_cast<int>(
+              common::lower_bound(iter_begin, iter_end, key, comparator, &expected_found) - iter_begin);
+
+          bool      found = false;
+          const int index = numeric_key_lower_bound(
+              comparator.search_method(), items.data(), item_size, entry_num, key, &found);
+          ASSERT_EQ(expected, index) << "item num=" << entry_num << ", value=" << value;
+          ASSERT_EQ(expected_found, found);
+        }
+      }
+    }
+  }
+
+  KeyComparator chars_comparator;
+  chars_comparator.init(AttrType::CHARS, 4);
+  ASSERT_EQ(KeySearchMethod::GENERIC, chars_comparator.search_method());
+}
+
+TEST(test_bplus_tree, test_typed_key_comparator)
+{
+  std::mt19937 generator(2024);
+
+  // 随机生成一个字段的数据，字符串有长有短，包含非ASCII字符
+  auto random_attr = [&generator](AttrType type, int length, char *data) {
+    memset(data, 0, length);
+    if (type == AttrType::INTS) {
+      int value = static_cast<int>(generator() % 16) - 8;
+      memcpy(data, &value, sizeof(value));
+    } else if (type == AttrType::FLOATS) {
+      float value = (static_cast<int>(generator() % 16) - 8) * 0.25f;
+      memcpy(data, &value, sizeof(value));
+    } else {
+      const int string_length = generator() % (length + 1);
+      for (int i = 0; i < string_length; i++) {
+        data[i] = "ab\xe4z"[generator() % 4];
+      }
+    }
+  };
+
+  // 构造 Value 比较，作为正确结果
+  auto value_compare = [](span<const AttrType> types, span<const int> lengths, const char *v1, const char *v2) {
+    int offset = 0;
+    for (size_t i = 0; i < types.size(); i++) {
+      Value left;
+      left.set_type(types[i]);
+      left.set_data(v1 + offset, lengths[i]);
+      Value right;
+      right.set_type(types[i]);
+      right.set_data(v2 + offset, lengths[i]);
+      int result = left.compare(right);
+      if (result != 0) {
+        return result;
+      }
+      offset += lengths[i];
+    }
+    return RID::compare(reinterpret_cast<const RID *>(v1 + offset), reinterpret_cast<const RID *>(v2 + offset));
+  };
+
+  auto sign = [](int value) { return (value > 0) - (value < 0); };
+
+  const vector<std::pair<vector<AttrType>, vector<int>>> key_defs = {
+      {{AttrType::INTS}, {4}},
+      {{AttrType::FLOATS}, {4}},
+      {{AttrType::CHARS}, {4}},
+      {{AttrType::CHARS}, {8}},
+      {{AttrType::CHARS}, {10}},
+      {{AttrType::CHARS}, {32}},
+      {{AttrType::INTS, AttrType::CHARS, AttrType::FLOATS}, {4, 6, 4}},
+  };
+  for (const auto &[types, lengths] : key_defs) {
+    KeyComparator comparator;
+    comparator.init(types, lengths);
+
+    const int    key_length = comparator.attr_comparator().attr_length() + sizeof(RID);
+    vector<char> v1(key_length);
+    vector<char> v2(key_length);
+    for (int i = 0; i < 2000; i++) {
+      for (vector<char> *key : {&v1, &v2}) {
+        int offset = 0;
+        for (size_t attr = 0; attr < types.size(); attr++) {
+          random_attr(types[attr], lengths[attr], key->data() + offset);
+          offset += lengths[attr];
+        }
+        RID rid(generator() % 2, generator() % 2);
+        memcpy(key->data() + offset, &rid, sizeof(rid));
+      }
+
+      const int expected = sign(value_compare(types, lengths, v1.data(), v2.data()));
+      ASSERT_EQ(expected, sign(comparator(v1.data(), v2.data())));
+      ASSERT_EQ(expected, sign(comparator.visit([&](const auto &typed) { return typed(v1.data(), v2.data()); })));
+    }
+  }
+}
+
+// 不开启 CONCURRENCY 时各种锁都是空操作，不能并发修改
+#ifdef CONCURRENCY
+TEST(test_bplus_tree, test_concurrent_modify)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_concurrent_modify.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+
+  // 节点比较小，乐观的修改和需要分裂、合并的悲观修改都会经常出现
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int), 16, 16));
+
+  const int thread_num     = 8;
+  const int key_per_thread = 4000;
+
+  std::atomic<int> failed_count{0};
+  auto             worker = [&](int thread_index) {
+    std::vector<int> keys(key_per_thread);
+    for (int i = 0; i < key_per_thread; i++) {
+      keys[i] = i * thread_num + thread_index;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(thread_index));
+
+    for (int key : keys) {
+      RID rid(key, key);
+      if (handler.insert_entry(reinterpret_cast<const char *>(&key), &rid) != RC::SUCCESS) {
+        failed_count++;
+      }
+    }
+    // 删除一半
+    for (int key : keys) {
+      if (key % 2 == 0) {
+        RID rid(key, key);
+        if (handler.delete_entry(reinterpret_cast<const char *>(&key), &rid) != RC::SUCCESS) {
+          failed_count++;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back(worker, i);
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  ASSERT_EQ(0, failed_count.load());
+  ASSERT_TRUE(handler.validate_tree());
+
+  BplusTreeStat stat;
+  ASSERT_EQ(RC::SUCCESS, handler.get_stat(stat));
+  ASSERT_EQ(thread_num * key_per_thread / 2, stat.entry_num);
+
+  for (int key = 0; key < thread_num * key_per_thread; key += 7) {
+    std::list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&key), sizeof(key), rids));
+    ASSERT_EQ(key % 2 == 0 ? 0 : 1, static_cast<int>(rids.size()));
+  }
+
+  handler.close();
+}
+#endif  // CONCURRENCY
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,359 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/value.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/index/index_entry_sorter.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+vector<FieldMeta> int_field_metas()
+{
+  vector<FieldMeta> field_metas(1);
+  field_metas[0].init("id", AttrType::INTS, 0 /*offset*/, 4 /*len*/, true /*visible*/, 0 /*field_id*/);
+  return field_metas;
+}
+
+// 按照 键值+RID 的顺序读出所有数据，检查顺序和数量
+void check_sorted(IndexEntrySorter &sorter, int expected_num)
+{
+  const char *key      = nullptr;
+  RID         rid;
+  int         count    = 0;
+  int         last_key = INT32_MIN;
+  RID         last_rid;
+  RC          rc = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(key, rid))) {
+    int value = *reinterpret_cast<const int *>(key);
+    ASSERT_EQ(value, rid.page_num % 1000);
+    if (count > 0) {
+      ASSERT_LE(last_key, value);
+      if (last_key == value) {
+        ASSERT_LT(RID::compare(&last_rid, &rid), 0);
+      }
+    }
+    last_key = value;
+    last_rid = rid;
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(expected_num, count);
+}
+
+}  // namespace
+
+TEST(IndexEntrySorterTest, sort)
+{
+  filesystem::path dir = filesystem::path("index_entry_sorter_test") / "sort";
+  filesystem::remove_all(dir);
+  filesystem::create_directories(dir);
+
+  const int entry_num = 10000;
+
+  // 内存足够时不写临时文件，内存很小时会写很多个run
+  for (int64_t memory_limit : {int64_t(IndexBuildOptions::DEFAULT_SORT_MEMORY), int64_t(4096)}) {
+    IndexEntrySorter sorter(int_field_metas(), memory_limit, (dir / "t").string());
+
+    mt19937 generator(2024);
+    for (int i = 0; i < entry_num; i++) {
+      // 键值有重复，重复的键值按照RID排序
+      RID rid(static_cast<PageNum>(generator() % 100000), i);
+      int key = rid.page_num % 1000;
+      ASSERT_EQ(RC::SUCCESS, sorter.add(reinterpret_cast<const char *>(&key), rid));
+    }
+    ASSERT_EQ(RC::SUCCESS, sorter.sort());
+    ASSERT_EQ(entry_num, sorter.entry_count());
+    if (memory_limit == IndexBuildOptions::DEFAULT_SORT_MEMORY) {
+      ASSERT_EQ(0, sorter.run_count());
+    } else {
+      ASSERT_GT(sorter.run_count(), 1);
+    }
+
+    check_sorted(sorter, entry_num);
+  }
+
+  // 临时文件在析构时删除
+  ASSERT_TRUE(filesystem::is_empty(dir));
+}
+
+TEST(IndexEntrySorterTest, empty)
+{
+  IndexEntrySorter sorter(int_field_metas(), 4096, "index_entry_sorter_empty");
+  ASSERT_EQ(RC::SUCCESS, sorter.sort());
+
+  const char *key = nullptr;
+  RID         rid;
+  ASSERT_EQ(RC::RECORD_EOF, sorter.next(key, rid));
+}
+
+class CreateIndexTest : public testing::Test
+{
+public:
+  static constexpr int record_num = 20000;
+
+  void SetUp() override
+  {
+    const testing::TestInfo *test_info = testing::UnitTest::GetInstance()->current_test_info();
+    db_path_                           = filesystem::path("index_entry_sorter_test") / test_info->name();
+    filesystem::remove_all(db_path_);
+    filesystem::create_directories(db_path_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", db_path_.c_str(), "vacuous", "disk"));
+
+    vector<AttrInfoSqlNode> attr_infos(2);
+    attr_infos[0].name   = "id";
+    attr_infos[0].type   = AttrType::INTS;
+    attr_infos[0].length = 4;
+    attr_infos[1].name   = "payload";
+    attr_infos[1].type   = AttrType::CHARS;
+    attr_infos[1].length = 16;
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+
+    table_ = db_->find_table("t");
+    ASSERT_NE(table_, nullptr);
+
+    // 乱序插入，id 有重复
+    mt19937 generator(2024);
+    for (int i = 0; i < record_num; i++) {
+      const int id        = static_cast<int>(generator() % (record_num / 2));
+      Value     values[2] = {Value(id), Value("payload")};
+      Record    record;
+      ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+      ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+      id_count_[id]++;
+    }
+  }
+
+  void TearDown() override
+  {
+    table_ = nullptr;
+    db_.reset();
+  }
+
+  void check_index(Index *index)
+  {
+    const FieldMeta *id_field = table_->table_meta().field("id");
+    for (int id = 0; id < record_num / 2; id += 3) {
+      const char   *key           = reinterpret_cast<const char *>(&id);
+      IndexScanner *index_scanner = index->create_scanner(key, sizeof(id), true, key, sizeof(id), true);
+      ASSERT_NE(index_scanner, nullptr);
+
+      int    count = 0;
+      RID    rid;
+      Record record;
+      while (OB_SUCC(index_scanner->next_entry(&rid))) {
+        ASSERT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+        ASSERT_EQ(id, *reinterpret_cast<const int *>(record.data() + id_field->offset()));
+        count++;
+      }
+      index_scanner->destroy();
+      ASSERT_EQ(id_count_[id], count);
+    }
+  }
+
+protected:
+  filesystem::path db_path_;
+  unique_ptr<Db>   db_;
+  Table           *table_ = nullptr;
+  int              id_count_[record_num / 2] = {0};
+};
+
+TEST_F(CreateIndexTest, external_sort)
+{
+  IndexBuildOptions options;
+  options.fill_factor = 0.7;
+  options.sort_memory = 16 * 1024;
+
+  const FieldMeta *field_metas[] = {table_->table_meta().field("id")};
+  Trx             *trx           = db_->trx_kit().create_trx(db_->log_handler());
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, field_metas, "t_id", options));
+  db_->trx_kit().destroy_trx(trx);
+
+  Index *index = table_->find_index("t_id");
+  ASSERT_NE(index, nullptr);
+  check_index(index);
+
+  // 批量构建之后还能正常插入
+  for (int id = 0; id < record_num / 2; id += 3) {
+    Value  values[2] = {Value(id), Value("new")};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+    id_count_[id]++;
+  }
+  check_index(index);
+
+  // 排序的临时文件已经删除了
+  for (const auto &entry : filesystem::recursive_directory_iterator(db_path_)) {
+    ASSERT_EQ(entry.path().string().find(".sort"), string::npos) << entry.path();
+  }
+}
+
+TEST_F(CreateIndexTest, covering_scan)
+{
+  const FieldMeta *id_field         = table_->table_meta().field("id");
+  const FieldMeta *payload_field    = table_->table_meta().field("payload");
+  const FieldMeta *field_metas[]    = {id_field};
+  const FieldMeta *include_fields[] = {payload_field};
+
+  // 包含字段不能和键值字段重复
+  Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+  ASSERT_NE(RC::SUCCESS,
+      table_->create_index(trx, field_metas, field_metas, "t_bad", false /*unique*/, IndexBuildOptions()));
+  ASSERT_EQ(RC::SUCCESS,
+      table_->create_index(trx, field_metas, include_fields, "t_id", false /*unique*/, IndexBuildOptions()));
+
+  // 批量构建之后再逐条插入，两种方式写入的包含字段都能读出来
+  for (int id = 0; id < record_num / 2; id += 3) {
+    Value  values[2] = {Value(id), Value("new")};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+    id_count_[id]++;
+  }
+
+  // 重新打开之后索引的包含字段还在
+  db_->trx_kit().destroy_trx(trx);
+  db_.reset();
+  db_ = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db_->init("test_db", db_path_.c_str(), "vacuous", "disk"));
+  table_ = db_->find_table("t");
+  ASSERT_NE(table_, nullptr);
+  id_field      = table_->table_meta().field("id");
+  payload_field = table_->table_meta().field("payload");
+  Index *index = table_->find_index("t_id");
+  ASSERT_NE(index, nullptr);
+  ASSERT_EQ(1, static_cast<int>(index->include_field_metas().size()));
+  ASSERT_EQ(payload_field->len(), index->include_length());
+
+  const vector<int> projection = {id_field->field_id(), payload_field->field_id()};
+  ASSERT_TRUE(index->covers(projection));
+
+  trx = db_->trx_kit().create_trx(db_->log_handler());
+  for (int id = 0; id < record_num / 2; id += 7) {
+    IndexScanPhysicalOperator oper(
+        table_, index, ReadWriteMode::READ_ONLY, {Value(id)}, true /*left_inclusive*/, {Value(id)}, true);
+    oper.set_covering(projection);
+    ASSERT_EQ(RC::SUCCESS, oper.open(trx));
+
+    int count     = 0;
+    int new_count = 0;
+    RC  rc        = RC::SUCCESS;
+    while (OB_SUCC(rc = oper.next())) {
+      Tuple *tuple = oper.current_tuple();
+      ASSERT_EQ(2, tuple->cell_num());
+      Value id_value;
+      Value payload_value;
+      ASSERT_EQ(RC::SUCCESS, tuple->cell_at(0, id_value));
+      ASSERT_EQ(RC::SUCCESS, tuple->cell_at(1, payload_value));
+      ASSERT_EQ(id, id_value.get_int());
+      if (payload_value.get_string() == "new") {
+        new_count++;
+      } else {
+        ASSERT_EQ("payload", payload_value.get_string());
+      }
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(RC::SUCCESS, oper.close());
+    ASSERT_EQ(id_count_[id], count);
+    ASSERT_EQ(id % 3 == 0 ? 1 : 0, new_count);
+  }
+  db_->trx_kit().destroy_trx(trx);
+}
+
+TEST_F(CreateIndexTest, unique)
+{
+  const FieldMeta *field_metas[] = {table_->table_meta().field("id")};
+
+  // 已有的数据中 id 有重复，不能创建唯一索引
+  Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY,
+      table_->create_index(trx, field_metas, {}, "t_id", true /*unique*/, IndexBuildOptions()));
+  ASSERT_EQ(nullptr, table_->find_index("t_id"));
+
+  vector<AttrInfoSqlNode> attr_infos(1);
+  attr_infos[0].name   = "id";
+  attr_infos[0].type   = AttrType::INTS;
+  attr_infos[0].length = 4;
+  ASSERT_EQ(RC::SUCCESS, db_->create_table("u", attr_infos));
+  Table *table = db_->find_table("u");
+  ASSERT_NE(table, nullptr);
+
+  const int id_num = 1000;
+  for (int id = 0; id < id_num; id++) {
+    Value  value(id);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, &value, record));
+    ASSERT_EQ(RC::SUCCESS, table->insert_record(record));
+  }
+
+  // 先创建的普通索引插入成功，唯一索引插入失败时，普通索引中的数据也要删除
+  field_metas[0] = table->table_meta().field("id");
+  ASSERT_EQ(RC::SUCCESS, table->create_index(trx, field_metas, {}, "u_plain", false /*unique*/, IndexBuildOptions()));
+  // 创建索引会替换表的元数据，字段要重新获取
+  field_metas[0] = table->table_meta().field("id");
+  ASSERT_EQ(RC::SUCCESS, table->create_index(trx, field_metas, {}, "u_id", true /*unique*/, IndexBuildOptions()));
+  db_->trx_kit().destroy_trx(trx);
+  const FieldMeta *id_field = table->table_meta().field("id");
+
+  for (int id = 0; id < id_num; id += 7) {
+    Value  value(id);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, &value, record));
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, table->insert_record(record));
+  }
+  for (int id = id_num; id < id_num + 10; id++) {
+    Value  value(id);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, &value, record));
+    ASSERT_EQ(RC::SUCCESS, table->insert_record(record));
+  }
+
+  for (const char *index_name : {"u_plain", "u_id"}) {
+    Index *index = table->find_index(index_name);
+    ASSERT_NE(index, nullptr);
+    ASSERT_EQ(string(index_name) == "u_id", index->index_meta().unique());
+
+    IndexScanner *index_scanner = index->create_scanner(nullptr, 0, false, nullptr, 0, false);
+    ASSERT_NE(index_scanner, nullptr);
+    int    count = 0;
+    RID    rid;
+    Record record;
+    while (OB_SUCC(index_scanner->next_entry(&rid))) {
+      ASSERT_EQ(RC::SUCCESS, table->get_record(rid, record));
+      ASSERT_EQ(count, *reinterpret_cast<const int *>(record.data() + id_field->offset()));
+      count++;
+    }
+    index_scanner->destroy();
+    ASSERT_EQ(id_num + 10, count) << index_name;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,243 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "storage/index/linear_hash.h"
+#include "storage/index/linear_hash_log.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/integrated_log_replayer.h"
+#include "storage/clog/vacuous_log_handler.h"
+
+using namespace std;
+using namespace common;
+
+class LinearHashTest : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    ::remove(file_name_);
+    ASSERT_EQ(RC::SUCCESS, bpm_.init(make_unique<VacuousDoubleWriteBuffer>()));
+  }
+
+  void TearDown() override
+  {
+    handler_.close();
+    ::remove(file_name_);
+  }
+
+  void create(AttrType attr_type, int attr_length, bool unique_keys = false)
+  {
+    ASSERT_EQ(RC::SUCCESS,
+        handler_.create(log_handler_, bpm_, file_name_, span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1), unique_keys));
+  }
+
+  vector<RID> get_entries(int key)
+  {
+    vector<RID> rids;
+    EXPECT_EQ(RC::SUCCESS, handler_.get_entries(reinterpret_cast<const char *>(&key), rids));
+    sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return RID::compare(&a, &b) < 0; });
+    return rids;
+  }
+
+protected:
+  const char        *file_name_ = "linear_hash_test.hash";
+  BufferPoolManager  bpm_;
+  VacuousLogHandler  log_handler_;
+  LinearHashHandler  handler_;
+};
+
+TEST_F(LinearHashTest, insert_and_delete)
+{
+  create(AttrType::INTS, sizeof(int));
+
+  const int key_num    = 5000;
+  const int insert_num = 20000;
+  vector<int> keys(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    keys[i] = i;
+  }
+  shuffle(keys.begin(), keys.end(), mt19937(0));
+
+  for (int i : keys) {
+    const int key = i % key_num;
+    ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&key), RID(i + 1, i)));
+  }
+
+  // 数据量超过初始的几个桶之后会逐个分裂
+  EXPECT_GT(handler_.file_header().bucket_num, LinearHashFileHeader::INITIAL_BUCKET_NUM);
+
+  for (int key = 0; key < key_num; key++) {
+    vector<RID> rids = get_entries(key);
+    ASSERT_EQ(4, static_cast<int>(rids.size())) << "key=" << key;
+    for (int j = 0; j < 4; j++) {
+      const int i = key + j * key_num;
+      EXPECT_EQ(RID(i + 1, i), rids[j]);
+    }
+  }
+
+  const int missing_key = key_num;
+  EXPECT_TRUE(get_entries(missing_key).empty());
+
+  // 非唯一索引中相同的键值和RID也不能重复插入
+  const int dup_key = 1;
+  EXPECT_EQ(RC::RECORD_DUPLICATE_KEY, handler_.insert_entry(reinterpret_cast<const char *>(&dup_key), RID(2, 1)));
+
+  for (int i = 0; i < insert_num; i += 2) {
+    const int key = i % key_num;
+    ASSERT_EQ(RC::SUCCESS, handler_.delete_entry(reinterpret_cast<const char *>(&key), RID(i + 1, i)));
+  }
+  const int deleted_key = 0;
+  EXPECT_EQ(RC::RECORD_NOT_EXIST, handler_.delete_entry(reinterpret_cast<const char *>(&deleted_key), RID(1, 0)));
+
+  for (int key = 0; key < key_num; key++) {
+    vector<RID> rids = get_entries(key);
+    ASSERT_EQ(key % 2 == 0 ? 0 : 4, static_cast<int>(rids.size())) << "key=" << key;
+  }
+}
+
+TEST_F(LinearHashTest, unique_keys)
+{
+  create(AttrType::INTS, sizeof(int), true /*unique_keys*/);
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&i), RID(i + 1, 0)));
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler_.insert_entry(reinterpret_cast<const char *>(&i), RID(i + 1, 1)));
+  }
+
+  const int key = 10;
+  ASSERT_EQ(RC::SUCCESS, handler_.delete_entry(reinterpret_cast<const char *>(&key), RID(key + 1, 0)));
+  ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&key), RID(key + 1, 1)));
+  EXPECT_EQ(vector<RID>{RID(key + 1, 1)}, get_entries(key));
+}
+
+TEST_F(LinearHashTest, chars_keys)
+{
+  const int attr_length = 16;
+  create(AttrType::CHARS, attr_length);
+
+  // 字符串键值在 '\0' 之后的内容不参与比较，也不能影响哈希值
+  char key[attr_length];
+  for (int i = 0; i < 2000; i++) {
+    memset(key, 0, sizeof(key));
+    snprintf(key, sizeof(key), "key-%d", i);
+    ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(key, RID(i + 1, 0)));
+  }
+
+  for (int i = 0; i < 2000; i++) {
+    memset(key, 'x', sizeof(key));
+    snprintf(key, sizeof(key), "key-%d", i);
+    vector<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler_.get_entries(key, rids));
+    ASSERT_EQ(vector<RID>{RID(i + 1, 0)}, rids);
+  }
+}
+
+TEST_F(LinearHashTest, unsupported_types)
+{
+  const AttrType attr_type   = AttrType::FLOATS;
+  const int      attr_length = sizeof(float);
+  EXPECT_EQ(RC::INVALID_ARGUMENT,
+      handler_.create(log_handler_, bpm_, file_name_, span<const AttrType>(&attr_type, 1),
+          span<const int>(&attr_length, 1)));
+}
+
+TEST(LinearHashLog, redo)
+{
+  filesystem::path test_directory = "linear_hash_log_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const filesystem::path bp_filename   = test_directory / "linear_hash.bp";
+  const filesystem::path log_directory = test_directory / "clog";
+
+  const int insert_num = 20000;
+  const int delete_num = 5000;
+
+  // 1. 创建哈希表，插入并删除一些数据，只把日志写到磁盘
+  {
+    auto bpm = make_unique<BufferPoolManager>();
+    ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+    auto            log_handler = make_unique<DiskLogHandler>();
+    DiskBufferPool *buffer_pool = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm->create_file(bp_filename.c_str()));
+    ASSERT_EQ(RC::SUCCESS, bpm->open_file(*log_handler, bp_filename.c_str(), buffer_pool));
+    ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+
+    IntegratedLogReplayer log_replayer(*bpm);
+    ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+    ASSERT_EQ(RC::SUCCESS, log_handler->start());
+
+    const AttrType attr_type   = AttrType::INTS;
+    const int      attr_length = sizeof(int);
+    auto           handler     = make_unique<LinearHashHandler>();
+    ASSERT_EQ(RC::SUCCESS,
+        handler->create(*log_handler, *buffer_pool, span<const AttrType>(&attr_type, 1),
+            span<const int>(&attr_length, 1)));
+
+    for (int i = 0; i < insert_num; i++) {
+      ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&i), RID(i + 1, i)));
+    }
+    for (int i = 0; i < delete_num; i++) {
+      ASSERT_EQ(RC::SUCCESS, handler->delete_entry(reinterpret_cast<const char *>(&i), RID(i + 1, i)));
+    }
+
+    ASSERT_EQ(RC::SUCCESS, log_handler->stop());
+    ASSERT_EQ(RC::SUCCESS, log_handler->await_termination());
+
+    // 复制的文件中只有创建时刷下去的页面，其它修改都要靠日志恢复
+    const filesystem::path bp_filename2 = test_directory / "linear_hash2.bp";
+    ASSERT_TRUE(filesystem::copy_file(bp_filename, bp_filename2));
+
+    // 关闭时页面会刷到原来的文件中，不影响复制出来的文件
+    handler.reset();
+    bpm.reset();
+    log_handler.reset();
+  }
+
+  // 2. 用复制的文件重做日志，检查数据
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  auto            log_handler = make_unique<DiskLogHandler>();
+  DiskBufferPool *buffer_pool = nullptr;
+  const filesystem::path bp_filename2 = test_directory / "linear_hash2.bp";
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(*log_handler, bp_filename2.c_str(), buffer_pool));
+  ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+
+  IntegratedLogReplayer log_replayer(*bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+
+  auto handler = make_unique<LinearHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->open(*log_handler, *buffer_pool));
+  EXPECT_GT(handler->file_header().bucket_num, LinearHashFileHeader::INITIAL_BUCKET_NUM);
+
+  for (int i = 0; i < insert_num; i++) {
+    vector<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler->get_entries(reinterpret_cast<const char *>(&i), rids));
+    if (i < delete_num) {
+      ASSERT_TRUE(rids.empty()) << "key=" << i;
+    } else {
+      ASSERT_EQ(vector<RID>{RID(i + 1, i)}, rids) << "key=" << i;
+    }
+  }
+
+  handler.reset();
+  bpm.reset();
+  log_handler.reset();
+  filesystem::remove_all(test_directory);
+}
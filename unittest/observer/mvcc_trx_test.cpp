@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <sstream>
+#include <vector>
+
+#define protected public
+#define private public
+#include "storage/table/table.h"
+#undef protected
+#undef private
+
+#include "gtest/gtest.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/common/chunk.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+using namespace common;
+
+class MvccTrxChunkTest : public testing::Test
+{
+public:
+  void SetUp() override
+  {
+    ASSERT_EQ(RC::SUCCESS, trx_kit_.init());
+    table_.table_meta_.trx_fields_ = *trx_kit_.trx_fields();
+    table_.table_meta_.fields_.resize(3);
+    table_.table_meta_.fields_[0].init("__trx_xid_begin", AttrType::INTS, 0, 4, false, 0);
+    table_.table_meta_.fields_[1].init("__trx_xid_end", AttrType::INTS, 4, 4, false, 1);
+    table_.table_meta_.fields_[2].init("id", AttrType::INTS, 8, 4, true, 2);
+  }
+
+  // 同时用 visit_record 和 visit_chunk 判断可见性，结果应该一致
+  void check(MvccTrx &trx, const vector<pair<int32_t, int32_t>> &xids, ReadWriteMode mode)
+  {
+    Chunk chunk;
+    chunk.add_column(make_unique<Column>(*table_.table_meta().field(0)), 0);
+    chunk.add_column(make_unique<Column>(*table_.table_meta().field(1)), 1);
+
+    vector<uint8_t> expected;
+    for (auto [begin_xid, end_xid] : xids) {
+      ASSERT_EQ(RC::SUCCESS, chunk.column(0).append_one(reinterpret_cast<char *>(&begin_xid)));
+      ASSERT_EQ(RC::SUCCESS, chunk.column(1).append_one(reinterpret_cast<char *>(&end_xid)));
+
+      int32_t data[3] = {begin_xid, end_xid, 0};
+      Record  record;
+      record.set_data(reinterpret_cast<char *>(data), sizeof(data));
+      expected.push_back(trx.visit_record(&table_, record, mode) == RC::SUCCESS ? 1 : 0);
+    }
+
+    vector<uint8_t> select(xids.size(), 1);
+    ASSERT_EQ(RC::SUCCESS, trx.visit_chunk(&table_, chunk, select, mode));
+    ASSERT_EQ(expected, select);
+  }
+
+protected:
+  MvccTrxKit        trx_kit_;
+  VacuousLogHandler log_handler_;
+  Table             table_;
+};
+
+TEST_F(MvccTrxChunkTest, committed_records)
+{
+  MvccTrx trx(trx_kit_, log_handler_, 10);
+
+  vector<pair<int32_t, int32_t>> xids;
+  for (int i = 0; i < 37; i++) {
+    // 有的记录在当前事务之后才插入，有的已经被删除
+    xids.emplace_back(i % 3 == 0 ? 11 : 5, i % 5 == 0 ? 8 : numeric_limits<int32_t>::max());
+  }
+  check(trx, xids, ReadWriteMode::READ_ONLY);
+}
+
+TEST_F(MvccTrxChunkTest, uncommitted_records)
+{
+  MvccTrx trx(trx_kit_, log_handler_, 10);
+
+  vector<pair<int32_t, int32_t>> xids;
+  for (int i = 0; i < 37; i++) {
+    switch (i % 4) {
+      case 0: xids.emplace_back(-10, numeric_limits<int32_t>::max()); break;  // 当前事务插入
+      case 1: xids.emplace_back(-12, numeric_limits<int32_t>::max()); break;  // 其它事务插入
+      case 2: xids.emplace_back(5, -10); break;                                // 当前事务删除
+      default: xids.emplace_back(5, -12); break;                               // 其它事务删除
+    }
+  }
+  check(trx, xids, ReadWriteMode::READ_ONLY);
+}
+
+TEST_F(MvccTrxChunkTest, conflict)
+{
+  MvccTrx trx(trx_kit_, log_handler_, 10);
+
+  Chunk chunk;
+  chunk.add_column(make_unique<Column>(*table_.table_meta().field(0)), 0);
+  chunk.add_column(make_unique<Column>(*table_.table_meta().field(1)), 1);
+  int32_t begin_xid = 5;
+  int32_t end_xid   = -12;
+  ASSERT_EQ(RC::SUCCESS, chunk.column(0).append_one(reinterpret_cast<char *>(&begin_xid)));
+  ASSERT_EQ(RC::SUCCESS, chunk.column(1).append_one(reinterpret_cast<char *>(&end_xid)));
+
+  vector<uint8_t> select(1, 1);
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, trx.visit_chunk(&table_, chunk, select, ReadWriteMode::READ_WRITE));
+
+  // 缺少事务字段
+  Chunk id_chunk;
+  id_chunk.add_column(make_unique<Column>(*table_.table_meta().field(2)), 2);
+  ASSERT_EQ(RC::INVALID_ARGUMENT, trx.visit_chunk(&table_, id_chunk, select, ReadWriteMode::READ_ONLY));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -36,7 +36,7 @@ using namespace common;
 class PaxRecordFileScannerWithParam : public testing::TestWithParam<int>
 {};
 
-TEST_P(PaxRecordFileScannerWithParam, DISABLED_test_file_iterator)
+TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
 {
   int               record_insert_num = GetParam();
   VacuousLogHandler log_handler;
@@ -88,7 +88,7 @@ TEST_P(PaxRecordFileScannerWithParam, DISABLED_test_file_iterator)
   ASSERT_EQ(count, 0);
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, &trx, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   Chunk     chunk;
   FieldMeta fm;
@@ -127,7 +127,7 @@ TEST_P(PaxRecordFileScannerWithParam, DISABLED_test_file_iterator)
   ASSERT_EQ(count, rids.size());
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, &trx, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   chunk.reset_data();
   count = 0;
@@ -158,7 +158,7 @@ TEST_P(PaxRecordFileScannerWithParam, DISABLED_test_file_iterator)
   ASSERT_EQ(count, rids.size() / 2);
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, &trx, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   chunk.reset_data();
   count = 0;
@@ -176,7 +176,7 @@ TEST_P(PaxRecordFileScannerWithParam, DISABLED_test_file_iterator)
 class PaxPageHandlerTestWithParam : public testing::TestWithParam<int>
 {};
 
-TEST_P(PaxPageHandlerTestWithParam, DISABLED_PaxPageHandler)
+TEST_P(PaxPageHandlerTestWithParam, PaxPageHandler)
 {
   int               record_num = GetParam();
   VacuousLogHandler log_handler;
@@ -340,6 +340,97 @@ TEST_P(PaxPageHandlerTestWithParam, DISABLED_PaxPageHandler)
   delete bpm;
 }
 
+TEST(PaxPageHandlerTest, update)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  RC              rc = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  rc = bpm->open_file(log_handler, record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  Frame *frame = nullptr;
+  rc           = bp->allocate_page(&frame);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  const int          record_size        = 12;  // 4 + 4 + 4
+  RecordPageHandler *record_page_handle = new PaxRecordPageHandler();
+  TableMeta          table_meta;
+  table_meta.fields_.resize(3);
+  for (int i = 0; i < 3; i++) {
+    table_meta.fields_[i].attr_type_ = AttrType::INTS;
+    table_meta.fields_[i].attr_len_  = 4;
+    table_meta.fields_[i].field_id_  = i;
+  }
+
+  rc = record_page_handle->init_empty_page(*bp, log_handler, frame->page_num(), record_size, &table_meta);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  const int   record_num = 100;
+  vector<RID> rids;
+  for (int i = 0; i < record_num; i++) {
+    int buf[3] = {i, i * 10, i * 100};
+    RID rid;
+    rc = record_page_handle->insert_record(reinterpret_cast<const char *>(buf), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    rids.push_back(rid);
+  }
+
+  // update whole records
+  for (int i = 0; i < record_num; i += 2) {
+    int buf[3] = {-i, -i * 10, -i * 100};
+    rc = record_page_handle->update_record(rids[i], reinterpret_cast<const char *>(buf));
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+
+  // update the second column in batch
+  vector<int>                         new_values(record_num);
+  vector<pair<SlotNum, const char *>> updates;
+  for (int i = 1; i < record_num; i += 2) {
+    new_values[i] = i + 7;
+    updates.emplace_back(rids[i].slot_num, reinterpret_cast<const char *>(&new_values[i]));
+  }
+  rc = record_page_handle->update_column(1, updates);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  Record record;
+  for (int i = 0; i < record_num; i++) {
+    rc = record_page_handle->get_record(rids[i], record);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    const int *values = reinterpret_cast<const int *>(record.data());
+    if (i % 2 == 0) {
+      ASSERT_EQ(values[0], -i);
+      ASSERT_EQ(values[1], -i * 10);
+      ASSERT_EQ(values[2], -i * 100);
+    } else {
+      ASSERT_EQ(values[0], i);
+      ASSERT_EQ(values[1], i + 7);
+      ASSERT_EQ(values[2], i * 100);
+    }
+  }
+
+  // invalid slot or column makes the whole batch fail
+  RID del_rid = rids[1];
+  rc          = record_page_handle->delete_record(&del_rid);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  ASSERT_EQ(record_page_handle->update_column(1, updates), RC::RECORD_NOT_EXIST);
+  ASSERT_EQ(record_page_handle->update_column(3, updates), RC::INVALID_ARGUMENT);
+  ASSERT_EQ(record_page_handle->update_record(del_rid, record.data()), RC::RECORD_NOT_EXIST);
+
+  rc = record_page_handle->cleanup();
+  ASSERT_EQ(rc, RC::SUCCESS);
+  delete record_page_handle;
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
 INSTANTIATE_TEST_SUITE_P(PaxFileScannerTests, PaxRecordFileScannerWithParam, testing::Values(1, 10, 100, 1000, 2000, 10000));
 
 INSTANTIATE_TEST_SUITE_P(PaxPageTests, PaxPageHandlerTestWithParam, testing::Values(1, 10, 100, 337));
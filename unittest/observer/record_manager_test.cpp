@@ -355,6 +355,149 @@ TEST(RecordManager, durability)
   bpm2.close_file(record_manager_file.c_str());
 }
 
+TEST(RecordManager, compaction)
+{
+  /*
+   * 测试场景：
+   * 1. 插入若干页面的记录，然后删除大部分记录
+   * 2. 把剩下的记录都移动到同一个页面上，释放空页面
+   * 3. 从日志恢复，检查记录都在新的位置上
+   */
+  filesystem::path directory("record_manager_compaction");
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directories(directory));
+
+  filesystem::path record_manager_file = directory / "record_manager.bp";
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(bpm.init(make_unique<VacuousDoubleWriteBuffer>()), RC::SUCCESS);
+
+  DiskLogHandler        log_handler;
+  IntegratedLogReplayer log_replayer(bpm);
+  ASSERT_EQ(log_handler.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler.replay(log_replayer, 0), RC::SUCCESS);
+  ASSERT_EQ(log_handler.start(), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(bpm.create_file(record_manager_file.c_str()), RC::SUCCESS);
+  ASSERT_EQ(bpm.open_file(log_handler, record_manager_file.c_str(), buffer_pool), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler.init(*buffer_pool, log_handler, nullptr), RC::SUCCESS);
+
+  const int record_size       = 100;
+  const int insert_record_num = 1000;
+
+  vector<pair<RID, string>> records;
+  for (int i = 0; i < insert_record_num; i++) {
+    string record_data = "record " + to_string(i);
+    record_data.resize(record_size);
+
+    RID rid;
+    ASSERT_EQ(record_file_handler.insert_record(record_data.data(), record_size, &rid), RC::SUCCESS);
+    records.emplace_back(rid, record_data);
+  }
+
+  unordered_map<RID, string, RIDHash> record_map;
+  for (int i = 0; i < insert_record_num; i++) {
+    if (i % 20 == 0) {
+      record_map.emplace(records[i]);
+    } else {
+      ASSERT_EQ(record_file_handler.delete_record(&records[i].first), RC::SUCCESS);
+    }
+  }
+
+  vector<RecordPageStat> pages;
+  bool                   reach_end = false;
+  ASSERT_EQ(record_file_handler.sparse_pages(0.5, insert_record_num, pages, reach_end), RC::SUCCESS);
+  ASSERT_TRUE(reach_end);
+  ASSERT_GT(pages.size(), 1);
+  for (size_t i = 1; i < pages.size(); i++) {
+    ASSERT_LE(pages[i - 1].record_num, pages[i].record_num);
+  }
+
+  const PageNum dest_page_num = pages.back().page_num;
+  pages.pop_back();
+  for (const RecordPageStat &page : pages) {
+    vector<RID> rids;
+    ASSERT_EQ(record_file_handler.page_rids(page.page_num, rids), RC::SUCCESS);
+    ASSERT_EQ(static_cast<int>(rids.size()), page.record_num);
+
+    for (const RID &rid : rids) {
+      RID new_rid;
+      ASSERT_EQ(record_file_handler.move_record(rid, dest_page_num, new_rid), RC::SUCCESS);
+      ASSERT_EQ(new_rid.page_num, dest_page_num);
+
+      auto iter = record_map.find(rid);
+      ASSERT_NE(iter, record_map.end());
+      string record_data = iter->second;
+      record_map.erase(iter);
+      record_map.emplace(new_rid, record_data);
+    }
+
+    ASSERT_EQ(record_file_handler.dispose_empty_page(page.page_num), RC::SUCCESS);
+  }
+
+  // 不能释放还有记录的页面
+  ASSERT_EQ(record_file_handler.dispose_empty_page(dest_page_num), RC::INVALID_ARGUMENT);
+
+  for (const auto &[rid, record] : record_map) {
+    Record record_data;
+    ASSERT_EQ(record_file_handler.get_record(rid, record_data), RC::SUCCESS);
+    ASSERT_EQ(memcmp(record_data.data(), record.c_str(), record.size()), 0);
+  }
+
+  // 把文件复制出来，用日志恢复
+  filesystem::path record_manager_file_copy = directory / "record_manager_copy.bp";
+  filesystem::copy_file(record_manager_file, record_manager_file_copy);
+  bpm.close_file(record_manager_file.c_str());
+  filesystem::remove(record_manager_file);
+  ASSERT_EQ(log_handler.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler.await_termination(), RC::SUCCESS);
+
+  DiskLogHandler    log_handler2;
+  BufferPoolManager bpm2;
+  ASSERT_EQ(RC::SUCCESS, bpm2.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool2 = nullptr;
+  filesystem::copy(record_manager_file_copy, record_manager_file);
+  ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
+
+  IntegratedLogReplayer log_replayer2(bpm2);
+  ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler2(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler2.init(*buffer_pool2, log_handler2, nullptr), RC::SUCCESS);
+  for (const auto &[rid, record] : record_map) {
+    Record record_data;
+    ASSERT_EQ(record_file_handler2.get_record(rid, record_data), RC::SUCCESS);
+    ASSERT_EQ(memcmp(record_data.data(), record.c_str(), record.size()), 0);
+  }
+
+  // 旧的位置上不应该再有记录，释放的页面也不会再被遍历
+  VacuousTrx        trx;
+  RecordFileScanner file_scanner;
+  ASSERT_EQ(file_scanner.open_scan(
+                nullptr /*table*/, *buffer_pool2, &trx, log_handler2, ReadWriteMode::READ_ONLY, nullptr /*condition_filter*/),
+      RC::SUCCESS);
+
+  int    count = 0;
+  Record record;
+  RC     rc = RC::SUCCESS;
+  while (OB_SUCC(rc = file_scanner.next(record))) {
+    ASSERT_EQ(record.rid().page_num, dest_page_num);
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  file_scanner.close_scan();
+  ASSERT_EQ(count, static_cast<int>(record_map.size()));
+
+  ASSERT_EQ(log_handler2.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.await_termination(), RC::SUCCESS);
+  bpm2.close_file(record_manager_file.c_str());
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
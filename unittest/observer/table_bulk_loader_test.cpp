@@ -0,0 +1,178 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/value.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/table/table_bulk_loader.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+class TableBulkLoaderTest : public testing::Test
+{
+public:
+  static constexpr int record_num = 5000;
+
+  void SetUp() override
+  {
+    const testing::TestInfo *test_info = testing::UnitTest::GetInstance()->current_test_info();
+    db_path_                           = filesystem::path("table_bulk_loader_test") / test_info->name();
+    filesystem::remove_all(db_path_);
+    filesystem::create_directories(db_path_);
+
+    open_db();
+
+    vector<AttrInfoSqlNode> attr_infos(2);
+    attr_infos[0].name   = "id";
+    attr_infos[0].type   = AttrType::INTS;
+    attr_infos[0].length = 4;
+    attr_infos[1].name   = "payload";
+    attr_infos[1].type   = AttrType::CHARS;
+    attr_infos[1].length = 100;
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+
+    table_ = db_->find_table("t");
+    ASSERT_NE(table_, nullptr);
+
+    Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, table_->table_meta().field("id"), "t_id"));
+    db_->trx_kit().destroy_trx(trx);
+  }
+
+  void TearDown() override
+  {
+    table_ = nullptr;
+    db_.reset();
+  }
+
+  void open_db()
+  {
+    table_ = nullptr;
+    db_.reset();
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", db_path_.c_str(), "vacuous", "disk"));
+    table_ = db_->find_table("t");
+  }
+
+  void make_record(int id, Record &record)
+  {
+    Value values[2] = {Value(id), Value(("payload " + to_string(id)).c_str())};
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+  }
+
+  // 表中的记录和索引都要正确
+  void check_records(int expected_num)
+  {
+    const FieldMeta *id_field = table_->table_meta().field("id");
+
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    vector<bool> found(expected_num, false);
+    RC           rc = RC::SUCCESS;
+    Record       record;
+    while (OB_SUCC(rc = scanner.next(record))) {
+      int id = *reinterpret_cast<const int *>(record.data() + id_field->offset());
+      ASSERT_GE(id, 0);
+      ASSERT_LT(id, expected_num);
+      ASSERT_FALSE(found[id]);
+      found[id] = true;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    scanner.close_scan();
+    ASSERT_EQ(count(found.begin(), found.end(), true), expected_num);
+
+    Index *index = table_->find_index("t_id");
+    ASSERT_NE(index, nullptr);
+    for (int id = 0; id < expected_num; id += 7) {
+      const char   *key           = reinterpret_cast<const char *>(&id);
+      IndexScanner *index_scanner = index->create_scanner(key, sizeof(id), true, key, sizeof(id), true);
+      ASSERT_NE(index_scanner, nullptr);
+
+      RID rid;
+      ASSERT_EQ(RC::SUCCESS, index_scanner->next_entry(&rid));
+      ASSERT_EQ(RC::RECORD_EOF, index_scanner->next_entry(&rid));
+      index_scanner->destroy();
+
+      ASSERT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+      ASSERT_EQ(id, *reinterpret_cast<const int *>(record.data() + id_field->offset()));
+    }
+  }
+
+protected:
+  filesystem::path db_path_;
+  unique_ptr<Db>   db_;
+  Table           *table_ = nullptr;
+};
+
+TEST_F(TableBulkLoaderTest, load)
+{
+  TableBulkLoader loader(*table_);
+  ASSERT_EQ(RC::SUCCESS, loader.open());
+  // 键值倒序导入，索引需要在结束时排序
+  for (int i = record_num - 1; i >= 0; i--) {
+    Record record;
+    make_record(i, record);
+    ASSERT_EQ(RC::SUCCESS, loader.insert_record(record));
+  }
+  ASSERT_EQ(RC::SUCCESS, loader.finish());
+  ASSERT_EQ(record_num, loader.record_count());
+
+  // 除了最后一个页面，其它页面都是满的
+  vector<RecordPageStat> pages;
+  bool                   reach_end = false;
+  ASSERT_EQ(RC::SUCCESS, table_->record_handler()->sparse_pages(1.0, record_num, pages, reach_end));
+  ASSERT_LE(pages.size(), 1);
+
+  check_records(record_num);
+
+  // 空表才能批量导入
+  TableBulkLoader another_loader(*table_);
+  ASSERT_EQ(RC::UNSUPPORTED, another_loader.open());
+
+  // 逐行插入可以继续使用最后一个页面
+  Record record;
+  make_record(record_num, record);
+  ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+  check_records(record_num + 1);
+}
+
+TEST_F(TableBulkLoaderTest, reopen)
+{
+  {
+    TableBulkLoader loader(*table_);
+    ASSERT_EQ(RC::SUCCESS, loader.open());
+    for (int i = 0; i < record_num; i++) {
+      Record record;
+      make_record(i, record);
+      ASSERT_EQ(RC::SUCCESS, loader.insert_record(record));
+    }
+    ASSERT_EQ(RC::SUCCESS, loader.finish());
+  }
+
+  open_db();
+  ASSERT_NE(table_, nullptr);
+  check_records(record_num);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
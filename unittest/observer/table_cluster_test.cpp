@@ -0,0 +1,215 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/value.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/table/table_bulk_loader.h"
+#include "storage/table/table_compactor.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+class TableClusterTest : public testing::Test
+{
+public:
+  static constexpr int record_num = 2000;
+
+  void SetUp() override
+  {
+    const testing::TestInfo *test_info = testing::UnitTest::GetInstance()->current_test_info();
+    db_path_                           = filesystem::path("table_cluster_test") / test_info->name();
+    filesystem::remove_all(db_path_);
+    filesystem::create_directories(db_path_);
+
+    open_db();
+
+    vector<AttrInfoSqlNode> attr_infos(2);
+    attr_infos[0].name   = "id";
+    attr_infos[0].type   = AttrType::INTS;
+    attr_infos[0].length = 4;
+    attr_infos[1].name   = "payload";
+    attr_infos[1].type   = AttrType::CHARS;
+    attr_infos[1].length = 200;
+
+    const string cluster_fields[] = {"id"};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("clustered", attr_infos, StorageFormat::ROW_FORMAT, cluster_fields));
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("heap", attr_infos));
+    find_tables();
+  }
+
+  void TearDown() override
+  {
+    clustered_ = nullptr;
+    heap_      = nullptr;
+    db_.reset();
+  }
+
+  void open_db()
+  {
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", db_path_.c_str(), "vacuous", "disk"));
+  }
+
+  void find_tables()
+  {
+    clustered_ = db_->find_table("clustered");
+    heap_      = db_->find_table("heap");
+    ASSERT_NE(clustered_, nullptr);
+    ASSERT_NE(heap_, nullptr);
+    clustered_->compactor()->stop();
+    heap_->compactor()->stop();
+  }
+
+  void insert(Table *table, int id)
+  {
+    Value  values[2] = {Value(id), Value(("payload " + to_string(id)).c_str())};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, table->insert_record(record));
+    rids_[table][id] = record.rid();
+  }
+
+  void remove(Table *table, int id)
+  {
+    ASSERT_EQ(RC::SUCCESS, table->delete_record(rids_[table][id]));
+    rids_[table].erase(id);
+  }
+
+  /// id 在 [begin, end) 之间的记录分布在多少个页面上
+  int page_num_of_range(Table *table, int begin, int end)
+  {
+    set<PageNum> pages;
+    for (int id = begin; id < end; id++) {
+      auto iter = rids_[table].find(id);
+      if (iter != rids_[table].end()) {
+        pages.insert(iter->second.page_num);
+      }
+    }
+    return static_cast<int>(pages.size());
+  }
+
+  /// 插入一批按时间递增的数据，再删除较早的数据中的一半，模拟按时间清理的表
+  void insert_and_expire(Table *table)
+  {
+    for (int id = 0; id < record_num; id++) {
+      insert(table, id);
+    }
+    for (int id = 1; id < record_num / 2; id += 2) {
+      remove(table, id);
+    }
+    for (int id = record_num; id < record_num * 2; id++) {
+      insert(table, id);
+    }
+  }
+
+protected:
+  filesystem::path            db_path_;
+  unique_ptr<Db>              db_;
+  Table                      *clustered_ = nullptr;
+  Table                      *heap_      = nullptr;
+  map<Table *, map<int, RID>> rids_;  ///< 每张表中记录的RID
+};
+
+TEST_F(TableClusterTest, cluster_index)
+{
+  ASSERT_NE(clustered_->cluster_index(), nullptr);
+  ASSERT_EQ(heap_->cluster_index(), nullptr);
+  ASSERT_NE(clustered_->table_meta().cluster_index(), nullptr);
+  ASSERT_EQ(1, clustered_->table_meta().cluster_index()->field_num());
+  ASSERT_STREQ("id", clustered_->table_meta().cluster_index()->field());
+
+  // 元数据持久化之后，重新打开数据库还是聚簇表
+  clustered_ = nullptr;
+  heap_      = nullptr;
+  db_.reset();
+  open_db();
+  find_tables();
+  ASSERT_NE(clustered_->cluster_index(), nullptr);
+  ASSERT_EQ(heap_->cluster_index(), nullptr);
+
+  // 聚簇表不能批量导入，需要逐行插入
+  TableBulkLoader bulk_loader(*clustered_);
+  ASSERT_EQ(RC::UNSUPPORTED, bulk_loader.open());
+}
+
+TEST_F(TableClusterTest, insert_near_neighbors)
+{
+  insert_and_expire(clustered_);
+  insert_and_expire(heap_);
+
+  // 普通的表会用删除记录空出来的位置存放新的记录，新数据分散在旧的页面中；
+  // 聚簇表把新的记录放在相邻记录的页面上，按照 id 范围查询新数据时访问的页面少很多
+  const int clustered_pages = page_num_of_range(clustered_, record_num, record_num * 2);
+  const int heap_pages      = page_num_of_range(heap_, record_num, record_num * 2);
+  const int min_pages       = page_num_of_range(clustered_, record_num / 2, record_num);  // 一半数据占用的页面
+  EXPECT_LE(clustered_pages, min_pages * 2 + 2);
+  EXPECT_GT(heap_pages, clustered_pages);
+
+  // 乱序到达的数据放在前后相邻的记录所在的页面
+  const int late_id = record_num + 10;
+  remove(clustered_, late_id);
+  insert(clustered_, late_id);
+  const PageNum late_page = rids_[clustered_][late_id].page_num;
+  EXPECT_TRUE(late_page == rids_[clustered_][late_id - 1].page_num ||
+              late_page == rids_[clustered_][late_id + 1].page_num);
+
+  // 聚簇索引中的数据要和表中的记录一致
+  Index *index = clustered_->cluster_index();
+  for (const auto &[id, rid] : rids_[clustered_]) {
+    const char   *key     = reinterpret_cast<const char *>(&id);
+    IndexScanner *scanner = index->create_scanner(key, sizeof(id), true, key, sizeof(id), true);
+    ASSERT_NE(scanner, nullptr);
+    RID index_rid;
+    ASSERT_EQ(RC::SUCCESS, scanner->next_entry(&index_rid));
+    ASSERT_EQ(rid, index_rid);
+    scanner->destroy();
+  }
+}
+
+TEST_F(TableClusterTest, compact)
+{
+  insert_and_expire(clustered_);
+  for (int id = 0; id < record_num / 2; id++) {
+    if (rids_[clustered_].count(id) != 0) {
+      remove(clustered_, id);
+    }
+  }
+
+  // 聚簇表整理时不移动记录，只释放空页面
+  CompactionStat stat;
+  ASSERT_EQ(RC::SUCCESS, clustered_->compact(0.5, 10000, stat));
+  EXPECT_TRUE(stat.finished);
+  EXPECT_EQ(0, stat.moved_records);
+  EXPECT_GT(stat.freed_pages, 0);
+
+  for (const auto &[id, rid] : rids_[clustered_]) {
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, clustered_->get_record(rid, record));
+    ASSERT_EQ(id, *reinterpret_cast<const int *>(record.data() + clustered_->table_meta().field("id")->offset()));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
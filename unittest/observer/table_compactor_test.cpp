@@ -0,0 +1,213 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/value.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/table/table_compactor.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+class TableCompactorTest : public testing::Test
+{
+public:
+  static constexpr int record_num = 2000;
+  static constexpr int keep_every = 10;
+
+  void SetUp() override
+  {
+    const testing::TestInfo *test_info = testing::UnitTest::GetInstance()->current_test_info();
+    db_path_                           = filesystem::path("table_compactor_test") / test_info->name();
+    filesystem::remove_all(db_path_);
+    filesystem::create_directories(db_path_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", db_path_.c_str(), "vacuous", "disk"));
+
+    vector<AttrInfoSqlNode> attr_infos(2);
+    attr_infos[0].name   = "id";
+    attr_infos[0].type   = AttrType::INTS;
+    attr_infos[0].length = 4;
+    attr_infos[1].name   = "payload";
+    attr_infos[1].type   = AttrType::CHARS;
+    attr_infos[1].length = 200;
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+
+    table_ = db_->find_table("t");
+    ASSERT_NE(table_, nullptr);
+
+    Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, table_->table_meta().field("id"), "t_id"));
+    db_->trx_kit().destroy_trx(trx);
+  }
+
+  void TearDown() override
+  {
+    table_ = nullptr;
+    db_.reset();
+  }
+
+  // 插入记录后只保留 id 是 keep_every 倍数的记录
+  void insert_and_delete()
+  {
+    vector<RID> rids;
+    for (int i = 0; i < record_num; i++) {
+      Value  values[2] = {Value(i), Value(("payload " + to_string(i)).c_str())};
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+      ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+      rids.push_back(record.rid());
+    }
+
+    for (int i = 0; i < record_num; i++) {
+      if (i % keep_every != 0) {
+        ASSERT_EQ(RC::SUCCESS, table_->delete_record(rids[i]));
+      }
+    }
+  }
+
+  int sparse_page_num()
+  {
+    vector<RecordPageStat> pages;
+    bool                   reach_end = false;
+    EXPECT_EQ(RC::SUCCESS, table_->record_handler()->sparse_pages(0.5, record_num, pages, reach_end));
+    EXPECT_TRUE(reach_end);
+    return static_cast<int>(pages.size());
+  }
+
+  // 表中的记录和索引都要正确
+  void check_records()
+  {
+    const FieldMeta *id_field = table_->table_meta().field("id");
+
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    int    count = 0;
+    RC     rc    = RC::SUCCESS;
+    Record record;
+    while (OB_SUCC(rc = scanner.next(record))) {
+      int id = *reinterpret_cast<const int *>(record.data() + id_field->offset());
+      ASSERT_EQ(0, id % keep_every);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    scanner.close_scan();
+    ASSERT_EQ(record_num / keep_every, count);
+
+    Index *index = table_->find_index("t_id");
+    ASSERT_NE(index, nullptr);
+    for (int id = 0; id < record_num; id += keep_every) {
+      const char   *key          = reinterpret_cast<const char *>(&id);
+      IndexScanner *index_scanner = index->create_scanner(key, sizeof(id), true, key, sizeof(id), true);
+      ASSERT_NE(index_scanner, nullptr);
+
+      RID rid;
+      ASSERT_EQ(RC::SUCCESS, index_scanner->next_entry(&rid));
+      ASSERT_EQ(RC::RECORD_EOF, index_scanner->next_entry(&rid));
+      index_scanner->destroy();
+
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+      ASSERT_EQ(id, *reinterpret_cast<const int *>(record.data() + id_field->offset()));
+    }
+  }
+
+protected:
+  filesystem::path db_path_;
+  unique_ptr<Db>   db_;
+  Table           *table_ = nullptr;
+};
+
+TEST_F(TableCompactorTest, compact)
+{
+  table_->compactor()->stop();
+  insert_and_delete();
+  ASSERT_GT(sparse_page_num(), 1);
+
+  CompactionStat stat;
+  ASSERT_EQ(RC::SUCCESS, table_->compact(0.5, 10000, stat));
+  ASSERT_TRUE(stat.finished);
+  ASSERT_GT(stat.moved_records, 0);
+  ASSERT_GT(stat.freed_pages, 0);
+  ASSERT_LE(sparse_page_num(), 1);
+
+  check_records();
+}
+
+TEST_F(TableCompactorTest, io_budget)
+{
+  table_->compactor()->stop();
+  insert_and_delete();
+
+  const int io_budget = 8;
+  int       rounds    = 0;
+  int       freed     = 0;
+  for (bool finished = false; !finished; rounds++) {
+    CompactionStat stat;
+    ASSERT_EQ(RC::SUCCESS, table_->compact(0.5, io_budget, stat));
+    ASSERT_LE(stat.io_pages, io_budget);
+    freed += stat.freed_pages;
+    finished = stat.finished;
+    ASSERT_LT(rounds, 1000);
+  }
+
+  ASSERT_GT(rounds, 1);
+  ASSERT_GT(freed, 0);
+  check_records();
+}
+
+TEST_F(TableCompactorTest, background)
+{
+  TableCompactor::Options options = table_->compactor()->options();
+  options.delete_threshold        = 100;
+  options.io_budget               = 16;
+  options.interval_ms             = 1;
+  table_->compactor()->set_options(options);
+
+  {
+    // 与执行语句时一样持有共享锁，后台整理要等删除完成后才能开始
+    shared_lock<shared_mutex> guard(db_->background_latch());
+    insert_and_delete();
+  }
+
+  // 机器负载高时后台线程可能很久才能运行，多等一会儿
+  int sparse_pages = 0;
+  for (int i = 0; i < 3000; i++) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+    shared_lock<shared_mutex> guard(db_->background_latch());
+    sparse_pages = sparse_page_num();
+    if (sparse_pages <= 1) {
+      break;
+    }
+  }
+  ASSERT_LE(sparse_pages, 1);
+
+  shared_lock<shared_mutex> guard(db_->background_latch());
+  check_records();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}